@@ -0,0 +1,788 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include "batch.h"
+#include "scheduler.h"
+#include "searchandstat.h"
+#include "fileio.h"
+#include "checkpoint.h"
+#include "epoch.h"
+
+
+static double batchSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+// Whether text is empty or only whitespace (not a usable name)
+static int blankText(const char* text) {
+    for (; *text; text++) {
+        if (!isspace((unsigned char)*text)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+// Binds shard k of the run's list for the command
+static void bindStore(batchrun* b, int k) {
+    taskstore* store = b->stores[k];
+    taskStoreUse(store);
+    b->list = &store->list;
+    b->done = &store->done;
+}
+
+
+// Binds the shard that holds the task called name
+static void bindShard(batchrun* b, const char* name) {
+    bindStore(b, taskStoreShardOf(name, strlen(name), b->store_count));
+}
+
+
+// A priority field: exactly "1", "2" or "3"; 0 otherwise
+static int parsePriority(const char* text) {
+    return text[0] >= '1' && text[0] <= '3' && text[1] == '\0' ? text[0] - '0' : 0;
+}
+
+
+// A "DD MM YYYY" field that isValidDate() accepts; 0 otherwise
+static int parseDate(const char* text, date* out) {
+    int day, month, year, used = 0;
+    if (sscanf(text, "%d %d %d%n", &day, &month, &year, &used) != 3 || text[used] != '\0' ||
+        !isValidDate(day, month, year)) {
+        return 0;
+    }
+    out->day = day;
+    out->month = month;
+    out->year = year;
+    return 1;
+}
+
+
+static const char* batchAdd(batchrun* b, char** fields, int count) {
+    const char* name = fields[1];
+    int priority = 2;
+    date due;
+    if (blankText(name)) {
+        return "empty name";
+    }
+    if (findTask(b->list, name)) {
+        return "name taken";
+    }
+    if (count > 3 && fields[3][0] && !(priority = parsePriority(fields[3]))) {
+        return "bad priority";
+    }
+    int has_due = count > 4 && fields[4][0];
+    if (has_due && !parseDate(fields[4], &due)) {
+        return "bad date";
+    }
+    if (!createTask(b->list, name, count > 2 ? fields[2] : "", priority, has_due ? &due : NULL)) {
+        return "out of memory";
+    }
+    fputs("ok\n", b->out);
+    return NULL;
+}
+
+
+/*
+moveTask() - Renames t to a name another shard holds: the task moves to shard to
+ - The task is added there with every field of t, then t is deleted; each
+   shard journals its half, so a crash in between leaves the task twice
+   rather than losing it
+ - Time: O(text length + tags), Space: O(text length + tags)
+ - Returns NULL on success, otherwise why it failed (t is then unchanged)
+ */
+static const char* moveTask(batchrun* b, task* t, int to, const char* name) {
+    int from = currentStore->shard;
+    int priority = t->priority;
+    int has_due = t->due_date_set;
+    date due = taskDueDate(t);
+    int tag_count = taskTagCount(t);
+    char* description = strdup(taskDescription(t));
+    char** tags = (char**)calloc(tag_count ? tag_count : 1, sizeof(char*));
+    const char* error = description && tags ? NULL : "out of memory";
+    for (int i = 0; i < tag_count && !error; i++) {
+        if (!(tags[i] = strdup(taskTagName(t, i)))) {
+            error = "out of memory";
+        }
+    }
+
+    bindStore(b, to);
+    task* moved = NULL;
+    if (!error && findTask(b->list, name)) {
+        error = "name taken";
+    }
+    if (!error && !(moved = createTask(b->list, name, description, priority, has_due ? &due : NULL))) {
+        error = "out of memory";
+    }
+    for (int i = 0; i < tag_count && !error; i++) {
+        unsigned int id = tagIntern(tags[i]);
+        if (id == TAG_NO_ID || (!taskHasTag(moved, id) && !listAddTag(b->list, moved, id))) {
+            error = "out of memory";
+        }
+    }
+    if (error && moved) {
+        removeTask(b->list, moved);
+    }
+    bindStore(b, from);
+    if (!error) {
+        removeTask(b->list, t);
+    }
+
+    for (int i = 0; tags && i < tag_count; i++) {
+        free(tags[i]);
+    }
+    free(tags);
+    free(description);
+    return error;
+}
+
+
+static const char* batchEdit(batchrun* b, char** fields, int count) {
+    (void)count;
+    task* t = findTask(b->list, fields[1]);
+    const char* field = fields[2];
+    const char* value = fields[3];
+    if (!t) {
+        return "no such task";
+    }
+    if (strcmp(field, "name") == 0) {
+        if (blankText(value)) {
+            return "empty name";
+        }
+        int to = taskStoreShardOf(value, strlen(value), b->store_count);
+        if (to != currentStore->shard) {
+            const char* error = moveTask(b, t, to, value);
+            if (error) {
+                return error;
+            }
+            fputs("ok\n", b->out);
+            return NULL;
+        }
+        task* other = findTask(b->list, value);
+        if (other && other != t) {
+            return "name taken";
+        }
+        if (!other && !renameTask(b->list, t, value)) {
+            return "out of memory";
+        }
+    } else if (strcmp(field, "description") == 0) {
+        if (!describeTask(t, value)) {
+            return "out of memory";
+        }
+    } else if (strcmp(field, "priority") == 0) {
+        int priority = parsePriority(value);
+        if (!priority) {
+            return "bad priority";
+        }
+        if (!setTaskPriority(b->list, t, priority)) {
+            return "out of memory";
+        }
+    } else if (strcmp(field, "due") == 0) {
+        date due;
+        if (value[0] && !parseDate(value, &due)) {
+            return "bad date";
+        }
+        if (!setTaskDue(b->list, t, value[0] ? &due : NULL)) {
+            return "out of memory";
+        }
+    } else {
+        return "unknown field";
+    }
+    fputs("ok\n", b->out);
+    return NULL;
+}
+
+
+static const char* batchComplete(batchrun* b, char** fields, int count) {
+    (void)count;
+    task* t = findTask(b->list, fields[1]);
+    if (!t) {
+        return "no such task";
+    }
+    if (!completeTask(b->list, b->done, t, b->today)) {
+        return "out of memory";
+    }
+    fputs("ok\n", b->out);
+    return NULL;
+}
+
+
+static const char* batchUndo(batchrun* b, char** fields, int count) {
+    (void)fields;
+    (void)count;
+    // The newest completion of any shard: the latest day, then the latest stamp
+    int newest = -1;
+    completion last = {NULL, 0, 0};
+    for (int k = 0; k < b->store_count; k++) {
+        completionlog* done = &b->stores[k]->done;
+        if (done->count == 0) {
+            continue;
+        }
+        completion entry = done->entries[done->count - 1];
+        if (newest < 0 || entry.day > last.day || (entry.day == last.day && entry.stamp > last.stamp)) {
+            newest = k;
+            last = entry;
+        }
+    }
+    if (newest < 0) {
+        return "nothing to undo";
+    }
+    bindStore(b, newest);
+    task* t = undoCompleteTask(b->list, b->done);
+    if (!t) {
+        return "out of memory";  // the log of that shard is not empty
+    }
+    fprintf(b->out, "ok %s\n", taskName(t));
+    return NULL;
+}
+
+
+static const char* batchDelete(batchrun* b, char** fields, int count) {
+    (void)count;
+    task* t = findTask(b->list, fields[1]);
+    if (!t) {
+        return "no such task";
+    }
+    removeTask(b->list, t);
+    fputs("ok\n", b->out);
+    return NULL;
+}
+
+
+static const char* batchTag(batchrun* b, char** fields, int count) {
+    (void)count;
+    task* t = findTask(b->list, fields[1]);
+    if (!t) {
+        return "no such task";
+    }
+    if (!fields[2][0]) {
+        return "empty tag";
+    }
+    unsigned int id = tagIntern(fields[2]);
+    if (id == TAG_NO_ID) {
+        return "out of memory";
+    }
+    if (taskHasTag(t, id)) {
+        return "already tagged";
+    }
+    if (!listAddTag(b->list, t, id)) {
+        return "out of memory";
+    }
+    fputs("ok\n", b->out);
+    return NULL;
+}
+
+
+static const char* batchSearch(batchrun* b, char** fields, int count) {
+    (void)count;
+    if (!fields[1][0]) {
+        return "empty keyword";
+    }
+    task** matches[STORE_MAX_SHARDS];
+    int found[STORE_MAX_SHARDS];
+    int total = 0;
+    for (int k = 0; k < b->store_count; k++) {
+        bindStore(b, k);
+        found[k] = collectKeywordMatches(EPOCH_LOAD(b->list->head), b->done, 7, fields[1], &matches[k]);  // all fields
+        if (found[k] < 0) {
+            while (k-- > 0) {
+                free(matches[k]);
+            }
+            return "out of memory";
+        }
+        total += found[k];
+    }
+    // Pending matches of every shard come first, as they do unsharded. A
+    // reader takes each status once: the writer may complete a task meanwhile
+    unsigned char* completed = (unsigned char*)malloc(total ? total : 1);
+    if (!completed) {
+        for (int k = 0; k < b->store_count; k++) {
+            free(matches[k]);
+        }
+        return "out of memory";
+    }
+    for (int k = 0, at = 0; k < b->store_count; k++) {
+        for (int i = 0; i < found[k]; i++) {
+            completed[at++] = __atomic_load_n(&matches[k][i]->completed, __ATOMIC_RELAXED);
+        }
+    }
+    fprintf(b->out, "ok %d\n", total);
+    for (int pass = 0; pass <= 1; pass++) {
+        for (int k = 0, at = 0; k < b->store_count; at += found[k], k++) {
+            bindStore(b, k);
+            for (int i = 0; i < found[k]; i++) {
+                if (completed[at + i] == pass) {
+                    fputs(pass ? "completed\t" : "pending\t", b->out);
+                    fputs(taskName(matches[k][i]), b->out);
+                    fputc('\n', b->out);
+                }
+            }
+        }
+    }
+    free(completed);
+    for (int k = 0; k < b->store_count; k++) {
+        free(matches[k]);
+    }
+    return NULL;
+}
+
+
+// One line of the list answer; t is the task, key a copy of it taken by a reader
+static void writeListRow(batchrun* b, const task* t, const task* key) {
+    fputs(orderGroup(key) == ORDER_GROUP_OVERDUE ? "overdue\t" : "pending\t", b->out);
+    fputs(taskName(t), b->out);
+    fprintf(b->out, "\t%d\t", key->priority);
+    if (key->due_date_set) {
+        date due = taskDueDate(key);
+        fprintf(b->out, "%02d %02d %04d", due.day, due.month, due.year);
+    }
+    fputc('\n', b->out);
+}
+
+
+// One shard's rows of the list answer: the writer walks the view order
+// index, a reader walks copies sorted with the index's own order
+typedef struct {
+    orderiter it;
+    taskcopy* copies;
+    int count;
+    int next;
+} listcursor;
+
+
+/*
+openListCursor() - Starts a shard's rows of the list answer (the shard is bound)
+ - The view order index belongs to the writer, so on a reader the pending
+   tasks are copied from the linked list and sorted instead
+ - Time: O(log n) on the writer, O(n log n) on a reader, Space: O(n) on a reader
+ - Returns the number of rows, or -1 if memory ran out
+ */
+static int openListCursor(batchrun* b, listcursor* c) {
+    if (b->reading) {
+        c->count = copyPendingTasks(b->list, 1, &c->copies);
+        if (c->count < 0) {
+            return -1;
+        }
+        while (c->count > 0 && orderGroup(&c->copies[c->count - 1].key) == ORDER_GROUP_OTHER) {
+            c->count--;
+        }
+        return c->count;
+    }
+    orderIterBegin(&c->it, &b->list->order);
+    return b->list->order.count - b->list->order.group_counts[ORDER_GROUP_OTHER];
+}
+
+
+// The shard's next row, or NULL after its last; *key is the task as the row shows it
+static task* peekListCursor(batchrun* b, listcursor* c, const task** key) {
+    if (b->reading) {
+        if (c->next >= c->count) {
+            return NULL;
+        }
+        *key = &c->copies[c->next].key;
+        return c->copies[c->next].t;
+    }
+    task* t = orderIterPeek(&c->it);
+    *key = t;
+    return t && orderGroup(t) != ORDER_GROUP_OTHER ? t : NULL;
+}
+
+
+/*
+batchList() - Pending tasks in view order, the shards merged
+ - Each shard is already in view order, so the merge takes the first row
+   of the shard whose next row comes first
+ - Time: O(n · shards) plus the reader's sort, Space: O(shards) (O(n) on a reader)
+ */
+static const char* batchList(batchrun* b, char** fields, int count) {
+    (void)fields;
+    (void)count;
+    listcursor* cursors = (listcursor*)calloc(b->store_count, sizeof(listcursor));
+    if (!cursors) {
+        return "out of memory";
+    }
+    int rows = 0;
+    for (int k = 0; k < b->store_count; k++) {
+        bindStore(b, k);
+        int shard_rows = openListCursor(b, &cursors[k]);
+        if (shard_rows < 0) {
+            while (k-- > 0) {
+                free(cursors[k].copies);
+            }
+            free(cursors);
+            return "out of memory";
+        }
+        rows += shard_rows;
+    }
+
+    fprintf(b->out, "ok %d\n", rows);
+    while (1) {
+        int first = -1;
+        task* t = NULL;
+        const task* key = NULL;
+        for (int k = 0; k < b->store_count; k++) {
+            const task* shard_key;
+            task* shard_t = peekListCursor(b, &cursors[k], &shard_key);
+            if (shard_t && (first < 0 || orderCompare(shard_key, key) < 0)) {
+                first = k;
+                t = shard_t;
+                key = shard_key;
+            }
+        }
+        if (first < 0) {
+            break;
+        }
+        bindStore(b, first);
+        writeListRow(b, t, key);
+        if (b->reading) {
+            cursors[first].next++;
+        } else {
+            orderIterNext(&cursors[first].it);
+        }
+    }
+    for (int k = 0; k < b->store_count; k++) {
+        free(cursors[k].copies);
+    }
+    free(cursors);
+    return NULL;
+}
+
+
+static const char* batchStats(batchrun* b, char** fields, int count) {
+    (void)fields;
+    (void)count;
+    // The view order index already counts the overdue group. A reader only
+    // looks: the writer keeps the statuses current
+    int pending = 0, overdue = 0, completed = 0;
+    for (int k = 0; k < b->store_count; k++) {
+        bindStore(b, k);
+        if (!b->reading) {
+            updateTaskStatuses(b->list, b->today);
+        }
+        orderindex* order = &b->list->order;
+        int shard_overdue = __atomic_load_n(&order->group_counts[ORDER_GROUP_OVERDUE], __ATOMIC_RELAXED);
+        int shard_pending = __atomic_load_n(&order->count, __ATOMIC_RELAXED) - shard_overdue;
+        pending += shard_pending < 0 ? 0 : shard_pending;
+        overdue += shard_overdue;
+        completed += EPOCH_LOAD(b->done->count);
+    }
+    fprintf(b->out, "ok pending %d overdue %d completed %d\n", pending, overdue, completed);
+    return NULL;
+}
+
+
+// Import and export print their usual summary (one per shard) before the
+// ok line, on stdout (stderr in --batch mode, see main()). A shard imports its own export (taskStoreShardPath()) if there
+// is one, else the tasks it holds from the whole file
+static const char* batchImport(batchrun* b, char** fields, int count) {
+    (void)count;
+    fflush(b->out);
+    int imported = 0;
+    for (int k = 0; k < b->store_count && imported >= 0; k++) {
+        char* filename = taskStoreShardPath(fields[1], k, b->store_count);
+        bindStore(b, k);
+        int shard_imported = !filename ? -1
+                             : importTasks(b->list, b->done, access(filename, F_OK) == 0 ? filename : fields[1]);
+        imported = shard_imported < 0 ? -1 : imported + shard_imported;
+        free(filename);
+    }
+    fflush(stdout);
+    if (imported < 0) {
+        return "cannot read file";
+    }
+    fprintf(b->out, "ok %d\n", imported);
+    return NULL;
+}
+
+
+// A sharded list is exported to one file per shard (taskStoreShardPath())
+static const char* batchExport(batchrun* b, char** fields, int count) {
+    (void)count;
+    fflush(b->out);
+    int exported = 0;
+    for (int k = 0; k < b->store_count && exported >= 0; k++) {
+        char* filename = taskStoreShardPath(fields[1], k, b->store_count);
+        bindStore(b, k);
+        int shard_exported = filename ? exportTasks(b->list, b->done, filename) : -1;
+        exported = shard_exported < 0 ? -1 : exported + shard_exported;
+        free(filename);
+    }
+    fflush(stdout);
+    if (exported < 0) {
+        return "cannot write file";
+    }
+    fprintf(b->out, "ok %d\n", exported);
+    return NULL;
+}
+
+
+static const batchcommand batchCommands[] = {
+    {"add", 2, 5, BATCH_WRITE, 1, batchAdd},
+    {"edit", 4, 4, BATCH_WRITE, 1, batchEdit},
+    {"complete", 2, 2, BATCH_WRITE, 1, batchComplete},
+    {"undo", 1, 1, BATCH_WRITE, 0, batchUndo},
+    {"delete", 2, 2, BATCH_WRITE, 1, batchDelete},
+    {"tag", 3, 3, BATCH_WRITE, 1, batchTag},
+    {"search", 2, 2, BATCH_READ, 0, batchSearch},
+    {"list", 1, 1, BATCH_READ, 0, batchList},
+    {"stats", 1, 1, BATCH_READ, 0, batchStats},
+    {"import", 2, 2, BATCH_WRITE, 0, batchImport},
+    {"export", 2, 2, BATCH_READ, 0, batchExport},
+};
+
+
+/*
+runCommand() - Runs a command; on a reader run, inside a read section
+ - Binds the shard that holds the task a keyed command names, otherwise
+   the first; commands over every shard bind each in turn
+ - A reader run refuses writes: those belong to the writer's run
+ - Time: O(1) plus the command, Space: O(1)
+ - Returns NULL on success, otherwise why the command failed
+ */
+static const char* runCommand(batchrun* b, const batchcommand* command, char** fields, int count) {
+    if (command->keyed) {
+        bindShard(b, fields[1]);
+    } else {
+        bindStore(b, 0);
+    }
+    if (b->reader < 0) {
+        return command->run(b, fields, count);
+    }
+    if (command->access != BATCH_READ) {
+        return "not a read";
+    }
+    epochEnter(b->reader);
+    b->reading = 1;
+    const char* error = command->run(b, fields, count);
+    b->reading = 0;
+    epochExit(b->reader);
+    b->reads++;
+    return error;
+}
+
+
+/*
+runBatchLine() - Splits one command line at its tabs and runs it
+ - Time: O(line length) plus the command, Space: O(1) (split in place)
+ - Returns NULL on success, otherwise why the command failed
+ */
+static const char* runBatchLine(batchrun* b, char* line) {
+    char* fields[BATCH_MAX_FIELDS];
+    int count = 0;
+    for (char* p = line;; p++) {
+        if (count < BATCH_MAX_FIELDS) {
+            fields[count] = p;
+        }
+        count++;
+        p = strchr(p, '\t');
+        if (!p) {
+            break;
+        }
+        *p = '\0';
+    }
+
+    for (size_t i = 0; i < sizeof(batchCommands) / sizeof(batchCommands[0]); i++) {
+        const batchcommand* command = &batchCommands[i];
+        if (strcmp(fields[0], command->name) != 0) {
+            continue;
+        }
+        if (count < command->min_fields) {
+            return "missing field";
+        }
+        if (count > command->max_fields) {
+            return "too many fields";
+        }
+        return runCommand(b, command, fields, count);
+    }
+    return "unknown command";
+}
+
+
+/*
+lineFields() - Finds the first max tab-separated fields of a line without changing it
+ - A trailing newline or carriage return is not part of the last field
+ - Time: O(line length), Space: O(1)
+ - Returns the number of fields, counting those past max
+ */
+static int lineFields(const char* line, size_t length, const char** starts, size_t* lengths, int max) {
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+        length--;
+    }
+    const char* end = line + length;
+    int count = 0;
+    for (const char* p = line;; count++) {
+        const char* tab = (const char*)memchr(p, '\t', end - p);
+        if (count < max) {
+            starts[count] = p;
+            lengths[count] = (size_t)((tab ? tab : end) - p);
+        }
+        if (!tab) {
+            return count + 1;
+        }
+        p = tab + 1;
+    }
+}
+
+
+// The command called name, or NULL
+static const batchcommand* findCommand(const char* name, size_t length) {
+    for (size_t i = 0; i < sizeof(batchCommands) / sizeof(batchCommands[0]); i++) {
+        const batchcommand* command = &batchCommands[i];
+        if (strlen(command->name) == length && memcmp(name, command->name, length) == 0) {
+            return command;
+        }
+    }
+    return NULL;
+}
+
+
+/*
+batchLineAccess() - How the command on a line touches the list, without running it
+ - An unknown command is a read: its error is answered without touching anything
+ - The line is not changed; a trailing newline or carriage return is ignored
+ - Time: O(line length), Space: O(1)
+ - Returns BATCH_SKIP, BATCH_READ or BATCH_WRITE
+ - Example: batchLineAccess("complete\tStudy", 14) -> BATCH_WRITE
+ */
+int batchLineAccess(const char* line, size_t length) {
+    const char* starts[2];
+    size_t lengths[2];
+    int count = lineFields(line, length, starts, lengths, 2);
+    if ((count == 1 && lengths[0] == 0) || line[0] == '#') {
+        return BATCH_SKIP;
+    }
+    const batchcommand* command = findCommand(starts[0], lengths[0]);
+    return command ? command->access : BATCH_READ;
+}
+
+
+/*
+batchLineShard() - Which of shard_count shards the command on a line changes
+ - A keyed command changes the shard that holds its task; a rename to a
+   name another shard holds moves the task and, like undo and import,
+   needs every shard (BATCH_ALL_SHARDS)
+ - The line is not changed; a trailing newline or carriage return is ignored
+ - Time: O(line length), Space: O(1)
+ - Returns the shard, or BATCH_ALL_SHARDS
+ - Example: batchLineShard("undo", 4, 4) -> BATCH_ALL_SHARDS
+ */
+int batchLineShard(const char* line, size_t length, int shard_count) {
+    if (shard_count <= 1) {
+        return 0;
+    }
+    const char* starts[4];
+    size_t lengths[4];
+    int count = lineFields(line, length, starts, lengths, 4);
+    const batchcommand* command = findCommand(starts[0], lengths[0]);
+    if (!command || !command->keyed) {
+        return BATCH_ALL_SHARDS;
+    }
+    if (count < 2) {
+        return 0;  // answered with an error
+    }
+    int shard = taskStoreShardOf(starts[1], lengths[1], shard_count);
+    if (count == 4 && strcmp(command->name, "edit") == 0 && lengths[2] == 4 && memcmp(starts[2], "name", 4) == 0 &&
+        taskStoreShardOf(starts[3], lengths[3], shard_count) != shard) {
+        return BATCH_ALL_SHARDS;
+    }
+    return shard;
+}
+
+
+/*
+batchExecute() - Runs one command line and writes its answer to b->out
+ - Trailing newline and carriage return are ignored; blank lines and lines
+   starting with # are skipped without an answer
+ - Shared by runBatch() and the socket server, which answers each client
+   into its own stream
+ - Time: O(line length) plus the command, Space: O(1) (split in place)
+ - Returns 1 if a command ran (even if it failed), 0 if the line was skipped
+ */
+int batchExecute(batchrun* b, char* line, size_t length) {
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+        line[--length] = '\0';
+    }
+    if (length == 0 || line[0] == '#') {
+        return 0;
+    }
+    const char* error = runBatchLine(b, line);
+    if (error) {
+        fprintf(b->out, "error %s\n", error);
+        b->failed++;
+    }
+    b->commands++;
+    return 1;
+}
+
+
+/*
+batchAnswerStream() - Gives stdout to the batch answers and sends everything else printed to stderr
+ - The modules print restores, replays, import and export summaries,
+   warnings and saves with printf(); once stdout is stderr they no longer
+   mix with the answers. Call it before any store is opened
+ - Time: O(1), Space: O(1)
+ - Returns a stream on the original stdout for runBatch(), or NULL with errno set
+ */
+FILE* batchAnswerStream(void) {
+    fflush(stdout);
+    int fd = dup(STDOUT_FILENO);
+    FILE* answers = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (!answers) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+    if (dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+        int error = errno;
+        fclose(answers);
+        errno = error;
+        return NULL;
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);  // in step with stderr
+    return answers;
+}
+
+
+/*
+runBatch() - Runs every command read from in, answering each on out
+ - stores is the list, store_count shards of it (1: not sharded)
+ - Nothing is prompted or paused for, and answers stay in the stream's
+   buffer until it fills. A checkpoint is polled for every BATCH_POLL_EVERY
+   commands, on every shard
+ - The command count, failures and rate go to stderr at the end
+ - Time: O(input length) plus the commands, Space: O(longest line)
+ - Returns the number of commands that failed
+ - Example: printf 'add\tStudy\tChapter 3\t1\nstats\n' | todo_progress --batch
+      -> "ok" and "ok pending 1 overdue 0 completed 0"
+ */
+long runBatch(taskstore** stores, int store_count, FILE* in, FILE* out) {
+    batchrun b = {stores, store_count, NULL, NULL, stores[0]->today, out, 0, 0, -1, 0, 0};
+    double start = batchSeconds();
+    char* line = NULL;
+    size_t capacity = 0;
+    ssize_t length;
+    while ((length = getline(&line, &capacity, in)) >= 0) {
+        if (batchExecute(&b, line, (size_t)length) && b.commands % BATCH_POLL_EVERY == 0) {
+            for (int k = 0; k < store_count; k++) {
+                taskStoreUse(stores[k]);
+                checkpointPoll(&stores[k]->list, &stores[k]->done);
+            }
+        }
+    }
+    free(line);
+    double seconds = batchSeconds() - start;
+
+    fflush(out);
+    fprintf(stderr, "Batch: %ld commands (%ld failed) in %.3f s, %.0f commands/s\n", b.commands, b.failed,
+            seconds, seconds > 0 ? b.commands / seconds : 0.0);
+    return b.failed;
+}
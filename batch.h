@@ -0,0 +1,83 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include "task_management.h"
+#include "taskstore.h"
+
+// Batch mode (todo_progress --batch [file]) runs one command per line,
+// fields separated by tabs, back to back with no prompts or pauses.
+// Every command answers with one line: "ok" plus its result, or
+// "error <reason>"; search follows its "ok <count>" with one line per
+// match. Blank lines and lines starting with # are skipped.
+//
+// Several threads may run commands on one list when one of them makes
+// every change: the others are reader runs, which only get the lines that
+// batchLineAccess() calls reads and run each in an epoch read section
+// (see epoch.h), so they never wait for the writer.
+//
+// A run works on one list, which may be split into shards (taskstore.h).
+// A command on a named task runs on the shard that holds it; the others
+// go over every shard: list merges the shards in view order, export
+// writes one file per shard (<file>.<shard>), and import reads the file
+// once per shard, each keeping the tasks it holds. With shards, the
+// changes of different shards may be made by different threads, one per
+// shard; a command that changes several (batchLineShard()) needs all of
+// them to itself.
+//
+//   add <name> [<description> [<priority 1-3> [<DD MM YYYY>]]]
+//   edit <name> name|description|priority|due <value>   (an empty due clears it)
+//   complete <name>
+//   undo
+//   delete <name>
+//   tag <name> <tag>
+//   search <keyword>
+//   list                  (pending tasks in view order: "ok <count>", then
+//                          <overdue|pending> <name> <priority> <DD MM YYYY>)
+//   stats
+//   import <file>
+//   export <file>
+#define BATCH_MAX_FIELDS 5
+#define BATCH_POLL_EVERY 1024           // commands between checkpointPoll() calls
+
+// How a command touches the list (batchLineAccess())
+#define BATCH_SKIP -1                   // blank line or comment: no answer
+#define BATCH_READ 0                    // reads only: may run on a reader run
+#define BATCH_WRITE 1                   // changes the list: the writer runs it
+#define BATCH_ALL_SHARDS -1             // batchLineShard(): the command changes several shards
+
+// State shared by the commands of one run
+typedef struct {
+    taskstore** stores;                 // the list: one store, or its shards in order
+    int store_count;
+    tasklist* list;                     // of the store bound for the command
+    completionlog* done;
+    date today;
+    FILE* out;
+    long commands;
+    long failed;
+    int reader;                         // epoch slot of a reader run, -1 for the writer
+    int reading;                        // inside a read section right now
+    long reads;                         // commands run as read sections
+} batchrun;
+
+// One command: its name, how many fields it takes (the name included),
+// how it touches the list, whether its second field names the task it
+// works on, and the function that runs it; that prints the ok line and
+// returns NULL, or returns why it failed
+typedef struct {
+    const char* name;
+    int min_fields;
+    int max_fields;
+    int access;
+    int keyed;                          // runs on the shard that holds fields[1]
+    const char* (*run)(batchrun* b, char** fields, int count);
+} batchcommand;
+
+int batchLineAccess(const char* line, size_t length);
+int batchLineShard(const char* line, size_t length, int shard_count);
+int batchExecute(batchrun* b, char* line, size_t length);
+FILE* batchAnswerStream(void);
+long runBatch(taskstore** stores, int store_count, FILE* in, FILE* out);
+
+#endif
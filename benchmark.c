@@ -0,0 +1,386 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "benchmark.h"
+#include "scheduler.h"
+#include "textsearch.h"
+#include "crc32c.h"
+
+// Dates are drawn from a pool; pair i is (pool[i & mask], pool[(i * 7919) & mask])
+#define DATE_POOL_SIZE (1 << 16)
+#define DATE_POOL_MASK (DATE_POOL_SIZE - 1)
+#define DATE_BENCH_PAIRS 10000000L
+
+// Substring benchmark: texts shaped like task names and descriptions
+#define TEXT_BENCH_TASKS 100000
+#define TEXT_BENCH_ROUNDS 20
+
+// CRC benchmark: journal-sized records, checksummed over and over
+#define CRC_BENCH_RECORD 96
+#define CRC_BENCH_BYTES (64L << 20)
+
+static volatile long benchSink;   // keeps the timed loops from being optimized away
+
+
+/*
+benchNow() - Monotonic clock in seconds
+ - Time: O(1), Space: O(1)
+ */
+static double benchNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+// The struct-based date functions as they were before serial days,
+// kept here only as the baseline of the benchmark
+
+static int legacyCompareDates(date d1, date d2) {
+    if (d1.year != d2.year) return d1.year - d2.year;
+    if (d1.month != d2.month) return d1.month - d2.month;
+    return d1.day - d2.day;
+}
+
+static int legacyGetDaysBetween(date d1, date d2) {
+    const int daysInMonth[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int days1 = d1.year * 365 + d1.day;
+    int days2 = d2.year * 365 + d2.day;
+    for (int i = 1; i < d1.month; i++) days1 += daysInMonth[i];
+    for (int i = 1; i < d2.month; i++) days2 += daysInMonth[i];
+    days1 += d1.year / 4;
+    days2 += d2.year / 4;
+    return days2 - days1;
+}
+
+static int legacyIsDateSoon(date today, date duedate, int daysThreshold) {
+    if (duedate.year > today.year) {
+        if (duedate.month == 1 && today.month == 12) {
+            return (31 - today.day + duedate.day) <= daysThreshold;
+        }
+        return 0;
+    }
+    if (duedate.month > today.month) {
+        if (duedate.month - today.month == 1) {
+            int daysInCurrentMonth;
+            switch (today.month) {
+                case 2: daysInCurrentMonth = 28; break;
+                case 4: case 6: case 9: case 11: daysInCurrentMonth = 30; break;
+                default: daysInCurrentMonth = 31;
+            }
+            return (daysInCurrentMonth - today.day + duedate.day) <= daysThreshold;
+        }
+        return 0;
+    }
+    return (duedate.day - today.day) <= daysThreshold && (duedate.day - today.day) >= 0;
+}
+
+static int legacyIsDateWithinDays(date today, date check_date, int days) {
+    int today_days = today.year * 365 + today.month * 30 + today.day;
+    int check_days = check_date.year * 365 + check_date.month * 30 + check_date.day;
+    int diff = check_days - today_days;
+    return (diff >= 0 && diff <= days);
+}
+
+
+/*
+benchmarkDates() - Times struct-based date functions against serial-day arithmetic
+ - Each row runs the same pairs through the old function and through one
+   integer subtraction on serial days; the last lines count pairs where the
+   old functions disagree with the exact answer
+ - Pairs are drawn from a few months around each other so "soon" and
+   "within a week" cases actually occur
+ - Time: O(pairs), Space: O(pool)
+ - Sample Case:
+    Input: pairs = 10000000
+    Output:
+      dateToDays             57.0 ms (paid once per due date)
+      getDaysBetween       legacy    309.5 ms   serial     15.9 ms   (19.5x)
+      ...
+      getDaysBetween: 0 | isDateSoon: 122196 | isDateWithinDays: 18777
+ */
+void benchmarkDates(long pairs) {
+    date* pool = (date*)malloc(DATE_POOL_SIZE * sizeof(date));
+    int* serial = (int*)malloc(DATE_POOL_SIZE * sizeof(int));
+    if (!pool || !serial) {
+        printf("Memory allocation failed. Benchmark skipped.\n");
+        free(pool);
+        free(serial);
+        return;
+    }
+
+    // Dates within about three months of 01/11/2025, so pairs cross month and year ends
+    srand(12345);
+    int base = dateToDays((date){1, 11, 2025});
+    for (int i = 0; i < DATE_POOL_SIZE; i++) {
+        pool[i] = daysToDate(base + rand() % 120);
+    }
+
+    printf("\n=== Date Benchmark: %ld date pairs ===\n", pairs);
+
+    // Converting once per date is what setDueDate()/import pay
+    double start = benchNow();
+    long sum = 0;
+    for (long i = 0; i < pairs; i++) {
+        sum += dateToDays(pool[i & DATE_POOL_MASK]);
+    }
+    double convert_time = benchNow() - start;
+    benchSink = sum;
+    for (int i = 0; i < DATE_POOL_SIZE; i++) {
+        serial[i] = dateToDays(pool[i]);
+    }
+    printf("%-18s %8.1f ms (paid once per due date)\n", "dateToDays", convert_time * 1000);
+
+    const char* names[] = {"compareDates", "getDaysBetween", "isDateSoon(2)", "isDateWithinDays(7)"};
+    for (int fn = 0; fn < 4; fn++) {
+        // Old struct-based function
+        start = benchNow();
+        sum = 0;
+        for (long i = 0; i < pairs; i++) {
+            date a = pool[i & DATE_POOL_MASK];
+            date b = pool[(i * 7919) & DATE_POOL_MASK];
+            switch (fn) {
+                case 0: sum += legacyCompareDates(a, b) < 0; break;
+                case 1: sum += legacyGetDaysBetween(a, b); break;
+                case 2: sum += legacyIsDateSoon(a, b, 2); break;
+                default: sum += legacyIsDateWithinDays(a, b, 7); break;
+            }
+        }
+        double legacy_time = benchNow() - start;
+        benchSink = sum;
+
+        // One subtraction on stored serial days
+        start = benchNow();
+        sum = 0;
+        for (long i = 0; i < pairs; i++) {
+            int diff = serial[(i * 7919) & DATE_POOL_MASK] - serial[i & DATE_POOL_MASK];
+            switch (fn) {
+                case 0: sum += diff > 0; break;
+                case 1: sum += diff; break;
+                case 2: sum += diff >= 0 && diff <= 2; break;
+                default: sum += diff >= 0 && diff <= 7; break;
+            }
+        }
+        double serial_time = benchNow() - start;
+        benchSink = sum;
+
+        printf("%-20s legacy %8.1f ms   serial %8.1f ms   (%.1fx)\n", names[fn],
+               legacy_time * 1000, serial_time * 1000,
+               serial_time > 0 ? legacy_time / serial_time : 0.0);
+    }
+
+    // How often the old functions were wrong on these pairs
+    long wrong_between = 0, wrong_soon = 0, wrong_within = 0;
+    for (long i = 0; i < pairs; i++) {
+        date a = pool[i & DATE_POOL_MASK];
+        date b = pool[(i * 7919) & DATE_POOL_MASK];
+        int diff = serial[(i * 7919) & DATE_POOL_MASK] - serial[i & DATE_POOL_MASK];
+        wrong_between += legacyGetDaysBetween(a, b) != diff;
+        wrong_soon += legacyIsDateSoon(a, b, 2) != (diff >= 0 && diff <= 2);
+        wrong_within += legacyIsDateWithinDays(a, b, 7) != (diff >= 0 && diff <= 7);
+    }
+    printf("Legacy answers that differ from exact serial days:\n");
+    printf("  getDaysBetween: %ld | isDateSoon: %ld | isDateWithinDays: %ld\n",
+           wrong_between, wrong_soon, wrong_within);
+
+    free(pool);
+    free(serial);
+}
+
+
+/*
+benchmarkSubstring() - Times strstr() against each substring kernel over task-like text
+ - Texts are packed one after another like the string arena, with known lengths
+ - Each needle is searched in every text TEXT_BENCH_ROUNDS times; the match
+   counts must agree between strstr() and the exact kernels, and between
+   the case-insensitive kernels
+ - Time: O(tasks · text length · rounds), Space: O(tasks · text length)
+ */
+void benchmarkSubstring(int tasks) {
+    static const char* words[] = {
+        "weekly", "report", "meeting", "with", "team", "review", "budget", "draft",
+        "submit", "homework", "project", "call", "client", "update", "slides", "plan",
+        "the", "for", "and", "buy", "groceries", "fix", "bug", "in", "login", "page",
+        "prepare", "exam", "notes", "Data", "Structures", "lab", "email", "Professor",
+        "renew", "passport", "book", "flight", "pay", "rent", "clean", "room"
+    };
+    const int word_count = (int)(sizeof(words) / sizeof(words[0]));
+
+    size_t* offsets = (size_t*)malloc(tasks * sizeof(size_t));
+    size_t* lengths = (size_t*)malloc(tasks * sizeof(size_t));
+    size_t capacity = (size_t)tasks * 128;
+    char* text = (char*)malloc(capacity);
+    if (!offsets || !lengths || !text) {
+        printf("Memory allocation failed for the substring benchmark!\n");
+        free(offsets);
+        free(lengths);
+        free(text);
+        return;
+    }
+
+    // 8-19 words per task, about a name plus a short description
+    srand(54321);
+    size_t used = 0;
+    for (int i = 0; i < tasks; i++) {
+        offsets[i] = used;
+        int n = 8 + rand() % 12;
+        for (int w = 0; w < n; w++) {
+            const char* word = words[rand() % word_count];
+            size_t length = strlen(word);
+            if (used + length + 2 >= capacity) {
+                break;
+            }
+            if (w > 0) {
+                text[used++] = ' ';
+            }
+            memcpy(text + used, word, length);
+            used += length;
+        }
+        lengths[i] = used - offsets[i];
+        text[used++] = '\0';
+    }
+
+    typedef struct {
+        const char* name;
+        substringfn fn;
+        int fold;
+    } kernelcase;
+    kernelcase kernels[] = {
+        {"scalar", findSubstringScalar, 0},
+#ifdef TEXTSEARCH_X86
+        {"SSE2", findSubstringSSE2, 0},
+        {"AVX2", findSubstringAVX2, 0},
+#endif
+        {"dispatched", findSubstring, 0},
+        {"nocase scalar", findSubstringNoCaseScalar, 1},
+#ifdef TEXTSEARCH_X86
+        {"nocase SSE2", findSubstringNoCaseSSE2, 1},
+        {"nocase AVX2", findSubstringNoCaseAVX2, 1},
+#endif
+        {"nocase dispatched", findSubstringNoCase, 1},
+    };
+    const int kernel_count = (int)(sizeof(kernels) / sizeof(kernels[0]));
+    const char* needles[] = {"report", "Professor", "invoice", "structures"};
+    const int needle_count = (int)(sizeof(needles) / sizeof(needles[0]));
+    double gigabytes = (double)used * TEXT_BENCH_ROUNDS / 1e9;
+
+    printf("\n=== Substring Benchmark: %d tasks, %.1f MB of text, %d rounds ===\n",
+           tasks, used / 1e6, TEXT_BENCH_ROUNDS);
+    printf("Dispatched kernel: %s\n", substringKernelName());
+
+    for (int k = 0; k < needle_count; k++) {
+        const char* needle = needles[k];
+        size_t needle_len = strlen(needle);
+        printf("Needle \"%s\":\n", needle);
+
+        double start = benchNow();
+        long matches = 0;
+        for (int r = 0; r < TEXT_BENCH_ROUNDS; r++) {
+            for (int i = 0; i < tasks; i++) {
+                matches += strstr(text + offsets[i], needle) != NULL;
+            }
+        }
+        double elapsed = benchNow() - start;
+        benchSink = matches;
+        printf("  %-18s %8.1f ms %6.2f GB/s  matches %ld\n", "strstr",
+               elapsed * 1000, elapsed > 0 ? gigabytes / elapsed : 0.0, matches / TEXT_BENCH_ROUNDS);
+
+        long strstr_matches = matches, fold_matches = -1;
+        for (int j = 0; j < kernel_count; j++) {
+#ifdef TEXTSEARCH_X86
+            if ((kernels[j].fn == findSubstringAVX2 || kernels[j].fn == findSubstringNoCaseAVX2) && !cpuHasAVX2()) {
+                continue;
+            }
+#endif
+            start = benchNow();
+            matches = 0;
+            for (int r = 0; r < TEXT_BENCH_ROUNDS; r++) {
+                for (int i = 0; i < tasks; i++) {
+                    matches += kernels[j].fn(text + offsets[i], lengths[i], needle, needle_len) != NULL;
+                }
+            }
+            elapsed = benchNow() - start;
+            benchSink = matches;
+
+            const char* check = "";
+            if (!kernels[j].fold) {
+                check = matches == strstr_matches ? "" : "  MISMATCH";
+            } else if (fold_matches < 0) {
+                fold_matches = matches;
+            } else if (matches != fold_matches) {
+                check = "  MISMATCH";
+            }
+            printf("  %-18s %8.1f ms %6.2f GB/s  matches %ld%s\n", kernels[j].name,
+                   elapsed * 1000, elapsed > 0 ? gigabytes / elapsed : 0.0,
+                   matches / TEXT_BENCH_ROUNDS, check);
+        }
+    }
+
+    free(offsets);
+    free(lengths);
+    free(text);
+}
+
+
+/*
+benchmarkCrc32c() - Times each CRC-32C kernel on records the size of a journal entry
+ - Every kernel must produce the same checksum sum
+ - Time: O(bytes), Space: O(1)
+ */
+void benchmarkCrc32c(long bytes) {
+    unsigned char record[CRC_BENCH_RECORD];
+    for (int i = 0; i < CRC_BENCH_RECORD; i++) {
+        record[i] = (unsigned char)(i * 31 + 7);
+    }
+
+    typedef struct {
+        const char* name;
+        crc32cfn fn;
+    } crccase;
+    crccase kernels[] = {
+        {"scalar", crc32cScalar},
+#ifdef CRC32C_X86
+        {"SSE4.2", crc32cSSE42},
+#endif
+        {"dispatched", crc32c},
+    };
+    const int kernel_count = (int)(sizeof(kernels) / sizeof(kernels[0]));
+    long records = bytes / CRC_BENCH_RECORD;
+
+    printf("\n=== CRC-32C Benchmark: %ld records of %d bytes ===\n", records, CRC_BENCH_RECORD);
+    printf("Dispatched kernel: %s\n", crc32cKernelName());
+    unsigned long long expected = 0;
+    for (int k = 0; k < kernel_count; k++) {
+#ifdef CRC32C_X86
+        if (kernels[k].fn == crc32cSSE42 && !cpuHasSSE42()) {
+            continue;
+        }
+#endif
+        double start = benchNow();
+        unsigned long long sum = 0;
+        for (long i = 0; i < records; i++) {
+            record[0] = (unsigned char)i;
+            sum += kernels[k].fn(0, record, CRC_BENCH_RECORD);
+        }
+        double elapsed = benchNow() - start;
+        benchSink = (long)sum;
+        if (k == 0) {
+            expected = sum;
+        }
+        printf("  %-12s %8.1f ms %6.2f GB/s %8.1f ns/record%s\n", kernels[k].name, elapsed * 1000,
+               elapsed > 0 ? records * (double)CRC_BENCH_RECORD / 1e9 / elapsed : 0.0,
+               records ? elapsed * 1e9 / records : 0.0, sum == expected ? "" : "  MISMATCH");
+    }
+}
+
+
+/*
+runBenchmarks() - Hidden menu option 98: runs every microbenchmark
+ - Time: O(benchmark sizes), Space: O(benchmark pools)
+ */
+void runBenchmarks(void) {
+    benchmarkDates(DATE_BENCH_PAIRS);
+    benchmarkSubstring(TEXT_BENCH_TASKS);
+    benchmarkCrc32c(CRC_BENCH_BYTES);
+}
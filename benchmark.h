@@ -0,0 +1,9 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+void benchmarkDates(long pairs);
+void benchmarkSubstring(int tasks);
+void benchmarkCrc32c(long bytes);
+void runBenchmarks(void);
+
+#endif
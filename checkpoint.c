@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "checkpoint.h"
+#include "snapshot.h"
+#include "taskstore.h"
+
+
+static double checkpointSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+// A non-negative number from the environment, or fallback when unset or invalid
+static long checkpointSetting(const char* name, long fallback) {
+    const char* setting = getenv(name);
+    if (!setting || !setting[0]) {
+        return fallback;
+    }
+    char* end;
+    long value = strtol(setting, &end, 10);
+    return *end == '\0' && value >= 0 ? value : fallback;
+}
+
+
+// Reads the triggers once; the clock for the time trigger starts here
+static void configureCheckpoints(checkpointer* c) {
+    c->min_bytes = (unsigned long long)checkpointSetting("TODO_CHECKPOINT_BYTES", CHECKPOINT_BYTES);
+    c->interval = checkpointSetting("TODO_CHECKPOINT_SECONDS", CHECKPOINT_SECONDS);
+    c->last_finished = checkpointSeconds();
+    c->configured = 1;
+}
+
+
+/*
+runCheckpointChild() - Body of the forked child: writes the snapshot and exits
+ - The child sees the tasks as they were at fork(); only this thread
+   exists in it, so it touches nothing the journal thread may have held
+   locked and leaves with _exit() (no stdio buffers are flushed twice)
+ - Time: O(n + total text), Space: O(n)
+ */
+static void runCheckpointChild(tasklist* list, completionlog* done, journalmark mark, int out) {
+    double start = checkpointSeconds();
+    checkpointresult result = {0, 0, 0.0};
+    result.saved = snapshotWrite(list, done, currentStore->snapshot_path, mark.generation, mark.offset);
+    if (result.saved < 0) {
+        result.error = errno ? errno : EIO;
+    }
+    result.seconds = checkpointSeconds() - start;
+    ssize_t written = write(out, &result, sizeof(result));
+    _exit(result.error || written != (ssize_t)sizeof(result) ? 1 : 0);
+}
+
+
+/*
+startCheckpoint() - Forks a child to snapshot the tasks at the current journal mark
+ - Time: O(process size / page size) for fork(), Space: O(1) until pages are written
+ */
+static void startCheckpoint(checkpointer* c, tasklist* list, completionlog* done, journalmark mark) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        c->failed++;
+        c->last_error = errno;
+        c->retry_after = checkpointSeconds() + CHECKPOINT_RETRY_SECONDS;
+        printf("Warning: Could not start a background checkpoint (%s).\n", strerror(c->last_error));
+        return;
+    }
+    double start = checkpointSeconds();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        runCheckpointChild(list, done, mark, fds[1]);
+    }
+    double pause = checkpointSeconds() - start;
+    close(fds[1]);
+    if (pid < 0) {
+        c->failed++;
+        c->last_error = errno;
+        c->retry_after = checkpointSeconds() + CHECKPOINT_RETRY_SECONDS;
+        close(fds[0]);
+        printf("Warning: Could not start a background checkpoint (%s).\n", strerror(c->last_error));
+        return;
+    }
+    c->child = pid;
+    c->result_fd = fds[0];
+    c->mark = mark;
+    c->started = start;
+    c->last_fork = pause;
+    if (pause > c->longest_fork) {
+        c->longest_fork = pause;
+    }
+}
+
+
+/*
+finishCheckpoint() - Collects the child's result and compacts the journal behind it
+ - status is the child's wait status
+ - Time: O(journal bytes written since the fork), Space: O(1)
+ */
+static void finishCheckpoint(checkpointer* c, int status) {
+    checkpointresult result = {EIO, 0, 0.0};
+    ssize_t got;
+    do {
+        got = read(c->result_fd, &result, sizeof(result));
+    } while (got < 0 && errno == EINTR);
+    close(c->result_fd);
+    c->child = 0;
+    if (got != (ssize_t)sizeof(result) || !WIFEXITED(status)) {
+        result.error = EIO;  // the child died before reporting
+    }
+
+    double now = checkpointSeconds();
+    c->last_finished = now;
+    if (result.error) {
+        c->failed++;
+        c->last_error = result.error;
+        c->retry_after = now + CHECKPOINT_RETRY_SECONDS;
+        printf("Warning: Background checkpoint to %s failed (%s); will retry.\n", currentStore->snapshot_path,
+               strerror(result.error));
+        return;
+    }
+
+    if (!journalCompact(c->mark)) {
+        c->retry_after = now + CHECKPOINT_RETRY_SECONDS;  // the snapshot is fine; the journal just stays long
+    }
+    double compacted = checkpointSeconds();
+    struct stat info;
+    c->written++;
+    c->last_error = 0;
+    c->last_tasks = result.saved;
+    c->last_size = stat(currentStore->snapshot_path, &info) == 0 ? (unsigned long long)info.st_size : 0;
+    c->last_records = c->mark.records;
+    c->last_compact = compacted - now;
+    if (c->last_compact > c->longest_compact) {
+        c->longest_compact = c->last_compact;
+    }
+    c->last_seconds = result.seconds;
+    c->total_seconds += c->last_seconds;
+    if (c->last_seconds > c->longest_seconds) {
+        c->longest_seconds = c->last_seconds;
+    }
+}
+
+
+/*
+checkpointPoll() - Collects a finished checkpoint and starts one when it is due
+ - Called before every menu action. A checkpoint starts once the journal
+   holds TODO_CHECKPOINT_BYTES, or TODO_CHECKPOINT_SECONDS after the last
+   one if anything was journaled since; never while one is running, while
+   snapshots or journaling are off, or before the snapshot has loaded
+ - Time: O(1) unless a checkpoint finishes or starts, Space: O(1)
+ */
+void checkpointPoll(tasklist* list, completionlog* done) {
+    checkpointer* c = &currentStore->checkpoint;
+    if (!c->configured) {
+        configureCheckpoints(c);
+    }
+    if (c->child) {
+        int status;
+        pid_t reaped = waitpid(c->child, &status, WNOHANG);
+        if (reaped == 0 || (reaped < 0 && errno == EINTR)) {
+            return;  // still writing
+        }
+        finishCheckpoint(c, reaped == c->child ? status : -1);
+    }
+    if (!currentStore->snapshot_path || !journalEnabled() || !snapshotWritable()) {
+        return;
+    }
+    double now = checkpointSeconds();
+    if (now < c->retry_after) {
+        return;
+    }
+    journalmark mark = journalMark();
+    int by_size = c->min_bytes && mark.bytes >= c->min_bytes;
+    int by_time = c->interval && mark.records > 0 && now - c->last_finished >= c->interval;
+    if (by_size || by_time) {
+        startCheckpoint(c, list, done, mark);
+    }
+}
+
+
+/*
+checkpointWait() - Waits for a running checkpoint and collects it
+ - Called before the snapshot saved on exit, which must not race it
+ - Time: until the child exits, Space: O(1)
+ */
+void checkpointWait(void) {
+    checkpointer* c = &currentStore->checkpoint;
+    if (!c->child) {
+        return;
+    }
+    int status;
+    pid_t reaped;
+    do {
+        reaped = waitpid(c->child, &status, 0);
+    } while (reaped < 0 && errno == EINTR);
+    finishCheckpoint(c, reaped == c->child ? status : -1);
+}
+
+
+/*
+printCheckpointStats() - Prints checkpoint triggers, durations and pauses
+ - Time: O(1), Space: O(1)
+ */
+void printCheckpointStats(void) {
+    checkpointer* c = &currentStore->checkpoint;
+    printf("--- Checkpoints ---\n");
+    if (!c->configured) {
+        configureCheckpoints(c);
+    }
+    if (!currentStore->snapshot_path || !journalEnabled()) {
+        printf("Off (needs both the snapshot and the journal)\n");
+        return;
+    }
+    printf("Trigger: %llu journal bytes or %ld s with changes, written: %ld, failed: %ld\n",
+           c->min_bytes, c->interval, c->written, c->failed);
+    if (c->child) {
+        printf("Running: child %ld for %.3f s, snapshot at %ld records\n", (long)c->child,
+               checkpointSeconds() - c->started, c->mark.records);
+    }
+    if (c->written) {
+        printf("Last: %d tasks (%llu bytes) written in %.3f s, %ld journal records folded in\n",
+               c->last_tasks, c->last_size, c->last_seconds, c->last_records);
+        printf("Write time: %.3f s average, %.3f s longest\n", c->total_seconds / c->written, c->longest_seconds);
+        printf("Menu pauses: fork %.3f ms (%.3f ms longest), compaction %.3f ms (%.3f ms longest)\n",
+               c->last_fork * 1000, c->longest_fork * 1000, c->last_compact * 1000, c->longest_compact * 1000);
+    }
+    if (c->last_error) {
+        printf("Last failure: %s\n", strerror(c->last_error));
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <sys/types.h>
+#include "task_management.h"
+#include "journal.h"
+
+// Background checkpoints keep the journal short. Once enough has been
+// journaled, a forked child writes a snapshot from its copy-on-write view
+// of the tasks while the menu goes on; when it is done the journal drops
+// every record the new snapshot holds (journalCompact()). The menu only
+// waits for fork() itself and for copying the records made meanwhile.
+#define CHECKPOINT_BYTES (16u << 20)    // TODO_CHECKPOINT_BYTES overrides; 0: no size trigger
+#define CHECKPOINT_SECONDS 300          // TODO_CHECKPOINT_SECONDS overrides; 0: no time trigger
+#define CHECKPOINT_RETRY_SECONDS 60     // wait after a failed checkpoint
+
+// What the child sends back through its pipe
+typedef struct {
+    int error;                          // errno of the failed save, 0 on success
+    int saved;                          // tasks written
+    double seconds;                     // time the child took to write and sync
+} checkpointresult;
+
+typedef struct {
+    int configured;
+    unsigned long long min_bytes;       // journal bytes that start a checkpoint
+    long interval;                      // seconds between checkpoints while there are changes
+    pid_t child;                        // 0 while no checkpoint is running
+    int result_fd;                      // read end of the child's pipe
+    journalmark mark;                   // journal position the running snapshot holds
+    double started;
+    double last_finished;               // last checkpoint, or startup
+    double retry_after;
+    // Counters for printCheckpointStats()
+    long written;
+    long failed;
+    int last_error;
+    int last_tasks;
+    unsigned long long last_size;       // bytes of the last snapshot
+    long last_records;                  // journal records it made unnecessary to replay
+    double last_seconds;                // time the child took to write the snapshot
+    double longest_seconds;
+    double total_seconds;
+    double last_fork;                   // menu pause for fork()
+    double longest_fork;
+    double last_compact;                // menu pause for the compaction
+    double longest_compact;
+} checkpointer;
+
+void checkpointPoll(tasklist* list, completionlog* done);
+void checkpointWait(void);
+void printCheckpointStats(void);
+
+#endif
@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "coldstore.h"
+#include "task_management.h"
+#include "epoch.h"
+#include "taskstore.h"
+
+#define COLDSTORE_INITIAL_CAPACITY 256
+
+
+/*
+coldStoreAlloc() - Hands out a zeroed cold record and returns its id
+ - Reuses ids of deleted tasks before growing the array
+ - Time: O(1) amortized, Space: O(1)
+ - Example: new_task->id = coldStoreAlloc(); -> COLDSTORE_NO_ID if out of memory
+ */
+unsigned int coldStoreAlloc(void) {
+    coldstore* cs = &currentStore->cold;
+    unsigned int id;
+
+    if (cs->free_count > 0) {
+        id = cs->free_ids[--cs->free_count];
+    } else {
+        if (cs->count == cs->capacity) {
+            unsigned int new_capacity = cs->capacity ? cs->capacity * 2 : COLDSTORE_INITIAL_CAPACITY;
+            // Reader threads may be on the old array; it is retired, not freed
+            taskcold* items = (taskcold*)epochResize(cs->items, cs->count * sizeof(taskcold),
+                                                     new_capacity * sizeof(taskcold));
+            if (!items) {
+                return COLDSTORE_NO_ID;
+            }
+            EPOCH_PUBLISH(cs->items, items);
+            cs->capacity = new_capacity;
+        }
+        id = cs->count++;
+    }
+
+    memset(&cs->items[id], 0, sizeof(taskcold));
+    cs->items[id].name = arenaEmpty();
+    cs->items[id].description = arenaEmpty();
+    cs->items[id].in_use = 1;
+    return id;
+}
+
+
+/*
+compactTextArena() - Copies every live name and description into a fresh arena block
+ - Runs when deleted and replaced strings make up half of the arena
+ - Each offset is rewritten with one store, and the old block stays
+   readable until reader threads are done with it
+ - Time: O(live bytes + ids), Space: O(live bytes)
+ */
+static void compactTextArena(void) {
+    stringarena* arena = &currentStore->arena;
+    coldstore* cs = &currentStore->cold;
+    if (!arenaCompactionBegin(arena->used - arena->dead)) {
+        return; // Keep the old arena; we will try again on the next delete
+    }
+
+    for (unsigned int id = 0; id < cs->count; id++) {
+        taskcold* cold = &cs->items[id];
+        if (!cold->in_use) continue;
+
+        arenastr* fields[2] = {&cold->name, &cold->description};
+        for (int f = 0; f < 2; f++) {
+            if (fields[f]->offset == ARENA_NO_OFFSET) continue;
+            __atomic_store_n(&fields[f]->offset, arenaMove(*fields[f]), __ATOMIC_RELAXED);
+        }
+    }
+    arenaCompactionEnd();
+}
+
+
+/*
+setColdText() - Stores new text for one field and releases the old text
+ - The field changes inside an odd text_version, so a reader thread never
+   pairs the new offset with the old length (see coldText())
+ - Time: O(length) amortized, Space: O(length)
+ - Returns 1 on success, 0 if the arena could not grow (field unchanged)
+ */
+static int setColdText(taskcold* cold, arenastr* field, const char* text, size_t length) {
+    arenastr stored;
+    if (!arenaStore(text, length, &stored)) {
+        return 0;
+    }
+    arenaRelease(*field);
+    __atomic_store_n(&cold->text_version, cold->text_version + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&field->offset, stored.offset, __ATOMIC_RELAXED);
+    __atomic_store_n(&field->length, stored.length, __ATOMIC_RELAXED);
+    __atomic_store_n(&cold->text_version, cold->text_version + 1, __ATOMIC_RELEASE);
+    if (arenaNeedsCompaction()) {
+        compactTextArena();
+    }
+    return 1;
+}
+
+
+/*
+coldText() - Reads a name or description field consistently on a reader thread
+ - Retries while the writer is replacing the field; the writer itself can
+   read the field directly
+ - Time: O(1) (a retry per concurrent change), Space: O(1)
+ - Example: arenastr name = coldText(cold, &cold->name); arenaString(name)
+ */
+arenastr coldText(const taskcold* cold, const arenastr* field) {
+    arenastr text;
+    unsigned int before, after;
+    do {
+        before = __atomic_load_n(&cold->text_version, __ATOMIC_ACQUIRE);
+        text.offset = __atomic_load_n(&field->offset, __ATOMIC_RELAXED);
+        text.length = __atomic_load_n(&field->length, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&cold->text_version, __ATOMIC_RELAXED);
+    } while ((before & 1) || before != after);
+    return text;
+}
+
+
+/*
+setTaskName() - Replaces the name of a task
+ - Time: O(length) amortized, Space: O(length)
+ - Example: setTaskName(t, "Study") -> taskName(t) is now "Study"
+ */
+int setTaskName(task* t, const char* name) {
+    return setColdText(taskCold(t), &taskCold(t)->name, name, strlen(name));
+}
+
+
+/*
+setTaskNameLength() - setTaskName() for a name given as bytes and a length
+ - Used by import to copy fields straight from the mapped file into the arena
+ - Time: O(length) amortized, Space: O(length)
+ */
+int setTaskNameLength(task* t, const char* name, size_t length) {
+    return setColdText(taskCold(t), &taskCold(t)->name, name, length);
+}
+
+
+/*
+setTaskDescription() - Replaces the description of a task
+ - Time: O(length) amortized, Space: O(length)
+ */
+int setTaskDescription(task* t, const char* description) {
+    return setColdText(taskCold(t), &taskCold(t)->description, description, strlen(description));
+}
+
+
+/*
+setTaskDescriptionLength() - setTaskDescription() for bytes and a length
+ - Time: O(length) amortized, Space: O(length)
+ */
+int setTaskDescriptionLength(task* t, const char* description, size_t length) {
+    return setColdText(taskCold(t), &taskCold(t)->description, description, length);
+}
+
+
+/*
+coldStoreFree() - Returns a task id to the store for reuse
+ - Releases the task's strings; compacts the arena when half of it is dead
+ - Time: O(1) amortized, Space: O(1)
+ - Example: coldStoreFree(t->id) -> the next coldStoreAlloc() may return it
+ */
+void coldStoreFree(unsigned int id) {
+    coldstore* cs = &currentStore->cold;
+    taskcold* cold = &cs->items[id];
+    free(cold->tag_ids);
+    free(cold->tag_slots);
+    cold->tag_ids = NULL;
+    cold->tag_slots = NULL;
+    cold->tag_count = cold->tag_capacity = 0;
+    arenaRelease(cold->name);
+    arenaRelease(cold->description);
+    cold->name = arenaEmpty();
+    cold->description = arenaEmpty();
+    cold->in_use = 0;
+    if (arenaNeedsCompaction()) {
+        compactTextArena();
+    }
+
+    if (cs->free_count == cs->free_capacity) {
+        unsigned int new_capacity = cs->free_capacity ? cs->free_capacity * 2 : COLDSTORE_INITIAL_CAPACITY;
+        unsigned int* ids = (unsigned int*)realloc(cs->free_ids, new_capacity * sizeof(unsigned int));
+        if (!ids) {
+            return; // The id is simply not reused
+        }
+        cs->free_ids = ids;
+        cs->free_capacity = new_capacity;
+    }
+    cs->free_ids[cs->free_count++] = id;
+}
+
+
+/*
+coldStoreReset() - Releases every cold record at once
+ - Time: O(ids) to free tag arrays, Space: O(1)
+ */
+void coldStoreReset(void) {
+    coldstore* cs = &currentStore->cold;
+    for (unsigned int id = 0; id < cs->count; id++) {
+        free(cs->items[id].tag_ids);
+        free(cs->items[id].tag_slots);
+    }
+    arenaReset();
+    free(cs->items);
+    free(cs->free_ids);
+    memset(cs, 0, sizeof(*cs));
+}
+
+
+/*
+taskCold() - Returns the cold (text) record of a task
+ - Time: O(1), Space: O(1)
+ - Example: taskCold(t)->tag_count -> number of tags on t
+ */
+taskcold* taskCold(const task* t) {
+    coldstore* cs = &currentStore->cold;
+    return &EPOCH_LOAD(cs->items)[t->id];
+}
+
+
+/*
+taskName() - Returns the name of a task
+ - Time: O(1), Space: O(1)
+ */
+const char* taskName(const task* t) {
+    taskcold* cold = taskCold(t);
+    return arenaString(coldText(cold, &cold->name));
+}
+
+
+/*
+taskDescription() - Returns the description of a task
+ - Time: O(1), Space: O(1)
+ */
+const char* taskDescription(const task* t) {
+    taskcold* cold = taskCold(t);
+    return arenaString(coldText(cold, &cold->description));
+}
+
+
+/*
+printColdStoreStats() - Prints hot/cold record sizes and store usage
+ - Time: O(1), Space: O(1)
+ - Sample Case:
+    Output:
+      --- Hot/Cold Task Records ---
+      Hot record: 48 bytes | Cold record: 64 bytes
+      Cold store: 150 in use, 2 free ids, 256 allocated
+ */
+void printColdStoreStats(void) {
+    coldstore* cs = &currentStore->cold;
+    printf("--- Hot/Cold Task Records ---\n");
+    printf("Hot record: %zu bytes | Cold record: %zu bytes\n", sizeof(task), sizeof(taskcold));
+    printf("Cold store: %u in use, %u free ids, %u allocated\n",
+           cs->count - cs->free_count, cs->free_count, cs->capacity);
+    printArenaStats();
+}
@@ -0,0 +1,47 @@
+#ifndef COLDSTORE_H
+#define COLDSTORE_H
+
+#include "scheduler.h"
+#include "stringarena.h"
+
+// Returned by coldStoreAlloc() when memory runs out
+#define COLDSTORE_NO_ID 0xFFFFFFFFu
+
+// Cold part of a task: text that is only read when a task is printed or edited.
+// Name and description are variable-length strings in the text arena;
+// tags are ids from the tag dictionary.
+typedef struct {
+    arenastr name;
+    arenastr description;
+    unsigned int* tag_ids;
+    unsigned int* tag_slots;    // position in each tag's posting list, see tagindex.h
+    int tag_count;
+    int tag_capacity;
+    int in_use;
+    unsigned int text_version;  // odd while name or description is being replaced
+} taskcold;
+
+// Growable array of cold records, addressed by task id
+typedef struct {
+    taskcold* items;
+    unsigned int count;         // ids handed out so far
+    unsigned int capacity;
+    unsigned int* free_ids;     // ids released by deleted tasks
+    unsigned int free_count;
+    unsigned int free_capacity;
+} coldstore;
+
+unsigned int coldStoreAlloc(void);
+void coldStoreFree(unsigned int id);
+void coldStoreReset(void);
+taskcold* taskCold(const task* t);
+arenastr coldText(const taskcold* cold, const arenastr* field);
+const char* taskName(const task* t);
+const char* taskDescription(const task* t);
+int setTaskName(task* t, const char* name);
+int setTaskDescription(task* t, const char* description);
+int setTaskNameLength(task* t, const char* name, size_t length);
+int setTaskDescriptionLength(task* t, const char* description, size_t length);
+void printColdStoreStats(void);
+
+#endif
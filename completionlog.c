@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "completionlog.h"
+#include "epoch.h"
+
+#define COMPLETION_LOG_INITIAL_CAPACITY 64
+
+// Stamps completions in the order they were made, across every log
+static unsigned int completionClock = 0;
+
+
+/*
+completionLogAppend() - Records a task as completed on a serial day
+ - A day earlier than the last entry (clock moved back by a simulated
+   day change) is recorded on the last entry's day, keeping the log sorted
+ - Each entry gets the next stamp of a clock shared by every log
+ - Time: O(1) amortized, Space: O(1) amortized
+ - Returns 1 on success, 0 if memory allocation failed
+ - Example: completionLogAppend(&doneLog, t, dateToDays(today))
+ */
+int completionLogAppend(completionlog* done, task* t, unsigned int day) {
+    if (done->count == done->capacity) {
+        int new_capacity = done->capacity ? done->capacity * 2 : COMPLETION_LOG_INITIAL_CAPACITY;
+        // Reader threads may be walking the old entries; they are retired, not freed
+        completion* entries = (completion*)epochResize(done->entries, done->count * sizeof(completion),
+                                                       new_capacity * sizeof(completion));
+        if (!entries) {
+            return 0;
+        }
+        EPOCH_PUBLISH(done->entries, entries);
+        done->capacity = new_capacity;
+    }
+
+    completionday* last = done->day_count ? &done->days[done->day_count - 1] : NULL;
+    if (last && day < last->day) {
+        day = last->day;
+    }
+    if (!last || day > last->day) {
+        if (done->day_count == done->day_capacity) {
+            int new_capacity = done->day_capacity ? done->day_capacity * 2 : COMPLETION_LOG_INITIAL_CAPACITY;
+            completionday* days = (completionday*)realloc(done->days, new_capacity * sizeof(completionday));
+            if (!days) {
+                return 0;
+            }
+            done->days = days;
+            done->day_capacity = new_capacity;
+        }
+        done->days[done->day_count].day = day;
+        done->days[done->day_count].first = done->count;
+        done->day_count++;
+    }
+
+    done->entries[done->count].task_data = t;
+    done->entries[done->count].day = day;
+    done->entries[done->count].stamp = __atomic_add_fetch(&completionClock, 1, __ATOMIC_RELAXED);
+    EPOCH_PUBLISH(done->count, done->count + 1);  // readers load count before entries
+    return 1;
+}
+
+
+/*
+completionLogPop() - Takes the most recent completion back off the log (undo)
+ - Time: O(1), Space: O(1)
+ - Returns the task, or NULL if the log is empty
+ */
+task* completionLogPop(completionlog* done) {
+    if (done->count == 0) {
+        return NULL;
+    }
+    done->count--;
+    if (done->days[done->day_count - 1].first == done->count) {
+        done->day_count--;
+    }
+    return done->entries[done->count].task_data;
+}
+
+
+/*
+completionLogUnpop() - Puts back the entry the last completionLogPop() took off
+ - Used when an undo cannot relink the task; the entry keeps its day and
+   stamp. Nothing may have been appended since the pop
+ - Time: O(1), Space: O(1)
+ */
+void completionLogUnpop(completionlog* done) {
+    completion* entry = &done->entries[done->count];
+    if (done->day_count == 0 || done->days[done->day_count - 1].day != entry->day) {
+        // The pop took the day's only entry; its slot in the day table is still free
+        done->days[done->day_count].day = entry->day;
+        done->days[done->day_count].first = done->count;
+        done->day_count++;
+    }
+    EPOCH_PUBLISH(done->count, done->count + 1);
+}
+
+
+/*
+completionLogFirstFrom() - Index of the first entry completed on or after a day
+ - Binary search over the day table
+ - Time: O(log days), Space: O(1)
+ - Sample Case:
+    Input: days = [{100, 0}, {103, 4}, {110, 6}], count = 9, day = 101
+    Output: 4 (entries 4..8 were completed on day 101 or later)
+ */
+int completionLogFirstFrom(completionlog* done, unsigned int day) {
+    int lo = 0, hi = done->day_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (done->days[mid].day < day) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < done->day_count ? done->days[lo].first : done->count;
+}
+
+
+/*
+completionLogCountRange() - Number of tasks completed between two days (inclusive)
+ - Time: O(log days), Space: O(1)
+ - Example: completionLogCountRange(&doneLog, today - 6, today) -> completed this week
+ */
+int completionLogCountRange(completionlog* done, unsigned int first_day, unsigned int last_day) {
+    if (first_day > last_day) {
+        return 0;
+    }
+    return completionLogFirstFrom(done, last_day + 1) - completionLogFirstFrom(done, first_day);
+}
+
+
+/*
+freeCompletionLog() - Frees the log arrays (the tasks are not freed)
+ - Time: O(1), Space: O(1)
+ */
+void freeCompletionLog(completionlog* done) {
+    free(done->entries);
+    free(done->days);
+    done->entries = NULL;
+    done->days = NULL;
+    done->count = done->capacity = 0;
+    done->day_count = done->day_capacity = 0;
+}
+
+
+/*
+printCompletionLogStats() - Prints log and day table sizes
+ - Time: O(1), Space: O(1)
+ - Sample Case:
+    Output:
+      --- Completion Log ---
+      Entries: 3 (capacity 64, 16 bytes each) | Days with completions: 1
+ */
+void printCompletionLogStats(completionlog* done) {
+    printf("--- Completion Log ---\n");
+    printf("Entries: %d (capacity %d, %zu bytes each) | Days with completions: %d\n",
+           done->count, done->capacity, sizeof(completion), done->day_count);
+}
@@ -0,0 +1,41 @@
+#ifndef COMPLETIONLOG_H
+#define COMPLETIONLOG_H
+
+#include "scheduler.h"
+
+// One completed task, the serial day it was completed on, and its place
+// among every completion of the process (the shards of a list compare
+// stamps to find the newest one)
+typedef struct {
+    task* task_data;
+    unsigned int day;
+    unsigned int stamp;
+} completion;
+
+// Offset of the first log entry of a day that has completions
+typedef struct {
+    unsigned int day;
+    int first;
+} completionday;
+
+// Append-only log of completed tasks, oldest first. Entries are kept in
+// day order, so the day table is sorted and any day range is found with a
+// binary search. Undo takes the last entry back off the log.
+typedef struct completionlog {
+    completion* entries;
+    int count;
+    int capacity;
+    completionday* days;
+    int day_count;
+    int day_capacity;
+} completionlog;
+
+int completionLogAppend(completionlog* done, task* t, unsigned int day);
+task* completionLogPop(completionlog* done);
+void completionLogUnpop(completionlog* done);
+int completionLogFirstFrom(completionlog* done, unsigned int day);
+int completionLogCountRange(completionlog* done, unsigned int first_day, unsigned int last_day);
+void freeCompletionLog(completionlog* done);
+void printCompletionLogStats(completionlog* done);
+
+#endif
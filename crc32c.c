@@ -0,0 +1,146 @@
+#include <string.h>
+#include "crc32c.h"
+
+#ifdef CRC32C_X86
+#include <immintrin.h>
+#endif
+
+#define CRC32C_POLY 0x82F63B78u   // Castagnoli polynomial, bit-reversed
+
+static crc32cfn crcKernel = NULL;
+static const char* kernelName = "scalar";
+static unsigned int crcTable[8][256];
+static int crcTableReady = 0;
+
+
+/*
+buildCrcTable() - Fills the slicing-by-8 tables (first scalar call only)
+ - crcTable[k][b] is the CRC of byte b followed by k zero bytes
+ - Time: O(8 · 256), Space: O(1) (8 KiB static)
+ */
+static void buildCrcTable(void) {
+    for (unsigned int b = 0; b < 256; b++) {
+        unsigned int crc = b;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        }
+        crcTable[0][b] = crc;
+    }
+    for (unsigned int b = 0; b < 256; b++) {
+        for (int k = 1; k < 8; k++) {
+            unsigned int prev = crcTable[k - 1][b];
+            crcTable[k][b] = (prev >> 8) ^ crcTable[0][prev & 0xFF];
+        }
+    }
+    crcTableReady = 1;
+}
+
+
+/*
+crc32cScalar() - Portable kernel: eight bytes per step through eight tables
+ - Time: O(length), Space: O(1)
+ - Example: crc32cScalar(0, "123456789", 9) -> 0xE3069283
+ */
+unsigned int crc32cScalar(unsigned int crc, const void* data, size_t length) {
+    if (!crcTableReady) {
+        buildCrcTable();
+    }
+    const unsigned char* p = (const unsigned char*)data;
+    crc = ~crc;
+    while (length >= 8) {
+        unsigned int low, high;
+        memcpy(&low, p, 4);
+        memcpy(&high, p + 4, 4);
+        low ^= crc;
+        crc = crcTable[7][low & 0xFF] ^ crcTable[6][(low >> 8) & 0xFF] ^
+              crcTable[5][(low >> 16) & 0xFF] ^ crcTable[4][low >> 24] ^
+              crcTable[3][high & 0xFF] ^ crcTable[2][(high >> 8) & 0xFF] ^
+              crcTable[1][(high >> 16) & 0xFF] ^ crcTable[0][high >> 24];
+        p += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = (crc >> 8) ^ crcTable[0][(crc ^ *p++) & 0xFF];
+    }
+    return ~crc;
+}
+
+
+#ifdef CRC32C_X86
+
+/*
+crc32cSSE42() - The crc32 instruction, eight bytes at a time
+ - Only called when cpuHasSSE42() is true
+ - Time: O(length / 8), Space: O(1)
+ */
+__attribute__((target("sse4.2")))
+unsigned int crc32cSSE42(unsigned int crc, const void* data, size_t length) {
+    const unsigned char* p = (const unsigned char*)data;
+    unsigned long long c = ~crc;
+    while (length >= 8) {
+        unsigned long long word;
+        memcpy(&word, p, 8);
+        c = _mm_crc32_u64(c, word);
+        p += 8;
+        length -= 8;
+    }
+    unsigned int c32 = (unsigned int)c;
+    while (length--) {
+        c32 = _mm_crc32_u8(c32, *p++);
+    }
+    return ~c32;
+}
+
+
+/*
+cpuHasSSE42() - Whether the running CPU supports SSE4.2
+ - Time: O(1), Space: O(1)
+ */
+int cpuHasSSE42(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+}
+
+#endif
+
+
+/*
+chooseKernel() - Picks the crc32 instruction when the CPU has it (first call only)
+ - Time: O(1), Space: O(1)
+ */
+static void chooseKernel(void) {
+#ifdef CRC32C_X86
+    if (cpuHasSSE42()) {
+        crcKernel = crc32cSSE42;
+        kernelName = "SSE4.2";
+        return;
+    }
+#endif
+    buildCrcTable();
+    crcKernel = crc32cScalar;
+}
+
+
+/*
+crc32c() - CRC-32C of data, continuing from crc (0 to start)
+ - Time: O(length), Space: O(1)
+ - Example: crc32c(crc32c(0, "1234", 4), "56789", 5) == crc32c(0, "123456789", 9)
+ */
+unsigned int crc32c(unsigned int crc, const void* data, size_t length) {
+    if (!crcKernel) {
+        chooseKernel();
+    }
+    return crcKernel(crc, data, length);
+}
+
+
+/*
+crc32cKernelName() - Name of the kernel crc32c() uses ("SSE4.2" or "scalar")
+ - Time: O(1), Space: O(1)
+ */
+const char* crc32cKernelName(void) {
+    if (!crcKernel) {
+        chooseKernel();
+    }
+    return kernelName;
+}
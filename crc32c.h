@@ -0,0 +1,24 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+
+// CRC-32C (Castagnoli), the checksum of every journal record. The SSE4.2
+// crc32 instruction computes exactly this polynomial; other CPUs use a
+// slicing-by-8 table. The kernel is picked once at run time from the CPU.
+
+typedef unsigned int (*crc32cfn)(unsigned int crc, const void* data, size_t length);
+
+unsigned int crc32c(unsigned int crc, const void* data, size_t length);
+const char* crc32cKernelName(void);
+
+// Individual kernels, for the benchmark
+unsigned int crc32cScalar(unsigned int crc, const void* data, size_t length);
+
+#if defined(__x86_64__)
+#define CRC32C_X86 1
+unsigned int crc32cSSE42(unsigned int crc, const void* data, size_t length);
+int cpuHasSSE42(void);
+#endif
+
+#endif
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "duetracker.h"
+#include "task_management.h"
+
+#define DUE_HEAP_INITIAL_CAPACITY 64
+
+
+static void heapPlace(dueheap* h, int which, int pos, task* t) {
+    h->items[pos] = t;
+    t->heap_slot[which] = pos + 1;
+}
+
+
+/*
+siftUp() - Moves the task at pos towards the root until its parent is due no later
+ - Time: O(log n), Space: O(1)
+ */
+static void siftUp(dueheap* h, int which, int pos) {
+    task* t = h->items[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (h->items[parent]->due <= t->due) {
+            break;
+        }
+        heapPlace(h, which, pos, h->items[parent]);
+        pos = parent;
+    }
+    heapPlace(h, which, pos, t);
+}
+
+
+/*
+siftDown() - Moves the task at pos towards the leaves until both children are due no earlier
+ - Time: O(log n), Space: O(1)
+ */
+static void siftDown(dueheap* h, int which, int pos) {
+    task* t = h->items[pos];
+    for (;;) {
+        int child = 2 * pos + 1;
+        if (child >= h->count) {
+            break;
+        }
+        if (child + 1 < h->count && h->items[child + 1]->due < h->items[child]->due) {
+            child++;
+        }
+        if (t->due <= h->items[child]->due) {
+            break;
+        }
+        heapPlace(h, which, pos, h->items[child]);
+        pos = child;
+    }
+    heapPlace(h, which, pos, t);
+}
+
+
+/*
+heapReserve() - Makes room for one more task in a heap
+ - Time: O(n) when the heap grows, O(1) otherwise; Space: O(1) amortized
+ - Returns 1 on success, 0 if memory allocation failed (heap unchanged)
+ */
+static int heapReserve(dueheap* h) {
+    if (h->count < h->capacity) {
+        return 1;
+    }
+    int new_capacity = h->capacity ? h->capacity * 2 : DUE_HEAP_INITIAL_CAPACITY;
+    task** items = (task**)realloc(h->items, new_capacity * sizeof(task*));
+    if (!items) {
+        return 0;
+    }
+    h->items = items;
+    h->capacity = new_capacity;
+    return 1;
+}
+
+
+/*
+heapPush() - Adds a task to one heap that has room for it (see heapReserve())
+ - Time: O(log n), Space: O(1)
+ */
+static void heapPush(dueheap* h, int which, task* t) {
+    h->items[h->count] = t;
+    siftUp(h, which, h->count++);
+}
+
+
+/*
+heapRemove() - Removes a task from one heap if it is there
+ - The last task moves into the freed position and is sifted either way
+ - Time: O(log n), Space: O(1)
+ */
+static void heapRemove(dueheap* h, int which, task* t) {
+    unsigned int slot = t->heap_slot[which];
+    if (slot == 0) {
+        return;
+    }
+    int pos = (int)slot - 1;
+    t->heap_slot[which] = 0;
+
+    task* last = h->items[--h->count];
+    if (pos == h->count) {
+        return;
+    }
+    h->items[pos] = last;
+    if (pos > 0 && h->items[(pos - 1) / 2]->due > last->due) {
+        siftUp(h, which, pos);
+    } else {
+        siftDown(h, which, pos);
+    }
+}
+
+
+/*
+dueTrackerReserve() - Makes room for one more task in both heaps
+ - Lets a caller that re-tracks a task check for memory before it changes
+   anything; the next dueTrackerInsert() then cannot fail
+ - Time: O(n) when a heap grows, O(1) otherwise; Space: O(1) amortized
+ - Returns 1 on success, 0 if memory allocation failed
+ */
+int dueTrackerReserve(duetracker* dt) {
+    return heapReserve(&dt->overdue) && heapReserve(&dt->urgent);
+}
+
+
+/*
+dueTrackerInsert() - Starts tracking a task and sets its status for the tracked day
+ - Completed and undated tasks are ignored
+ - The status is written directly, so the task must not be in the view
+   order index at this point (insert it there afterwards)
+ - Time: O(log n) amortized, Space: O(1) amortized
+ - Returns 1 on success, 0 if memory allocation failed (the task and the
+   heaps are unchanged)
+ - Example: dueTrackerInsert(&tasks.due, t) -> t is OVERDUE if its due day has passed
+ */
+int dueTrackerInsert(duetracker* dt, task* t) {
+    if (t->completed || !t->due_date_set) {
+        return 1;
+    }
+    if (!dueTrackerReserve(dt)) {
+        return 0;
+    }
+    if (t->due < dt->today) {
+        t->status = OVERDUE;
+    } else {
+        t->status = PENDING;
+        heapPush(&dt->overdue, DUE_HEAP_OVERDUE, t);
+    }
+    if (t->priority != 1) {
+        heapPush(&dt->urgent, DUE_HEAP_URGENT, t);
+    }
+    return 1;
+}
+
+
+/*
+dueTrackerRemove() - Stops tracking a task
+ - Time: O(log n), Space: O(1)
+ */
+void dueTrackerRemove(duetracker* dt, task* t) {
+    heapRemove(&dt->overdue, DUE_HEAP_OVERDUE, t);
+    heapRemove(&dt->urgent, DUE_HEAP_URGENT, t);
+}
+
+
+/*
+dueTrackerPopOverdue() - Takes the next task whose due day is before today
+ - The caller marks it OVERDUE; it stays out of the overdue heap
+ - Time: O(log n), Space: O(1)
+ - Example: while ((t = dueTrackerPopOverdue(dt, today))) setTaskStatus(list, t, OVERDUE);
+ */
+task* dueTrackerPopOverdue(duetracker* dt, unsigned int today) {
+    dueheap* h = &dt->overdue;
+    if (h->count == 0 || h->items[0]->due >= today) {
+        return NULL;
+    }
+    task* t = h->items[0];
+    heapRemove(h, DUE_HEAP_OVERDUE, t);
+    dt->made_overdue++;
+    return t;
+}
+
+
+/*
+dueTrackerPopUrgent() - Takes the next task below HIGH priority that is due
+   within DUE_URGENT_DAYS of today (or already overdue)
+ - Time: O(log n), Space: O(1)
+ */
+task* dueTrackerPopUrgent(duetracker* dt, unsigned int today) {
+    dueheap* h = &dt->urgent;
+    if (h->count == 0 || h->items[0]->due > today + DUE_URGENT_DAYS) {
+        return NULL;
+    }
+    task* t = h->items[0];
+    heapRemove(h, DUE_HEAP_URGENT, t);
+    dt->raised++;
+    return t;
+}
+
+
+/*
+freeDueTracker() - Frees both heaps; the tracked day is kept
+ - Time: O(1), Space: O(1)
+ */
+void freeDueTracker(duetracker* dt) {
+    free(dt->overdue.items);
+    free(dt->urgent.items);
+    dt->overdue.items = dt->urgent.items = NULL;
+    dt->overdue.count = dt->overdue.capacity = 0;
+    dt->urgent.count = dt->urgent.capacity = 0;
+}
+
+
+/*
+printDueTrackerStats() - Prints heap sizes and day-change counters
+ - Time: O(1), Space: O(1)
+ - Sample Case:
+    Output:
+      --- Due Tracker ---
+      Tracked day: 20/10/2026 | Waiting to become overdue: 12 | Waiting for priority raise: 9
+      Day advances: 2 (rewinds: 0) | Made overdue: 3 | Priorities raised: 4
+ */
+void printDueTrackerStats(duetracker* dt) {
+    date d = daysToDate((int)dt->today);
+    printf("--- Due Tracker ---\n");
+    printf("Tracked day: %02d/%02d/%04d | Waiting to become overdue: %d | Waiting for priority raise: %d\n",
+           d.day, d.month, d.year, dt->overdue.count, dt->urgent.count);
+    printf("Day advances: %ld (rewinds: %ld) | Made overdue: %ld | Priorities raised: %ld\n",
+           dt->advances, dt->rewinds, dt->made_overdue, dt->raised);
+}
@@ -0,0 +1,43 @@
+#ifndef DUETRACKER_H
+#define DUETRACKER_H
+
+#include "scheduler.h"
+
+#define DUE_HEAP_OVERDUE 0      // task->heap_slot[] entry of each heap
+#define DUE_HEAP_URGENT 1
+#define DUE_URGENT_DAYS 2       // "due soon" window of the priority raise
+
+// Min-heap of tasks keyed by due day. Positions are kept in
+// task->heap_slot[which] as index + 1, so 0 means "not in this heap".
+typedef struct {
+    task** items;
+    int count;
+    int capacity;
+} dueheap;
+
+// Dated, open tasks waiting for a date-driven change:
+//  - overdue: not yet OVERDUE, popped once due < today
+//  - urgent:  below HIGH priority, popped once due <= today + DUE_URGENT_DAYS
+// A task's due date, priority and completed flag must not change while it
+// is tracked: remove it, change the fields, then insert it again.
+typedef struct {
+    dueheap overdue;
+    dueheap urgent;
+    unsigned int today;         // serial day the statuses are correct for
+
+    // counters for the debug report
+    long advances;
+    long rewinds;
+    long made_overdue;
+    long raised;
+} duetracker;
+
+int dueTrackerReserve(duetracker* dt);
+int dueTrackerInsert(duetracker* dt, task* t);
+void dueTrackerRemove(duetracker* dt, task* t);
+task* dueTrackerPopOverdue(duetracker* dt, unsigned int today);
+task* dueTrackerPopUrgent(duetracker* dt, unsigned int today);
+void freeDueTracker(duetracker* dt);
+void printDueTrackerStats(duetracker* dt);
+
+#endif
@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include "epoch.h"
+#include "taskstore.h"
+
+epochstate epochState = {.global = 1};
+
+
+/*
+epochRegister() - Gives a reader thread its announcement slot
+ - Called before the reader threads start (writers must not run yet);
+   from then on retired memory waits for the readers
+ - Time: O(EPOCH_MAX_READERS), Space: O(1)
+ - Returns the slot, or -1 if all are taken
+ */
+int epochRegister(void) {
+    for (int i = 0; i < EPOCH_MAX_READERS; i++) {
+        if (!epochState.used[i]) {
+            epochState.used[i] = 1;
+            epochState.slots[i].active = 0;
+            epochState.slots[i].sections = 0;
+            epochState.readers++;
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+/*
+epochUnregister() - Gives a slot back once its thread has stopped
+ - When the last reader is gone, each store releases what it still has
+   retired on its next epochReclaim() (taskStoreClose() runs one)
+ - Time: O(1), Space: O(1)
+ */
+void epochUnregister(int slot) {
+    if (slot < 0 || !epochState.used[slot]) {
+        return;
+    }
+    epochState.used[slot] = 0;
+    epochState.slots[slot].active = 0;
+    epochState.readers--;
+}
+
+
+/*
+epochShared() - Whether reader threads may be walking the tasks right now
+ - Code that has a faster path over structures only the writer may walk
+   (the view order tree, the prev pointers) checks this first
+ - Time: O(1), Space: O(1)
+ */
+int epochShared(void) {
+    return epochState.readers > 0;
+}
+
+
+/*
+epochEnter() - Starts a read section on a reader thread
+ - Nothing retired from now on is released before the section ends
+ - Time: O(1), Space: O(1)
+ */
+void epochEnter(int slot) {
+    epochslot* s = &epochState.slots[slot];
+    __atomic_store_n(&s->active, __atomic_load_n(&epochState.global, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    // The announcement must be visible before anything shared is read
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    __atomic_store_n(&s->sections, s->sections + 1, __ATOMIC_RELAXED);
+}
+
+
+void epochExit(int slot) {
+    __atomic_store_n(&epochState.slots[slot].active, 0, __ATOMIC_RELEASE);
+}
+
+
+/*
+tryAdvance() - Moves the global epoch on if every active reader has seen it
+ - The writers of several stores may try at once; one of them moves it
+ - Time: O(EPOCH_MAX_READERS), Space: O(1)
+ - Returns 1 if it moved (whoever moved it)
+ */
+static int tryAdvance(void) {
+    unsigned long global = __atomic_load_n(&epochState.global, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (int i = 0; i < EPOCH_MAX_READERS; i++) {
+        unsigned long active = __atomic_load_n(&epochState.slots[i].active, __ATOMIC_ACQUIRE);
+        if (active != 0 && active != global) {
+            return 0;
+        }
+    }
+    if (__atomic_compare_exchange_n(&epochState.global, &global, global + 1, 0, __ATOMIC_RELEASE,
+                                    __ATOMIC_RELAXED)) {
+        __atomic_add_fetch(&epochState.advances, 1, __ATOMIC_RELAXED);
+    }
+    return 1;
+}
+
+
+/*
+releaseRetired() - Releases the current store's retired memory no reader can hold any more
+ - Memory retired in epoch e is safe once the global epoch reaches e + 2:
+   every reader active then entered after it was unlinked
+ - Time: O(released), Space: O(1)
+ */
+static void releaseRetired(void) {
+    epochlimbo* limbo = &currentStore->limbo;
+    unsigned long global = __atomic_load_n(&epochState.global, __ATOMIC_ACQUIRE);
+    while (limbo->oldest && (epochState.readers == 0 || limbo->oldest->epoch + 2 <= global)) {
+        epochretired* r = limbo->oldest;
+        limbo->oldest = r->next;
+        if (!limbo->oldest) {
+            limbo->newest = NULL;
+        }
+        limbo->pending--;
+        limbo->released++;
+        r->release(r->object);
+        slabFree(&limbo->records, r);
+    }
+}
+
+
+/*
+epochReclaim() - Advances the epoch if it can and releases what is safe (the store's writer only)
+ - Run after retirements and from the server's periodic tick
+ - Time: O(EPOCH_MAX_READERS + released), Space: O(1)
+ */
+void epochReclaim(void) {
+    if (epochState.readers > 0) {
+        tryAdvance();
+    }
+    releaseRetired();
+}
+
+
+/*
+epochRetire() - Releases memory once no reader can be looking at it (the store's writer only)
+ - object must already be unreachable for readers that start from now on
+ - Released at once while no reader thread is registered
+ - Time: O(1) amortized, Space: O(1) per retired object
+ - Example: epochRetire(t, releaseTask) after unlinking a deleted task
+ */
+void epochRetire(void* object, void (*release)(void* object)) {
+    if (epochState.readers == 0) {
+        release(object);
+        return;
+    }
+    epochlimbo* limbo = &currentStore->limbo;
+    epochretired* r = (epochretired*)slabAlloc(&limbo->records);
+    if (!r) {
+        // No record to wait with: wait here instead
+        epochSynchronize();
+        release(object);
+        return;
+    }
+    r->object = object;
+    r->release = release;
+    r->epoch = __atomic_load_n(&epochState.global, __ATOMIC_ACQUIRE);
+    r->next = NULL;
+    if (limbo->newest) {
+        limbo->newest->next = r;
+    } else {
+        limbo->oldest = r;
+    }
+    limbo->newest = r;
+    limbo->retired++;
+    if (++limbo->pending > limbo->peak_pending) {
+        limbo->peak_pending = limbo->pending;
+    }
+    if (limbo->pending % EPOCH_RECLAIM_EVERY == 0) {
+        epochReclaim();
+    }
+}
+
+
+static void releaseBlock(void* object) {
+    free(object);
+}
+
+
+/*
+epochResize() - realloc() for arrays that reader threads may be reading
+ - With readers registered the array is copied and the old one retired,
+   so a reader still holding it reads stale but valid memory
+ - Only the first old_bytes are copied; as realloc(), old stays valid on failure
+ - Time: O(old_bytes), Space: O(new_bytes)
+ - Example: items = epochResize(items, count * sizeof(*items), capacity * sizeof(*items))
+ */
+void* epochResize(void* old, size_t old_bytes, size_t new_bytes) {
+    if (epochState.readers == 0 || !old) {
+        return realloc(old, new_bytes);
+    }
+    void* grown = malloc(new_bytes);
+    if (!grown) {
+        return NULL;
+    }
+    memcpy(grown, old, old_bytes < new_bytes ? old_bytes : new_bytes);
+    epochRetire(old, releaseBlock);
+    return grown;
+}
+
+
+/*
+epochSynchronize() - Waits until every read section running now has ended (the store's writer only)
+ - For a writer about to reuse something readers may still be on, such
+   as an undone task going back into the list it was unlinked from.
+   Readers are never blocked; the writer yields until they move on
+ - Time: O(longest read section running), Space: O(1)
+ */
+void epochSynchronize(void) {
+    if (epochState.readers == 0) {
+        return;
+    }
+    currentStore->limbo.synchronizes++;
+    unsigned long target = __atomic_load_n(&epochState.global, __ATOMIC_ACQUIRE) + 2;
+    while (__atomic_load_n(&epochState.global, __ATOMIC_ACQUIRE) < target) {
+        if (!tryAdvance()) {
+            sched_yield();
+        }
+    }
+    releaseRetired();
+}
+
+
+/*
+epochReadSections() - Read sections run by all registered readers
+ - Time: O(EPOCH_MAX_READERS), Space: O(1)
+ */
+long epochReadSections(void) {
+    long sections = 0;
+    for (int i = 0; i < EPOCH_MAX_READERS; i++) {
+        if (epochState.used[i]) {
+            sections += __atomic_load_n(&epochState.slots[i].sections, __ATOMIC_RELAXED);
+        }
+    }
+    return sections;
+}
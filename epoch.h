@@ -0,0 +1,79 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <stddef.h>
+#include "slab.h"
+
+// Epoch-based reclamation, so reader threads can walk the tasks without
+// locks while one writer at a time changes them. A reader announces the
+// global epoch while it reads; the writer frees nothing a reader might
+// still hold: memory it retires (a deleted task, an array that grew, an
+// arena block a compaction left) is released once the global epoch has
+// moved on twice, which needs every reader to have left or re-entered.
+// Each store has one writer at a time and keeps what it retired in its
+// own limbo (see taskstore.h); the reader slots and the global epoch are
+// shared by every store, so one read section covers all of them and any
+// store's writer may move the epoch on. While no reader thread is
+// registered everything is released at once, as before.
+#define EPOCH_MAX_READERS 64
+#define EPOCH_RECLAIM_EVERY 64          // retirements between reclaim attempts
+
+// Loads and stores of pointers and counts that reader threads follow:
+// a writer fills in an object before publishing it, and a reader that
+// loads the published value sees the filled-in object
+#define EPOCH_LOAD(field) __atomic_load_n(&(field), __ATOMIC_ACQUIRE)
+#define EPOCH_PUBLISH(field, value) __atomic_store_n(&(field), (value), __ATOMIC_RELEASE)
+
+// One reader thread's announcement, alone on its cache line
+typedef struct {
+    unsigned long active;               // epoch entered, 0 outside a read section
+    long sections;                      // read sections run (only its thread writes it)
+} __attribute__((aligned(64))) epochslot;
+
+// Memory waiting for the readers that might still see it
+typedef struct epochretired {
+    void* object;
+    void (*release)(void* object);
+    unsigned long epoch;                // global epoch when it was retired
+    struct epochretired* next;
+} epochretired;
+
+// Memory one store's writer has retired, oldest first
+typedef struct {
+    epochretired* oldest;
+    epochretired* newest;
+    long pending;
+    slab records;                       // the epochretired records
+
+    // counters for the server summary
+    long retired;
+    long released;
+    long peak_pending;
+    long synchronizes;                  // writer waits for a grace period (undo)
+} epochlimbo;
+
+// Initializer for a store's limbo
+#define EPOCH_LIMBO_INIT {NULL, NULL, 0, SLAB_INIT("retired", epochretired, 256), 0, 0, 0, 0}
+
+typedef struct {
+    epochslot slots[EPOCH_MAX_READERS];
+    unsigned long global;               // starts at 1 (0 in a slot means quiescent)
+    unsigned char used[EPOCH_MAX_READERS];
+    int readers;                        // registered reader threads
+    long advances;
+} epochstate;
+
+extern epochstate epochState;
+
+int epochRegister(void);
+void epochUnregister(int slot);
+int epochShared(void);
+void epochEnter(int slot);
+void epochExit(int slot);
+void epochRetire(void* object, void (*release)(void* object));
+void* epochResize(void* old, size_t old_bytes, size_t new_bytes);
+void epochReclaim(void);
+void epochSynchronize(void);
+long epochReadSections(void);
+
+#endif
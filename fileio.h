@@ -1,9 +1,71 @@
 #ifndef FILEIO_H
 #define FILEIO_H
 
+#include <pthread.h>
 #include "task_management.h"
 
-void exportTasksTxt(task* head, completedstack* stack, const char* filename);
-void importTasks(tasklist *list, const char *filename);
+// Parallel import: the mapped file is cut into chunks of about this many
+// bytes (on line boundaries), each parsed by one worker
+#define IMPORT_CHUNK_BYTES (4u << 20)
+#define IMPORT_MAX_THREADS 64
+#define IMPORT_WINDOW_PER_THREAD 2      // chunks staged ahead of the merge, per thread
+#define IMPORT_STAGE_INITIAL_LINES 1024
+
+// Export rows are prefetched and written this many at a time
+#define EXPORT_BATCH 32
+
+// What the parser made of one line
+#define STAGED_SKIP 0                   // blank, short or "===" line: ignored silently
+#define STAGED_BAD 1                    // could not be parsed: merge prints a warning
+#define STAGED_OK 2
+
+// One parsed line waiting to be merged; text fields point into the file
+typedef struct {
+    const char* line;
+    const char* name;
+    const char* desc;
+    size_t length;                      // line length including its newline
+    size_t name_length;
+    size_t desc_length;
+    unsigned int name_hash;             // hashTaskNameLength() of the name
+    int priority;
+    int day, month, year;
+    unsigned char date_ok;
+    unsigned char state;
+} stagedline;
+
+// Duplicate names skipped by one import, reported as one summary line
+typedef struct {
+    unsigned int first_seq;             // seq of the first task the import links
+    long existing;                      // name was in the list before the import
+    long repeated;                      // name appeared earlier in the same file
+} importdups;
+
+// A run of whole lines and its staging buffer
+typedef struct {
+    const char* start;
+    const char* end;
+    stagedline* lines;
+    int count;
+    int capacity;
+    int failed;                         // staging buffer could not grow
+    int ready;                          // staged, guarded by importjob.lock
+} importchunk;
+
+// Shared state of one parallel import
+typedef struct {
+    importchunk* chunks;
+    int chunk_count;
+    int next_chunk;                     // next chunk to be staged
+    int merged;                         // chunks already merged into the list
+    int window;
+    pthread_mutex_t lock;
+    pthread_cond_t chunk_ready;
+    pthread_cond_t chunk_merged;
+} importjob;
+
+int exportTasksTxt(tasklist* list, completionlog* done, const char* filename);
+int exportTasks(tasklist* list, completionlog* done, const char* filename);
+int importTasks(tasklist *list, completionlog* done, const char *filename);
 
 #endif
@@ -0,0 +1,1048 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "journal.h"
+#include "crc32c.h"
+#include "taskstore.h"
+
+
+/*
+journalPath() - File the journal is kept in
+ - TODO_JOURNAL overrides JOURNAL_DEFAULT_FILE; setting it to an empty
+   string turns journaling off
+ - Time: O(1), Space: O(1)
+ - Returns the path, or NULL when journaling is off
+ */
+const char* journalPath(void) {
+    const char* path = getenv("TODO_JOURNAL");
+    if (!path) {
+        return JOURNAL_DEFAULT_FILE;
+    }
+    return path[0] ? path : NULL;
+}
+
+
+// A non-negative number from the environment, or fallback when unset or invalid
+static long journalSetting(const char* name, long fallback) {
+    const char* setting = getenv(name);
+    if (!setting || !setting[0]) {
+        return fallback;
+    }
+    char* end;
+    long value = strtol(setting, &end, 10);
+    return *end == '\0' && value >= 0 ? value : fallback;
+}
+
+
+static double journalSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+// Writes all bytes, retrying short writes; returns 0 with errno set on failure
+static int writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+
+// Empties the file and writes a header for generation (not synced)
+static int writeJournalHeader(int fd, unsigned long long generation) {
+    journalheader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, JOURNAL_MAGIC, sizeof(h.magic));
+    h.version = JOURNAL_VERSION;
+    h.byte_order = JOURNAL_BYTE_ORDER;
+    h.shard = (unsigned int)currentStore->shard;
+    h.shard_count = (unsigned int)currentStore->shard_count;
+    h.generation = generation;
+    return ftruncate(fd, 0) == 0 && writeAll(fd, (const char*)&h, sizeof(h));
+}
+
+
+// Appends bytes [start, end) of one file to another; returns 0 with errno set on failure
+static int copyJournalBytes(int from, int to, unsigned long long start, unsigned long long end) {
+    char chunk[64 << 10];
+    while (start < end) {
+        size_t want = end - start < sizeof(chunk) ? (size_t)(end - start) : sizeof(chunk);
+        ssize_t n = pread(from, chunk, want, (off_t)start);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n == 0) {
+                errno = EIO;
+            }
+            return 0;
+        }
+        if (!writeAll(to, chunk, (size_t)n)) {
+            return 0;
+        }
+        start += (unsigned long long)n;
+    }
+    return 1;
+}
+
+
+// Waits on j->wake until the monotonic time due (seconds); 0 once it has passed
+static int waitJournalUntil(journal* j, double due) {
+    struct timespec deadline;
+    deadline.tv_sec = (time_t)due;
+    deadline.tv_nsec = (long)((due - (double)deadline.tv_sec) * 1e9);
+    return pthread_cond_timedwait(&j->wake, &j->lock, &deadline) != ETIMEDOUT;
+}
+
+
+/*
+journalFlusher() - Writes and syncs the buffered records in groups
+ - A group is handed over JOURNAL_SYNC_MS after its first record, as soon
+   as it reaches JOURNAL_SYNC_BYTES, or at once when stop is set; the
+   write and fdatasync run without the lock, so appends go on into the
+   other buffer meanwhile
+ - After JOURNAL_IDLE_MS with an empty buffer the thread clears running,
+   detaches itself and exits; the next record starts a new one
+   (startJournalFlusher()). When stop is set journalClose() joins it
+ - Time: O(bytes written) per group, Space: O(1) (the buffers are swapped)
+ */
+static void* journalFlusher(void* arg) {
+    journal* j = (journal*)arg;
+    pthread_mutex_lock(&j->lock);
+    while (1) {
+        double idle_until = journalSeconds() + JOURNAL_IDLE_MS / 1000.0;
+        while (!j->stop &&
+               (j->used == 0 ||
+                (j->used < j->sync_bytes && journalSeconds() < j->first_unsynced + j->sync_ms / 1000.0))) {
+            if (j->used == 0) {
+                if (!waitJournalUntil(j, idle_until) && j->used == 0) {
+                    break;
+                }
+            } else {
+                waitJournalUntil(j, j->first_unsynced + j->sync_ms / 1000.0);
+            }
+        }
+        if (j->used == 0) {
+            if (j->stop) {
+                break;
+            }
+            if (journalSeconds() >= idle_until) {
+                j->running = 0;
+                pthread_detach(pthread_self());
+                break;
+            }
+            continue;
+        }
+
+        char* data = j->buffer;
+        size_t size = j->used;
+        size_t data_capacity = j->capacity;
+        long group = j->group_records;
+        j->buffer = j->spare;
+        j->capacity = j->spare_capacity;
+        j->spare = data;
+        j->spare_capacity = data_capacity;
+        j->used = 0;
+        j->group_records = 0;
+        j->writing = 1;
+        pthread_cond_broadcast(&j->drained);
+        pthread_mutex_unlock(&j->lock);
+
+        double start = journalSeconds();
+        int error = 0;
+        if (!j->error) {
+            if (!writeAll(j->fd, data, size) || fdatasync(j->fd) != 0) {
+                error = errno;
+            }
+        }
+        double took = journalSeconds() - start;
+
+        pthread_mutex_lock(&j->lock);
+        j->writing = 0;
+        if (error) {
+            j->error = error;
+        } else {
+            j->file_end += size;
+            j->syncs++;
+            j->sync_seconds += took;
+            if (took > j->longest_sync) {
+                j->longest_sync = took;
+            }
+            if (group > j->largest_group) {
+                j->largest_group = group;
+            }
+        }
+        pthread_cond_broadcast(&j->drained);
+    }
+    pthread_mutex_unlock(&j->lock);
+    return NULL;
+}
+
+
+/*
+startJournalFlusher() - Starts the flusher for records just appended (lock held)
+ - Time: O(1) plus thread creation, Space: O(thread stack)
+ - Returns 1 on success, 0 (j->error is set) if the thread could not be started
+ */
+static int startJournalFlusher(journal* j) {
+    int error = pthread_create(&j->flusher, NULL, journalFlusher, j);
+    if (error != 0) {
+        j->error = error;
+        return 0;
+    }
+    j->running = 1;
+    j->flusher_starts++;
+    return 1;
+}
+
+
+// Room for bytes more in the fill buffer; 0 if memory ran out
+static int reserveJournal(journal* j, size_t bytes) {
+    if (j->used + bytes <= j->capacity) {
+        return 1;
+    }
+    size_t new_capacity = j->capacity ? j->capacity : 4096;
+    while (new_capacity < j->used + bytes) {
+        new_capacity *= 2;
+    }
+    char* grown = (char*)realloc(j->buffer, new_capacity);
+    if (!grown) {
+        return 0;
+    }
+    j->buffer = grown;
+    j->capacity = new_capacity;
+    return 1;
+}
+
+
+static journalfield textField(const char* text, size_t length) {
+    journalfield f = {text, length, 0};
+    return f;
+}
+
+
+static journalfield wordField(unsigned int word) {
+    journalfield f = {NULL, 0, word};
+    return f;
+}
+
+
+static journalfield nameField(const task* t) {
+    return textField(taskName(t), taskCold(t)->name.length);
+}
+
+
+/*
+appendRecord() - Adds one record to the buffer for the flusher
+ - Only copies into memory; blocks only when JOURNAL_BUFFER_LIMIT bytes are
+   already waiting for the disk
+ - Between journalHold() and journalRelease() the lock is already held
+   and the flusher is woken once, on release
+ - Time: O(record length), Space: O(record length)
+ */
+static void appendRecord(unsigned int type, const journalfield* fields, int count) {
+    journal* j = &currentStore->journal;
+    if (j->fd < 0) {
+        return;
+    }
+
+    size_t length = sizeof(unsigned int);
+    for (int i = 0; i < count; i++) {
+        length += fields[i].text ? sizeof(unsigned int) + fields[i].length + 1 : sizeof(unsigned int);
+    }
+
+    if (!j->held) {
+        pthread_mutex_lock(&j->lock);
+    }
+    while (j->used >= JOURNAL_BUFFER_LIMIT && !j->error) {
+        if (j->wake_pending) {
+            j->wake_pending = 0;
+            pthread_cond_signal(&j->wake);
+        }
+        pthread_cond_wait(&j->drained, &j->lock);
+    }
+    if (j->error) {
+        if (!j->error_reported) {
+            printf("Warning: Writing journal %s failed (%s); changes are no longer journaled.\n",
+                   j->filename, strerror(j->error));
+            j->error_reported = 1;
+        }
+        if (!j->held) {
+            pthread_mutex_unlock(&j->lock);
+        }
+        return;
+    }
+    if (length > 0xFFFFFFFFu - sizeof(journalrecord) ||
+        !reserveJournal(j, sizeof(journalrecord) + length)) {
+        if (!j->held) {
+            pthread_mutex_unlock(&j->lock);
+        }
+        printf("Warning: Memory ran out; a change could not be journaled.\n");
+        return;
+    }
+
+    char* start = j->buffer + j->used;
+    char* p = start + sizeof(journalrecord);
+    memcpy(p, &type, sizeof(type));
+    p += sizeof(type);
+    for (int i = 0; i < count; i++) {
+        if (!fields[i].text) {
+            memcpy(p, &fields[i].word, sizeof(unsigned int));
+            p += sizeof(unsigned int);
+            continue;
+        }
+        unsigned int text_length = (unsigned int)fields[i].length;
+        memcpy(p, &text_length, sizeof(text_length));
+        p += sizeof(text_length);
+        memcpy(p, fields[i].text, fields[i].length);
+        p += fields[i].length;
+        *p++ = '\0';
+    }
+    journalrecord rec;
+    rec.length = (unsigned int)length;
+    memcpy(start + sizeof(rec.crc), &rec.length, sizeof(rec.length));
+    rec.crc = crc32c(0, start + sizeof(rec.crc), sizeof(rec.length) + length);
+    memcpy(start, &rec.crc, sizeof(rec.crc));
+
+    int was_empty = j->used == 0;
+    if (was_empty) {
+        j->first_unsynced = journalSeconds();
+    }
+    j->used += sizeof(journalrecord) + length;
+    j->end_offset += sizeof(journalrecord) + length;
+    j->end_records++;
+    j->records++;
+    j->group_records++;
+    j->bytes += sizeof(journalrecord) + length;
+    if (!j->running) {
+        startJournalFlusher(j);
+    } else if (was_empty || j->used >= j->sync_bytes) {
+        if (j->held) {
+            j->wake_pending = 1;
+        } else {
+            pthread_cond_signal(&j->wake);
+        }
+    }
+    if (!j->held) {
+        pthread_mutex_unlock(&j->lock);
+    }
+}
+
+
+/*
+journalTask() - Journals a task added with all of its fields
+ - day is the completion day for a task that went straight to the
+   completion log (import), or JOURNAL_NO_DAY for a pending task
+ - Time: O(text length + tags), Space: O(tags)
+ */
+void journalTask(const task* t, unsigned int day) {
+    if (currentStore->journal.fd < 0) {
+        return;
+    }
+    taskcold* cold = taskCold(t);
+    journalfield few[16];
+    int count = 7 + cold->tag_count;
+    journalfield* fields = count <= 16 ? few : (journalfield*)malloc(count * sizeof(journalfield));
+    if (!fields) {
+        printf("Warning: Memory ran out; a change could not be journaled.\n");
+        return;
+    }
+    fields[0] = nameField(t);
+    fields[1] = textField(taskDescription(t), cold->description.length);
+    fields[2] = wordField(t->priority);
+    fields[3] = wordField(t->due_date_set);
+    fields[4] = wordField(t->due);
+    fields[5] = wordField(day);
+    fields[6] = wordField((unsigned int)cold->tag_count);
+    for (int i = 0; i < cold->tag_count; i++) {
+        const char* tag = tagName(cold->tag_ids[i]);
+        fields[7 + i] = textField(tag, strlen(tag));
+    }
+    appendRecord(JOURNAL_TASK, fields, count);
+    if (fields != few) {
+        free(fields);
+    }
+}
+
+
+/*
+journalImported() - Journals every task an import added
+ - Pending tasks are the ones linked since first_seq, journaled oldest
+   first; completed ones are the log entries from first_completed on
+ - Time: O(imported tasks + their text), Space: O(1)
+ */
+void journalImported(tasklist* list, completionlog* done, unsigned int first_seq, int first_completed) {
+    if (currentStore->journal.fd < 0) {
+        return;
+    }
+    task* oldest = NULL;
+    for (task* t = list->head; t && t->seq >= first_seq; t = t->next) {
+        oldest = t;
+    }
+    for (task* t = oldest; t; t = t->prev) {
+        journalTask(t, JOURNAL_NO_DAY);
+    }
+    for (int i = first_completed; i < done->count; i++) {
+        journalTask(done->entries[i].task_data, done->entries[i].day);
+    }
+}
+
+
+void journalRename(const char* old_name, const char* new_name) {
+    journalfield fields[2] = {textField(old_name, strlen(old_name)), textField(new_name, strlen(new_name))};
+    appendRecord(JOURNAL_RENAME, fields, 2);
+}
+
+
+void journalDescribe(const task* t) {
+    journalfield fields[2] = {nameField(t), textField(taskDescription(t), taskCold(t)->description.length)};
+    appendRecord(JOURNAL_DESCRIBE, fields, 2);
+}
+
+
+void journalPriority(const task* t) {
+    journalfield fields[2] = {nameField(t), wordField(t->priority)};
+    appendRecord(JOURNAL_PRIORITY, fields, 2);
+}
+
+
+void journalDue(const task* t) {
+    journalfield fields[3] = {nameField(t), wordField(t->due_date_set), wordField(t->due)};
+    appendRecord(JOURNAL_DUE, fields, 3);
+}
+
+
+void journalComplete(const task* t, unsigned int day) {
+    journalfield fields[2] = {nameField(t), wordField(day)};
+    appendRecord(JOURNAL_COMPLETE, fields, 2);
+}
+
+
+void journalUndo(void) {
+    appendRecord(JOURNAL_UNDO, NULL, 0);
+}
+
+
+void journalDelete(const task* t) {
+    journalfield fields[1] = {nameField(t)};
+    appendRecord(JOURNAL_DELETE, fields, 1);
+}
+
+
+void journalTag(const task* t, unsigned int tag_id) {
+    const char* tag = tagName(tag_id);
+    journalfield fields[2] = {nameField(t), textField(tag, strlen(tag))};
+    appendRecord(JOURNAL_TAG, fields, 2);
+}
+
+
+void journalRetag(const task* t, int index, unsigned int tag_id) {
+    const char* tag = tagName(tag_id);
+    journalfield fields[3] = {nameField(t), wordField((unsigned int)index), textField(tag, strlen(tag))};
+    appendRecord(JOURNAL_RETAG, fields, 3);
+}
+
+
+void journalClear(void) {
+    appendRecord(JOURNAL_CLEAR, NULL, 0);
+}
+
+
+static unsigned int readWord(journalreader* r) {
+    unsigned int word = 0;
+    if (!r->ok || (size_t)(r->end - r->p) < sizeof(word)) {
+        r->ok = 0;
+        return 0;
+    }
+    memcpy(&word, r->p, sizeof(word));
+    r->p += sizeof(word);
+    return word;
+}
+
+
+// A text field; points into the mapped journal and is NUL-terminated
+static const char* readText(journalreader* r, size_t* length) {
+    unsigned int n = readWord(r);
+    if (!r->ok || (size_t)(r->end - r->p) <= n || r->p[n] != '\0') {
+        r->ok = 0;
+        *length = 0;
+        return "";
+    }
+    const char* text = r->p;
+    r->p += n + 1;
+    *length = n;
+    return text;
+}
+
+
+/*
+replayTask() - Rebuilds a task from a JOURNAL_TASK record
+ - Same steps as restoring a task file record: pending tasks are linked
+   (unless the name is taken), completed ones appended to the log
+ - Time: O(text length + tags) average, Space: O(text length)
+ - Returns 1 if the task was added, 0 if the record was skipped
+ */
+static int replayTask(tasklist* list, completionlog* done, journalreader* r) {
+    size_t name_length, description_length;
+    const char* name = readText(r, &name_length);
+    const char* description = readText(r, &description_length);
+    unsigned int priority = readWord(r);
+    unsigned int due_date_set = readWord(r);
+    unsigned int due = readWord(r);
+    unsigned int day = readWord(r);
+    unsigned int tag_count = readWord(r);
+    if (!r->ok || name_length == 0 ||
+        (day == JOURNAL_NO_DAY && nameIndexFindLength(&list->names, name, name_length))) {
+        return 0;
+    }
+
+    task* t = newTask();
+    if (!t) {
+        return 0;
+    }
+    if (!setTaskNameLength(t, name, name_length) ||
+        !setTaskDescriptionLength(t, description, description_length)) {
+        destroyTask(t);
+        return 0;
+    }
+    t->priority = priority >= 1 && priority <= 3 ? priority : 2;
+    t->due = due;
+    t->due_date_set = due_date_set ? 1 : 0;
+    for (unsigned int i = 0; i < tag_count; i++) {
+        size_t tag_length;
+        const char* tag = readText(r, &tag_length);
+        unsigned int id = r->ok ? tagIntern(tag) : TAG_NO_ID;
+        if (id == TAG_NO_ID || (!taskHasTag(t, id) && !taskAddTag(t, id))) {
+            destroyTask(t);
+            return 0;
+        }
+    }
+
+    if (day == JOURNAL_NO_DAY) {
+        t->completed = 0;
+        t->status = PENDING;
+        if (!linkTask(list, t)) {
+            destroyTask(t);
+            return 0;
+        }
+        return 1;
+    }
+    if (!completionLogAppend(done, t, day)) {
+        destroyTask(t);
+        return 0;
+    }
+    t->status = COMPLETED;
+    t->completed = 1;
+    t->seq = (unsigned int)(done->count - 1);
+    textIndexTask(t);
+    return 1;
+}
+
+
+/*
+replayRecord() - Applies one record through the same functions the menu uses
+ - Journaling is not open yet, so nothing is journaled again
+ - Time: O(record length) average (O(log n) for index updates), Space: O(1)
+ - Returns 1 if it applied, 0 if it did not fit the tasks (skipped)
+ */
+static int replayRecord(tasklist* list, completionlog* done, const char* fields, size_t length) {
+    journalreader r = {fields, fields + length, 1};
+    unsigned int type = readWord(&r);
+    if (type == JOURNAL_TASK) {
+        return replayTask(list, done, &r);
+    }
+    if (type == JOURNAL_UNDO) {
+        return undoCompleteTask(list, done) != NULL;
+    }
+    if (type == JOURNAL_CLEAR) {
+        freeCompleted(done);
+        return 1;
+    }
+
+    // Every other record names a pending task first
+    size_t name_length;
+    const char* name = readText(&r, &name_length);
+    task* t = r.ok ? nameIndexFindLength(&list->names, name, name_length) : NULL;
+    if (!t) {
+        return 0;
+    }
+    size_t text_length;
+    const char* text;
+    unsigned int word, id;
+    switch (type) {
+        case JOURNAL_RENAME:
+            text = readText(&r, &text_length);
+            return r.ok && text_length > 0 && !nameIndexFindLength(&list->names, text, text_length) &&
+                   renameTask(list, t, text);
+        case JOURNAL_DESCRIBE:
+            text = readText(&r, &text_length);
+            return r.ok && describeTask(t, text);
+        case JOURNAL_PRIORITY:
+            word = readWord(&r);
+            if (!r.ok || word < 1 || word > 3) {
+                return 0;
+            }
+            return setTaskPriority(list, t, (int)word);
+        case JOURNAL_DUE: {
+            unsigned int due_date_set = readWord(&r);
+            word = readWord(&r);
+            if (!r.ok) {
+                return 0;
+            }
+            date due = daysToDate((int)word);
+            return setTaskDue(list, t, due_date_set ? &due : NULL);
+        }
+        case JOURNAL_COMPLETE:
+            word = readWord(&r);
+            return r.ok && completeTask(list, done, t, daysToDate((int)word));
+        case JOURNAL_DELETE:
+            removeTask(list, t);
+            return 1;
+        case JOURNAL_TAG:
+            text = readText(&r, &text_length);
+            id = r.ok ? tagIntern(text) : TAG_NO_ID;
+            return id != TAG_NO_ID && !taskHasTag(t, id) && listAddTag(list, t, id);
+        case JOURNAL_RETAG:
+            word = readWord(&r);
+            text = readText(&r, &text_length);
+            id = r.ok ? tagIntern(text) : TAG_NO_ID;
+            if (id == TAG_NO_ID || word >= (unsigned int)taskCold(t)->tag_count || taskHasTag(t, id)) {
+                return 0;
+            }
+            listReplaceTag(list, t, (int)word, id);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+
+/*
+replayJournal() - Applies every intact record from offset from on
+ - Stops at the first record that is cut short or fails its CRC: that is
+   where the last write before a crash ended
+ - Time: O(file size) plus the work of each change, Space: O(1)
+ - Returns the offset just past the last intact record
+ */
+static size_t replayJournal(journal* j, tasklist* list, completionlog* done, const char* data, size_t size,
+                            size_t from) {
+    size_t offset = from;
+    while (size - offset >= sizeof(journalrecord)) {
+        journalrecord rec;
+        memcpy(&rec, data + offset, sizeof(rec));
+        if (rec.length < sizeof(unsigned int) || rec.length > size - offset - sizeof(rec) ||
+            crc32c(0, data + offset + sizeof(rec.crc), sizeof(rec.length) + rec.length) != rec.crc) {
+            break;
+        }
+        if (replayRecord(list, done, data + offset + sizeof(rec), rec.length)) {
+            j->replayed++;
+        } else {
+            j->replay_skipped++;
+        }
+        offset += sizeof(rec) + rec.length;
+    }
+    return offset;
+}
+
+
+// Whether the file starts with a header this build can read
+static int journalHeaderValid(const journalheader* h) {
+    return memcmp(h->magic, JOURNAL_MAGIC, sizeof(h->magic)) == 0 &&
+           h->version == JOURNAL_VERSION && h->byte_order == JOURNAL_BYTE_ORDER;
+}
+
+
+/*
+journalShardOf() - Which shard of its list a journal file journals, from its header
+ - Time: O(1), Space: O(1)
+ - Returns 1 and sets *shard and *shard_count if filename is a journal this
+   version can read, 0 otherwise (missing, empty or foreign)
+ */
+int journalShardOf(const char* filename, int* shard, int* shard_count) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    journalheader h;
+    int ok = pread(fd, &h, sizeof(h), 0) == (ssize_t)sizeof(h) && journalHeaderValid(&h);
+    close(fd);
+    if (ok) {
+        *shard = (int)h.shard;
+        *shard_count = (int)h.shard_count;
+    }
+    return ok;
+}
+
+
+/*
+setJournalAside() - Renames an unusable journal to filename.old and opens a new one
+ - Time: O(1), Space: O(filename)
+ - Returns the new file descriptor, or -1
+ */
+static int setJournalAside(int fd, const char* filename) {
+    size_t old_length = strlen(filename) + 5;
+    char* old = (char*)malloc(old_length);
+    close(fd);
+    if (!old) {
+        return -1;
+    }
+    snprintf(old, old_length, "%s.old", filename);
+    int moved = rename(filename, old) == 0;
+    free(old);
+    if (!moved) {
+        return -1;
+    }
+    return open(filename, O_RDWR | O_CREAT | O_APPEND, 0644);
+}
+
+
+/*
+journalOpen() - Replays the journal on top of the restored tasks and opens it for appending
+ - generation and offset are the journal position the snapshot was saved
+   at (0 and 0 without one). A journal of that generation is replayed from
+   offset and one of the next generation from its start; an older one, or
+   one that ends before offset, only holds changes the snapshot already has
+   and is restarted as the next generation; a newer or unreadable one is
+   moved to filename.old. The group commit thread is started by the
+   first record appended afterwards.
+ - May run on the snapshot loader thread; what happened is printed by
+   journalReport() on the main thread
+ - Time: O(journal size) plus the replayed changes, Space: O(1) (the file is mapped)
+ - Returns 1 if journaling is on
+ */
+int journalOpen(tasklist* list, completionlog* done, const char* filename, unsigned long long generation,
+                unsigned long long offset) {
+    journal* j = &currentStore->journal;
+    if (!filename || j->fd >= 0) {
+        return 0;
+    }
+    double start = journalSeconds();
+    j->filename = filename;
+    int fd = open(filename, O_RDWR | O_CREAT | O_APPEND, 0644);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        j->problem = "could not be opened";
+        if (fd >= 0) {
+            close(fd);
+        }
+        return 0;
+    }
+
+    int fresh = info.st_size == 0;
+    size_t from = sizeof(journalheader);
+    journalheader h;
+    if (!fresh) {
+        if ((size_t)info.st_size < sizeof(h) || pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) ||
+            !journalHeaderValid(&h)) {
+            j->problem = "is not a journal this version can read";
+        } else if (h.generation > generation + 1) {
+            j->problem = "does not continue the snapshot";
+        }
+        if (j->problem) {
+            fd = setJournalAside(fd, filename);
+            fresh = 1;
+        } else if (h.generation < generation ||
+                   (h.generation == generation && offset >= (unsigned long long)info.st_size)) {
+            fresh = 1;  // the snapshot already holds all of its changes
+        } else if (h.generation == generation && offset > from) {
+            from = (size_t)offset;
+        }
+    }
+
+    if (fd >= 0 && !fresh) {
+        void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            j->problem = "could not be read";
+            close(fd);
+            return 0;
+        }
+        madvise(data, info.st_size, MADV_SEQUENTIAL);
+        size_t valid = replayJournal(j, list, done, (const char*)data, info.st_size, from);
+        munmap(data, info.st_size);
+        if (valid < (size_t)info.st_size) {
+            j->torn_bytes = (size_t)info.st_size - valid;
+            if (ftruncate(fd, valid) != 0) {
+                j->problem = "could not be repaired";
+                close(fd);
+                return 0;
+            }
+        }
+        j->generation = h.generation;
+        j->file_end = j->end_offset = valid;
+        j->end_records = j->replayed + j->replay_skipped;
+    } else if (fd >= 0) {
+        if (!writeJournalHeader(fd, generation + 1) || fdatasync(fd) != 0) {
+            j->problem = "could not be written";
+            close(fd);
+            return 0;
+        }
+        j->generation = generation + 1;
+        j->file_end = j->end_offset = sizeof(journalheader);
+    }
+    if (fd < 0) {
+        return 0;
+    }
+    j->replay_seconds = journalSeconds() - start;
+
+    j->sync_ms = journalSetting("TODO_JOURNAL_SYNC_MS", JOURNAL_SYNC_MS);
+    j->sync_bytes = (size_t)journalSetting("TODO_JOURNAL_SYNC_BYTES", JOURNAL_SYNC_BYTES);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&j->lock, NULL);
+    pthread_cond_init(&j->wake, &attr);
+    pthread_cond_init(&j->drained, NULL);
+    pthread_condattr_destroy(&attr);
+    j->fd = fd;
+    return 1;
+}
+
+
+/*
+journalReport() - Prints what journalOpen() replayed or had to repair (once)
+ - Called before every menu action; returns at once after the first time
+ - Time: O(1), Space: O(1)
+ */
+void journalReport(void) {
+    journal* j = &currentStore->journal;
+    if (j->reported) {
+        return;
+    }
+    j->reported = 1;
+    if (j->problem) {
+        if (j->fd >= 0) {
+            printf("Warning: Journal %s %s; it was moved to %s.old.\n", j->filename, j->problem, j->filename);
+        } else {
+            printf("Warning: Journal %s %s; changes will not be journaled.\n", j->filename, j->problem);
+        }
+    }
+    if (j->replayed || j->replay_skipped) {
+        printf("Replayed %ld journaled change(s) from %s in %.3f s\n", j->replayed, j->filename,
+               j->replay_seconds);
+    }
+    if (j->replay_skipped) {
+        printf("Warning: %ld journaled change(s) did not match the tasks and were skipped.\n",
+               j->replay_skipped);
+    }
+    if (j->torn_bytes) {
+        printf("Warning: Dropped %zu bytes at the end of the journal that were cut short or damaged.\n",
+               j->torn_bytes);
+    }
+}
+
+
+/*
+journalEnabled() - Whether changes are currently being journaled
+ - Time: O(1), Space: O(1)
+ */
+int journalEnabled(void) {
+    return currentStore->journal.fd >= 0 && !currentStore->journal.error;
+}
+
+
+/*
+journalMark() - The current end of the journal, for a snapshot about to be taken
+ - Every change made so far is before the mark, written or still buffered
+ - Time: O(1), Space: O(1)
+ - Returns a zero mark while journaling is off
+ */
+journalmark journalMark(void) {
+    journal* j = &currentStore->journal;
+    journalmark mark = {0, 0, 0, 0};
+    if (j->fd < 0) {
+        return mark;
+    }
+    pthread_mutex_lock(&j->lock);
+    mark.generation = j->generation;
+    mark.offset = j->end_offset;
+    mark.bytes = j->end_offset - sizeof(journalheader);
+    mark.records = j->end_records;
+    pthread_mutex_unlock(&j->lock);
+    return mark;
+}
+
+
+/*
+journalCompact() - Drops the records before mark once a snapshot taken at mark is saved
+ - The records after the mark are copied behind a header of the next
+   generation into filename.tmp, which is synced and renamed over the
+   journal, so a crash leaves either file and each continues the snapshot
+ - Records still buffered before the mark are dropped; a write in
+   progress is waited for, later appends go to the new file
+ - Time: O(bytes after the mark) plus one sync, Space: O(1)
+ - Returns 1 on success, 0 if the journal was kept as it was
+ - Example: snapshotSave(..., mark.generation, mark.offset) succeeded -> journalCompact(mark)
+ */
+int journalCompact(journalmark mark) {
+    journal* j = &currentStore->journal;
+    if (j->fd < 0) {
+        return 0;
+    }
+    size_t tmp_length = strlen(j->filename) + 5;
+    char* tmp = (char*)malloc(tmp_length);
+    if (!tmp) {
+        printf("Memory allocation failed while compacting the journal.\n");
+        return 0;
+    }
+    snprintf(tmp, tmp_length, "%s.tmp", j->filename);
+
+    double start = journalSeconds();
+    pthread_mutex_lock(&j->lock);
+    while (j->writing) {
+        pthread_cond_wait(&j->drained, &j->lock);
+    }
+    if (j->error || mark.generation != j->generation || mark.offset > j->end_offset ||
+        mark.offset < sizeof(journalheader)) {
+        pthread_mutex_unlock(&j->lock);
+        free(tmp);
+        return 0;  // not a mark of this file
+    }
+    int fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    int ok = fd >= 0 && writeJournalHeader(fd, mark.generation + 1) &&
+             copyJournalBytes(j->fd, fd, mark.offset, j->file_end) && fdatasync(fd) == 0 &&
+             rename(tmp, j->filename) == 0;
+    int error = errno;
+    if (ok) {
+        unsigned long long kept = j->file_end > mark.offset ? j->file_end - mark.offset : 0;
+        if (mark.offset > j->file_end) {
+            size_t dropped = (size_t)(mark.offset - j->file_end);
+            memmove(j->buffer, j->buffer + dropped, j->used - dropped);
+            j->used -= dropped;
+        }
+        close(j->fd);
+        j->fd = fd;
+        j->generation = mark.generation + 1;
+        j->file_end = sizeof(journalheader) + kept;
+        j->end_offset = sizeof(journalheader) + (j->end_offset - mark.offset);
+        j->end_records -= mark.records;
+        j->compactions++;
+        j->compacted_bytes += mark.bytes;
+        double took = journalSeconds() - start;
+        if (took > j->longest_compaction) {
+            j->longest_compaction = took;
+        }
+    } else if (fd >= 0) {
+        close(fd);
+        unlink(tmp);
+    }
+    pthread_mutex_unlock(&j->lock);
+    if (!ok) {
+        printf("Warning: Compacting journal %s failed (%s); it is kept as it was.\n", j->filename, strerror(error));
+    }
+    free(tmp);
+    return ok;
+}
+
+
+/*
+journalClose() - Syncs what is still buffered and stops the flusher
+ - Time: O(buffered bytes) plus one sync, Space: O(1)
+ */
+void journalClose(void) {
+    journal* j = &currentStore->journal;
+    if (j->fd < 0) {
+        return;
+    }
+    pthread_mutex_lock(&j->lock);
+    j->stop = 1;
+    pthread_cond_signal(&j->wake);
+    int running = j->running;
+    j->running = 0;
+    pthread_mutex_unlock(&j->lock);
+    if (running) {
+        pthread_join(j->flusher, NULL);
+    }
+    if (j->error && !j->error_reported) {
+        printf("Warning: Writing journal %s failed (%s).\n", j->filename, strerror(j->error));
+    }
+    close(j->fd);
+    j->fd = -1;
+    free(j->buffer);
+    free(j->spare);
+    j->buffer = j->spare = NULL;
+    j->used = j->capacity = j->spare_capacity = 0;
+    pthread_mutex_destroy(&j->lock);
+    pthread_cond_destroy(&j->wake);
+    pthread_cond_destroy(&j->drained);
+}
+
+
+/*
+journalHold() - Keeps the journal locked for a batch of changes from one thread
+ - The changes up to journalRelease() take no lock each and wake the
+   flusher at most once; the flusher cannot hand over a group meanwhile,
+   so a batch should be short. journalMark(), journalCompact() and
+   journalClose() must not be called while holding
+ - Time: O(1) plus the wait for the lock, Space: O(1)
+ - Example: journalHold(); apply 64 queued commands; journalRelease()
+ */
+void journalHold(void) {
+    journal* j = &currentStore->journal;
+    if (j->fd < 0) {
+        return;
+    }
+    pthread_mutex_lock(&j->lock);
+    j->held = 1;
+}
+
+
+void journalRelease(void) {
+    journal* j = &currentStore->journal;
+    if (!j->held) {
+        return;
+    }
+    j->held = 0;
+    if (j->wake_pending) {
+        j->wake_pending = 0;
+        pthread_cond_signal(&j->wake);
+    }
+    pthread_mutex_unlock(&j->lock);
+}
+
+
+/*
+printJournalStats() - Prints journal size, group commits, compactions and replay lengths
+ - Time: O(1), Space: O(1)
+ */
+void printJournalStats(void) {
+    journal* j = &currentStore->journal;
+    printf("--- Journal ---\n");
+    if (j->fd < 0) {
+        printf("Off\n");
+        return;
+    }
+    pthread_mutex_lock(&j->lock);
+    printf("File: %s (generation %llu), group commit after %ld ms or %zu bytes, CRC-32C: %s\n",
+           j->filename, j->generation, j->sync_ms, j->sync_bytes, crc32cKernelName());
+    printf("Records: %ld (%llu bytes), %zu bytes waiting, syncs: %ld, largest group: %ld records\n",
+           j->records, j->bytes, j->used, j->syncs, j->largest_group);
+    printf("Sync time: %.3f ms average, %.3f ms longest\n",
+           j->syncs ? j->sync_seconds * 1000 / j->syncs : 0.0, j->longest_sync * 1000);
+    printf("Writer thread: %s, started %ld time(s)\n", j->running ? "running" : "idle", j->flusher_starts);
+    printf("Replay length: %ld records (%llu bytes) since the last snapshot\n",
+           j->end_records, j->end_offset - sizeof(journalheader));
+    printf("Compactions: %ld (%llu bytes dropped), %.3f ms longest\n",
+           j->compactions, j->compacted_bytes, j->longest_compaction * 1000);
+    printf("Replayed at startup: %ld records (%ld skipped) in %.3f s\n",
+           j->replayed, j->replay_skipped, j->replay_seconds);
+    if (j->error) {
+        printf("Last write failed: %s\n", strerror(j->error));
+    }
+    pthread_mutex_unlock(&j->lock);
+}
@@ -0,0 +1,158 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include "task_management.h"
+
+// Append-only journal of every change made since the snapshot was saved.
+// Each change is one small binary record checked by a CRC-32C. Records
+// are appended to a memory buffer and a flusher thread writes and
+// fdatasyncs them in groups, at most JOURNAL_SYNC_MS after the first
+// unsynced change or as soon as JOURNAL_SYNC_BYTES are waiting, so no
+// menu action waits for the disk. The flusher is started by the first
+// record and exits after JOURNAL_IDLE_MS without one, so a server with
+// many named lists only runs threads for the busy ones. On startup the journal is replayed on
+// top of the snapshot it continues: a snapshot of generation g taken at
+// offset o holds every record of journal g before o, so journal g is
+// replayed from o and journal g + 1 (compacted since) from its start. A
+// record cut short by a crash ends the replay and is cut off the file.
+#define JOURNAL_MAGIC "TODOJRNL"        // 8 bytes, no NUL in the file
+#define JOURNAL_VERSION 2
+#define JOURNAL_BYTE_ORDER 0x01020304u
+#define JOURNAL_DEFAULT_FILE "todo.journal"
+#define JOURNAL_SYNC_MS 50              // TODO_JOURNAL_SYNC_MS overrides
+#define JOURNAL_SYNC_BYTES (256u << 10) // TODO_JOURNAL_SYNC_BYTES overrides
+#define JOURNAL_BUFFER_LIMIT (16u << 20)// appends wait for the flusher beyond this
+#define JOURNAL_IDLE_MS 2000            // the flusher exits after this long without records
+#define JOURNAL_NO_DAY 0xFFFFFFFFu      // journalTask() of a pending task
+
+// Record types
+#define JOURNAL_TASK 1                  // a new task with all of its fields
+#define JOURNAL_RENAME 2
+#define JOURNAL_DESCRIBE 3
+#define JOURNAL_PRIORITY 4
+#define JOURNAL_DUE 5
+#define JOURNAL_COMPLETE 6
+#define JOURNAL_UNDO 7
+#define JOURNAL_DELETE 8
+#define JOURNAL_TAG 9
+#define JOURNAL_RETAG 10
+#define JOURNAL_CLEAR 11
+
+// File header
+typedef struct {
+    char magic[8];
+    unsigned int version;
+    unsigned int byte_order;
+    unsigned int shard;                 // which shard of its list the file journals
+    unsigned int shard_count;           // 1 unless the list is sharded
+    unsigned long long generation;      // bumped each time the journal is compacted
+} journalheader;
+
+// Every record starts with this; length bytes of fields follow, the
+// first being the record type. Text fields are a length, the bytes and
+// a NUL; numbers are native 32-bit words.
+typedef struct {
+    unsigned int crc;                   // crc32c() of length and the fields
+    unsigned int length;
+} journalrecord;
+
+// One field of a record being written: text when text is not NULL, else word
+typedef struct {
+    const char* text;
+    size_t length;
+    unsigned int word;
+} journalfield;
+
+// Reads the fields of one record during replay; ok drops to 0 on a short record
+typedef struct {
+    const char* p;
+    const char* end;
+    int ok;
+} journalreader;
+
+// A position in the journal, taken when a snapshot starts: the snapshot
+// holds every record before it
+typedef struct {
+    unsigned long long generation;
+    unsigned long long offset;          // logical end of the journal, buffered records included
+    unsigned long long bytes;           // record bytes from the start of the file to offset
+    long records;                       // records in those bytes (replayed after a crash)
+} journalmark;
+
+// The open journal
+typedef struct {
+    int fd;                             // -1 while journaling is off
+    const char* filename;
+    unsigned long long generation;
+    char* buffer;                       // records not yet handed to the flusher
+    size_t used;
+    size_t capacity;
+    char* spare;                        // the other buffer, written by the flusher
+    size_t spare_capacity;
+    double first_unsynced;              // when buffer went from empty to non-empty
+    long sync_ms;
+    size_t sync_bytes;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;                // flusher: new records or stop
+    pthread_cond_t drained;             // appenders: the flusher took the buffer
+    pthread_t flusher;
+    int running;                        // flusher thread is started and has not gone idle
+    int writing;                        // flusher is writing the spare buffer
+    int held;                           // lock held across appends (journalHold())
+    int wake_pending;                   // flusher to be woken on journalRelease()
+    int stop;
+    int error;                          // errno of a failed write or sync
+    int error_reported;
+    unsigned long long file_end;        // bytes written to the file
+    unsigned long long end_offset;      // file_end plus the bytes still buffered
+    long end_records;                   // records in the file and the buffers
+    // Counters for printJournalStats()
+    long records;
+    unsigned long long bytes;
+    long syncs;
+    long largest_group;                 // most records made durable by one sync
+    long flusher_starts;
+    long group_records;                 // records in the buffer now
+    double sync_seconds;
+    double longest_sync;
+    long compactions;
+    unsigned long long compacted_bytes; // records dropped because a snapshot held them
+    double longest_compaction;
+    // What the last replay did
+    long replayed;
+    long replay_skipped;
+    size_t torn_bytes;
+    double replay_seconds;
+    const char* problem;                // why the old journal was set aside, if it was
+    int reported;
+} journal;
+
+const char* journalPath(void);
+int journalShardOf(const char* filename, int* shard, int* shard_count);
+int journalOpen(tasklist* list, completionlog* done, const char* filename, unsigned long long generation,
+                unsigned long long offset);
+void journalReport(void);
+int journalEnabled(void);
+journalmark journalMark(void);
+int journalCompact(journalmark mark);
+void journalClose(void);
+void journalHold(void);
+void journalRelease(void);
+void printJournalStats(void);
+
+void journalTask(const task* t, unsigned int day);
+void journalImported(tasklist* list, completionlog* done, unsigned int first_seq, int first_completed);
+void journalRename(const char* old_name, const char* new_name);
+void journalDescribe(const task* t);
+void journalPriority(const task* t);
+void journalDue(const task* t);
+void journalComplete(const task* t, unsigned int day);
+void journalUndo(void);
+void journalDelete(const task* t);
+void journalTag(const task* t, unsigned int tag_id);
+void journalRetag(const task* t, int index, unsigned int tag_id);
+void journalClear(void);
+
+#endif
@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "loadgen.h"
+
+
+static double loadSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+static int connectTo(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
+
+
+static int sendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return 1;
+}
+
+
+/*
+readAnswerLine() - Reads one line of an answer, without its newline
+ - Longer lines are cut to fit line; the rest is skipped
+ - Time: O(line length), Space: O(1)
+ - Returns 0 (with c->failed set) if the connection closed first
+ */
+static int readAnswerLine(loadclient* c, int fd, char* line, size_t size) {
+    size_t used = 0;
+    while (1) {
+        char* from = c->buffer + c->start;
+        char* newline = (char*)memchr(from, '\n', c->end - c->start);
+        size_t take = newline ? (size_t)(newline - from) : c->end - c->start;
+        size_t copy = take < size - 1 - used ? take : size - 1 - used;
+        memcpy(line + used, from, copy);
+        used += copy;
+        if (newline) {
+            c->start += take + 1;
+            line[used] = '\0';
+            return 1;
+        }
+        c->start = c->end = 0;
+        ssize_t n = recv(fd, c->buffer, sizeof(c->buffer), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            c->failed = n < 0 ? errno : ECONNRESET;
+            return 0;
+        }
+        c->end = (size_t)n;
+    }
+}
+
+
+/*
+runLoadClient() - Thread body: sends the request mix one at a time and times each answer
+ - Switches to the scratch list first (not timed). Of every 10 requests 5
+   add a task, 2 search for the newest one, 1 completes the oldest pending
+   one, 1 edits a priority and 1 reads stats
+ - Time: O(requests) round trips, Space: O(1)
+ */
+static void* runLoadClient(void* arg) {
+    loadclient* c = (loadclient*)arg;
+    int fd = connectTo(c->path);
+    if (fd < 0) {
+        c->failed = errno;
+        return NULL;
+    }
+    int pid = (int)getpid();
+    long added = 0, completed = 0;
+    char request[128], line[256];
+    int length = snprintf(request, sizeof(request), "use\t%s\n", c->list);
+    if (!sendAll(fd, request, (size_t)length)) {
+        c->failed = errno;
+    } else if (readAnswerLine(c, fd, line, sizeof(line)) && strcmp(line, "ok") != 0) {
+        c->failed = EPROTO;
+    }
+    for (long r = 0; r < c->requests && !c->failed; r++) {
+        int kind = (int)(r % 10);
+        int searching = 0;
+        if (kind < 5 || added == 0) {
+            length = snprintf(request, sizeof(request), "add\tlg%d-%d-%ld\tload test\t%ld\n", pid, c->id, added,
+                              1 + added % 3);
+            added++;
+        } else if (kind < 7) {
+            length = snprintf(request, sizeof(request), "search\tlg%d-%d-%ld\n", pid, c->id, added - 1);
+            searching = 1;
+        } else if (kind == 7 && completed < added - 1) {
+            length = snprintf(request, sizeof(request), "complete\tlg%d-%d-%ld\n", pid, c->id, completed);
+            completed++;
+        } else if (kind == 8) {
+            length = snprintf(request, sizeof(request), "edit\tlg%d-%d-%ld\tpriority\t%ld\n", pid, c->id,
+                              added - 1, 1 + r % 3);
+        } else {
+            length = snprintf(request, sizeof(request), "stats\n");
+        }
+
+        double start = loadSeconds();
+        if (!sendAll(fd, request, (size_t)length)) {
+            c->failed = errno;
+            break;
+        }
+        if (!readAnswerLine(c, fd, line, sizeof(line))) {
+            break;
+        }
+        if (strncmp(line, "error", 5) == 0) {
+            c->errors++;
+        } else if (searching) {
+            // "ok <count>", then one line per match
+            long matches = strtol(line + 2, NULL, 10);
+            for (long i = 0; i < matches; i++) {
+                if (!readAnswerLine(c, fd, line, sizeof(line))) {
+                    break;
+                }
+            }
+            if (c->failed) {
+                break;
+            }
+        }
+        c->latencies[c->answered++] = loadSeconds() - start;
+    }
+    c->added = added;
+    c->completed = completed;
+    close(fd);
+    return NULL;
+}
+
+
+// Sends the pending requests and reads their one-line answers; returns 0 if the connection broke
+static int flushRequests(loadclient* c, int fd, const char* requests, size_t* used, int* count) {
+    char line[256];
+    if (*count > 0 && !sendAll(fd, requests, *used)) {
+        c->failed = errno;
+        return 0;
+    }
+    for (; *count > 0; (*count)--) {
+        if (!readAnswerLine(c, fd, line, sizeof(line))) {
+            return 0;
+        }
+    }
+    *used = 0;
+    return 1;
+}
+
+
+/*
+clearLoadList() - Empties the run's scratch list after the clients are done
+ - Every completion is undone, then every task the clients added is
+   deleted, so only an empty list is left (which leaves no files when the
+   server stops, see closeNamedLists())
+ - Requests go out LOADGEN_CLEAR_BATCH at a time, each group before its
+   answers are read
+ - Time: O(tasks added) requests, Space: O(1)
+ - Returns 1 if every request was answered
+ */
+static int clearLoadList(const loadclient* all, int clients, const char* path, const char* list) {
+    loadclient c;
+    memset(&c, 0, sizeof(c));
+    int fd = connectTo(path);
+    if (fd < 0) {
+        return 0;
+    }
+    int pid = (int)getpid();
+    char requests[LOADGEN_CLEAR_BATCH * 64];
+    size_t used = (size_t)snprintf(requests, sizeof(requests), "use\t%s\n", list);
+    int count = 1;
+    int ok = 1;
+    for (int i = 0; i < clients && ok; i++) {
+        for (long n = 0; n < all[i].completed && ok; n++) {
+            used += (size_t)snprintf(requests + used, sizeof(requests) - used, "undo\n");
+            if (++count == LOADGEN_CLEAR_BATCH) {
+                ok = flushRequests(&c, fd, requests, &used, &count);
+            }
+        }
+    }
+    for (int i = 0; i < clients && ok; i++) {
+        for (long n = 0; n < all[i].added && ok; n++) {
+            used += (size_t)snprintf(requests + used, sizeof(requests) - used, "delete\tlg%d-%d-%ld\n", pid,
+                                     all[i].id, n);
+            if (++count == LOADGEN_CLEAR_BATCH) {
+                ok = flushRequests(&c, fd, requests, &used, &count);
+            }
+        }
+    }
+    ok = ok && flushRequests(&c, fd, requests, &used, &count);
+    close(fd);
+    return ok;
+}
+
+
+static int compareSeconds(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+
+// Nearest-rank percentile of sorted values, in thousandths (p999 = 999)
+static double percentile(const double* sorted, long count, long permille) {
+    long rank = (count * permille + 999) / 1000;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+
+/*
+runLoadGenerator() - Drives a running server from several clients and reports the results
+ - The clients work on the scratch list loadgen-<pid>, which is emptied afterwards
+ - Prints throughput and the p50/p99/p999/max latency over every answer
+ - Time: O(clients · requests · log), Space: O(clients · requests) for the latencies
+ - Returns 1 if every client finished all of its requests
+ - Example: runLoadGenerator("todo.sock", 4, 100000)
+ */
+int runLoadGenerator(const char* path, int clients, long requests) {
+    loadclient* all = (loadclient*)calloc(clients, sizeof(loadclient));
+    double* latencies = (double*)malloc((size_t)clients * requests * sizeof(double));
+    if (!all || !latencies) {
+        printf("Memory allocation failed.\n");
+        free(all);
+        free(latencies);
+        return 0;
+    }
+
+    char list[32];
+    snprintf(list, sizeof(list), "loadgen-%d", (int)getpid());
+    double start = loadSeconds();
+    int started = 0;
+    for (int i = 0; i < clients; i++) {
+        all[i].path = path;
+        all[i].list = list;
+        all[i].id = i;
+        all[i].requests = requests;
+        all[i].latencies = latencies + (size_t)i * requests;
+        if (pthread_create(&all[i].thread, NULL, runLoadClient, &all[i]) != 0) {
+            all[i].failed = EAGAIN;
+            break;
+        }
+        started++;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(all[i].thread, NULL);
+    }
+    double seconds = loadSeconds() - start;
+    int cleared = clearLoadList(all, started, path, list);
+
+    // Gather every client's latencies at the front of the array
+    long answered = 0, errors = 0;
+    int failed = 0, failure = 0;
+    for (int i = 0; i < clients; i++) {
+        memmove(latencies + answered, all[i].latencies, all[i].answered * sizeof(double));
+        answered += all[i].answered;
+        errors += all[i].errors;
+        if (all[i].failed) {
+            failed++;
+            failure = all[i].failed;
+        }
+    }
+    qsort(latencies, answered, sizeof(double), compareSeconds);
+
+    printf("Load: %d clients x %ld requests against %s\n", clients, requests, path);
+    printf("Answered %ld in %.3f s: %.0f requests/s (%ld errors)\n", answered, seconds,
+           seconds > 0 ? answered / seconds : 0.0, errors);
+    if (answered > 0) {
+        printf("Latency: p50 %.1f us, p99 %.1f us, p999 %.1f us, max %.1f us\n",
+               percentile(latencies, answered, 500) * 1e6, percentile(latencies, answered, 990) * 1e6,
+               percentile(latencies, answered, 999) * 1e6, latencies[answered - 1] * 1e6);
+    }
+    if (failed) {
+        printf("Warning: %d client(s) did not finish (%s).\n", failed, strerror(failure));
+    }
+    if (!cleared) {
+        printf("Warning: The scratch list %s could not be emptied.\n", list);
+    }
+    free(latencies);
+    free(all);
+    return failed == 0 && cleared;
+}
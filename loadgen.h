@@ -0,0 +1,37 @@
+#ifndef LOADGEN_H
+#define LOADGEN_H
+
+#include <pthread.h>
+
+// Load generator for the socket server (todo_progress --loadgen [clients
+// [requests]]). Every client is a thread with its own connection that
+// sends one command, waits for its answer and records the latency
+// (closed loop). The mix adds, searches, completes, edits and reads stats
+// on a scratch list of the run (loadgen-<pid>), which is emptied again
+// at the end, so the server's own lists are never touched.
+#define LOADGEN_CLIENTS 4
+#define LOADGEN_REQUESTS 100000         // per client
+#define LOADGEN_READ_CHUNK 4096
+#define LOADGEN_CLEAR_BATCH 256         // cleanup requests sent before their answers are read
+
+// One client thread
+typedef struct {
+    const char* path;
+    const char* list;                   // the run's scratch list
+    int id;
+    long requests;
+    long added;                         // tasks lg<pid>-<id>-<n>, n < added
+    long completed;                     // of them, n < completed were completed
+    double* latencies;                  // seconds, one per answered request
+    long answered;
+    long errors;                        // answers starting with "error"
+    int failed;                         // errno if the connection broke
+    char buffer[LOADGEN_READ_CHUNK];    // received bytes not yet consumed
+    size_t start;
+    size_t end;
+    pthread_t thread;
+} loadclient;
+
+int runLoadGenerator(const char* path, int clients, long requests);
+
+#endif
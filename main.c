@@ -5,11 +5,17 @@
 #include "task_management.h"
 #include "searchandstat.h"
 #include "fileio.h"
+#include "snapshot.h"
+#include "journal.h"
+#include "checkpoint.h"
+#include "batch.h"
+#include "server.h"
+#include "loadgen.h"
+#include "benchmark.h"
+#include "taskstore.h"
 
-tasklist tasks = {NULL};
-completedstack doneStack = {NULL};
-
-date currentDate;
+// The list the menu works on
+taskstore* store = NULL;
 
 void pause() {
     printf("\nPress Enter to continue...");
@@ -39,7 +45,7 @@ void debugTaskList() {
     printf("\n=== Debugging Task List ===\n");
     
     // Check if tasks list has loops
-    if (checkForLoops(&tasks)) {
+    if (checkForLoops(&store->list)) {
         printf("ERROR: Loop detected in tasks list!\n");
     } else {
         printf("Task list integrity: OK\n");
@@ -47,23 +53,23 @@ void debugTaskList() {
     
     // Count tasks and check for NULL/invalid data
     int count = 0;
-    task* current = tasks.head;
+    task* current = store->list.head;
     while (current && count < 1000) {  // Safety limit
         count++;
         
         // Check for invalid data
         if (current->priority < 1 || current->priority > 3) {
             printf("WARNING: Task '%s' has invalid priority: %d\n", 
-                   current->name, current->priority);
+                   taskName(current), current->priority);
         }
         
         if (current->due_date_set && 
-            (current->duedate.day < 1 || current->duedate.day > 31 ||
-             current->duedate.month < 1 || current->duedate.month > 12 ||
-             current->duedate.year < 2000 || current->duedate.year > 2100)) {
+            (taskDueDate(current).day < 1 || taskDueDate(current).day > 31 ||
+             taskDueDate(current).month < 1 || taskDueDate(current).month > 12 ||
+             taskDueDate(current).year < 2000 || taskDueDate(current).year > 2100)) {
             printf("WARNING: Task '%s' has suspicious date: %d/%d/%d\n",
-                   current->name, current->duedate.day, 
-                   current->duedate.month, current->duedate.year);
+                   taskName(current), taskDueDate(current).day, 
+                   taskDueDate(current).month, taskDueDate(current).year);
         }
         
         current = current->next;
@@ -75,25 +81,26 @@ void debugTaskList() {
         printf("Task count: %d\n", count);
     }
     
-    // Check completed stack
-    count = 0;
-    stacknode* node = doneStack.top;
-    while (node && count < 1000) {  // Safety limit
-        count++;
-        
-        // Check for NULL task data
-        if (!node->task_data) {
-            printf("ERROR: Stack node #%d has NULL task data!\n", count);
+    // Check completion log
+    for (int i = 0; i < store->done.count; i++) {
+        // Check for NULL task data and entries out of day order
+        if (!store->done.entries[i].task_data) {
+            printf("ERROR: Completion log entry #%d has NULL task data!\n", i + 1);
+        }
+        if (i > 0 && store->done.entries[i].day < store->done.entries[i - 1].day) {
+            printf("ERROR: Completion log entry #%d is out of day order!\n", i + 1);
         }
-        
-        node = node->next;
     }
+    printf("Completed task count: %d\n", store->done.count);
     
-    if (count == 1000) {
-        printf("WARNING: Possible infinite loop in completed stack\n");
-    } else {
-        printf("Completed task count: %d\n", count);
-    }
+    printNameIndexStats(&store->list.names);
+    printTagIndexStats(&store->list.tags);
+    printDueTrackerStats(&store->list.due);
+    printCompletionLogStats(&store->done);
+    printTextIndexStats();
+    printJournalStats();
+    printCheckpointStats();
+    printMemoryStats();
     
     printf("=== End Debugging ===\n\n");
 }
@@ -120,67 +127,181 @@ void displayMenu() {
 }
 
 
-int main() {
+/*
+openDefaultList() - Creates the shards of the default list and starts loading them
+ - Shard k keeps its files at taskStoreShardPath() of the usual paths; the
+   shards load in parallel (call taskStoreReady() on each before use)
+ - Time: O(count) before returning, Space: O(count)
+ - Returns 1 on success, 0 if memory ran out (nothing is left open)
+ */
+static int openDefaultList(taskstore** shards, int count) {
+    for (int k = 0; k < count; k++) {
+        char* snapshot = taskStoreShardPath(snapshotPath(), k, count);
+        char* journal = taskStoreShardPath(journalPath(), k, count);
+        shards[k] = (snapshot || !snapshotPath()) && (journal || !journalPath())
+                        ? taskStoreCreate(snapshot, journal) : NULL;
+        free(snapshot);
+        free(journal);
+        if (!shards[k]) {
+            // None is loaded yet, so none may save over its snapshot
+            while (k-- > 0) {
+                free(shards[k]->snapshot_path);
+                shards[k]->snapshot_path = NULL;
+                taskStoreClose(shards[k]);
+            }
+            return 0;
+        }
+        shards[k]->shard = k;
+        shards[k]->shard_count = count;
+    }
+    for (int k = 0; k < count; k++) {
+        taskStoreLoad(shards[k]);
+    }
+    return 1;
+}
+
+
+int main(int argc, char** argv) {
     int choice;
+    FILE* batch = NULL;
+    int listen_fd = -1;
+
+    // todo_progress --batch [file]: commands from the file (or stdin), no menu
+    // todo_progress --serve: commands from socket clients until stopped
+    // todo_progress --loadgen [clients [requests]]: load against a server
+    if (argc > 1) {
+        if (strcmp(argv[1], "--loadgen") == 0 && argc <= 4) {
+            int clients = argc > 2 ? atoi(argv[2]) : LOADGEN_CLIENTS;
+            long requests = argc > 3 ? atol(argv[3]) : LOADGEN_REQUESTS;
+            if (clients > 0 && requests > 0) {
+                return runLoadGenerator(serverSocketPath(), clients, requests) ? 0 : 1;
+            }
+        } else if (strcmp(argv[1], "--serve") == 0 && argc == 2) {
+            listen_fd = serverListen(serverSocketPath());
+            if (listen_fd < 0) {
+                perror("Failed to listen on the socket");
+                return 1;
+            }
+        } else if (strcmp(argv[1], "--batch") == 0 && argc <= 3) {
+            batch = argc == 3 && strcmp(argv[2], "-") != 0 ? fopen(argv[2], "r") : stdin;
+            if (!batch) {
+                perror("Failed to open batch file");
+                return 2;
+            }
+        }
+        if (listen_fd < 0 && !batch) {
+            fprintf(stderr, "Usage: %s [--batch [file] | --serve | --loadgen [clients [requests]]]\n", argv[0]);
+            return 2;
+        }
+    }
 
-    currentDate = getToday();
+    // The default list may be split into shards for --batch and --serve;
+    // the menu works on a single list
+    int shard_count = taskStoreShardCount();
+    if (shard_count > 1 && !batch && listen_fd < 0) {
+        fprintf(stderr, "TODO_SHARDS needs --batch or --serve; unset it for the menu\n");
+        return 2;
+    }
+    // Files written with another shard count would lose or misplace tasks
+    if (!taskStoreShardsMatch(snapshotPath(), journalPath(), shard_count)) {
+        return 1;
+    }
+    // In batch mode stdout carries the answers only
+    FILE* answers = batch ? batchAnswerStream() : stdout;
+    if (!answers) {
+        perror("Failed to set up the batch output");
+        return 1;
+    }
+    taskstore* shards[STORE_MAX_SHARDS];
+    // The saved tasks load in the background while the menu is shown,
+    // followed by the journaled changes made after they were saved
+    if (!openDefaultList(shards, shard_count)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    store = shards[0];
+
+    if (batch || listen_fd >= 0) {
+        for (int k = 0; k < shard_count; k++) {
+            taskStoreReady(shards[k]);
+        }
+        int ok;
+        if (batch) {
+            ok = runBatch(shards, shard_count, batch, answers) == 0;
+            ok = fclose(answers) == 0 && ok;
+            if (batch != stdin) {
+                fclose(batch);
+            }
+        } else {
+            ok = runServer(shards, shard_count, listen_fd, serverSocketPath());
+        }
+        for (int k = 0; k < shard_count; k++) {
+            taskStoreClose(shards[k]);
+        }
+        return ok ? 0 : 1;
+    }
 
     while (1) {
         displayMenu();
         scanf("%d", &choice);
         getchar(); // flush newline
+        taskStoreReady(store);
+        checkpointPoll(&store->list, &store->done);
 
         switch (choice) {
             case 1: 
-                add(&tasks);
+                add(&store->list);
                 pause();
                 break;
             case 2: 
-                view_combined(&tasks, currentDate);  // Combined view function
+                view_combined(&store->list, store->today);  // Combined view function
                 pause();
                 break;
             case 3: {
-                char name[100];
                 printf("Enter task name to edit: ");
-                fgets(name, sizeof(name), stdin);
-                name[strcspn(name, "\n")] = 0;
-                edit(&tasks, name);
+                char* name = readLine(stdin);
+                if (name) {
+                    edit(&store->list, name);
+                    free(name);
+                }
                 pause();
                 break;
             }
             case 4: {
-                char name[100];
                 printf("Enter task name to complete: ");
-                fgets(name, sizeof(name), stdin);
-                name[strcspn(name, "\n")] = 0;
-                complete(&tasks, &doneStack, name);
+                char* name = readLine(stdin);
+                if (name) {
+                    complete(&store->list, &store->done, name, store->today);
+                    free(name);
+                }
                 pause();
                 break;
             }
             case 5:
-                undoCompleted(&tasks, &doneStack);
+                undoCompleted(&store->list, &store->done);
                 pause();
                 break;
             case 6: {
-                char name[100];
                 printf("Enter task name to delete: ");
-                fgets(name, sizeof(name), stdin);
-                name[strcspn(name, "\n")] = 0;
-                deleteTask(&tasks, name);
+                char* name = readLine(stdin);
+                if (name) {
+                    deleteTask(&store->list, name);
+                    free(name);
+                }
                 pause();
                 break;
             }
             case 7: {
-                searchTasks(tasks.head, &doneStack, NULL);  // Pass NULL as keyword
+                searchTasks(store->list.head, &store->done, NULL);  // Pass NULL as keyword
                 pause();
                 break;
             }
             case 8:
-                show_combined_stats(tasks.head, &doneStack, currentDate);  // Combined stats function
+                show_combined_stats(store->list.head, &store->done, store->today);  // Combined stats function
                 pause();
                 break;
             case 9:
-                clearcompletedtask(&(doneStack.top));
+                clearcompletedtask(&store->done);
                 pause();
                 break;
             case 10: {
@@ -193,13 +314,13 @@ int main() {
                     strcpy(filename, "tasks_import.txt");
                 }
                 
-                importTasks(&tasks, filename);
+                importTasks(&store->list, &store->done, filename);
                 pause();
                 break;
             }
             case 11: {
                 char filename[100];
-                printf("Enter filename for export (default: tasks_export.txt): ");
+                printf("Enter filename for export (default: tasks_export.txt; .csv/.jsonl keep every field): ");
                 fgets(filename, sizeof(filename), stdin);
                 filename[strcspn(filename, "\n")] = 0;
                 
@@ -207,31 +328,36 @@ int main() {
                     strcpy(filename, "tasks_export.txt");
                 }
                 
-                exportTasksTxt(tasks.head, &doneStack, filename);
+                exportTasks(&store->list, &store->done, filename);
                 pause();
                 break;
             }
             case 12:
-                doneToday(&tasks, &doneStack);
+                doneToday(&store->done, store->today);
                 pause();
                 break;
             case 13:
-                simulateDayChange(tasks.head, &currentDate);
+                simulateDayChange(&store->list, &store->today);
                 pause();
                 break;
             case 14:
-                view_time_summary(&tasks, currentDate);  
+                view_time_summary(&store->list, store->today);  
                 pause();
                 break;
             case 15: {
-                char name[100];
                 printf("Enter task name to add tag: ");
-                fgets(name, sizeof(name), stdin);
-                name[strcspn(name, "\n")] = 0;
-                add_tag_to_task(&tasks, name);
+                char* name = readLine(stdin);
+                if (name) {
+                    add_tag_to_task(&store->list, name);
+                    free(name);
+                }
                 pause();
                 break;
             }
+            case 98:  // Hidden benchmark option
+                runBenchmarks();
+                pause();
+                break;
             
             case 99:  // Hidden debug option
                 debugTaskList();
@@ -239,8 +365,7 @@ int main() {
                 break;
             case 0:
                 printf("Exiting...\n");
-                freeTasks(&tasks);
-                freeStack(&doneStack);
+                taskStoreClose(store);
                 exit(0);
             default:
                 printf("Invalid option. Try again.\n");
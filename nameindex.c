@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nameindex.h"
+#include "task_management.h"
+
+#define NAMEINDEX_INITIAL_CAPACITY 64
+
+
+/*
+hashTaskNameLength() - FNV-1a hash of the first length bytes of a name, with a final bit mix
+ - Time: O(length), Space: O(1)
+ - Example: hashTaskNameLength("Study,Read", 5) == hashTaskName("Study")
+ */
+unsigned int hashTaskNameLength(const char* name, size_t length) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    // Final mix so the low bits used for the slot depend on every byte
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+
+/*
+hashTaskName() - FNV-1a hash of a task name with a final bit mix
+ - Time: O(len), Space: O(1)
+ - Example: hashTaskName("Study") -> same value every time for "Study"
+ */
+unsigned int hashTaskName(const char* name) {
+    return hashTaskNameLength(name, strlen(name));
+}
+
+
+/*
+resizeNameIndex() - Moves every entry to a table of new_capacity slots
+ - Time: O(n), Space: O(n)
+ - Returns 1 on success, 0 if memory allocation failed (old table is kept)
+ */
+static int resizeNameIndex(nameindex* idx, int new_capacity) {
+    nameslot* new_slots = (nameslot*)calloc(new_capacity, sizeof(nameslot));
+    if (!new_slots) {
+        return 0;
+    }
+
+    int mask = new_capacity - 1;
+    for (int i = 0; i < idx->capacity; i++) {
+        if (idx->slots[i].task_data) {
+            int pos = idx->slots[i].hash & mask;
+            while (new_slots[pos].task_data) {
+                pos = (pos + 1) & mask;
+            }
+            new_slots[pos] = idx->slots[i];
+        }
+    }
+
+    free(idx->slots);
+    idx->slots = new_slots;
+    idx->capacity = new_capacity;
+    return 1;
+}
+
+
+/*
+growNameIndex() - Doubles the table and re-inserts every entry
+ - Time: O(n), Space: O(n)
+ - Returns 1 on success, 0 if memory allocation failed (old table is kept)
+ */
+static int growNameIndex(nameindex* idx) {
+    return resizeNameIndex(idx, idx->capacity ? idx->capacity * 2 : NAMEINDEX_INITIAL_CAPACITY);
+}
+
+
+/*
+nameIndexReserve() - Grows the table once so count names fit without rehashing
+ - Used before bulk loads such as a snapshot restore
+ - Time: O(n + new capacity), Space: O(new capacity)
+ - Returns 1 on success, 0 if memory allocation failed (inserts still grow as usual)
+ */
+int nameIndexReserve(nameindex* idx, int count) {
+    int new_capacity = idx->capacity ? idx->capacity : NAMEINDEX_INITIAL_CAPACITY;
+    while ((long)count * 10 > (long)new_capacity * 7) {
+        new_capacity *= 2;
+    }
+    if (new_capacity == idx->capacity) {
+        return 1;
+    }
+    return resizeNameIndex(idx, new_capacity);
+}
+
+
+/*
+nameIndexFindHashed() - Looks up a name (bytes and length) whose hashTaskNameLength() is known
+ - Lets import hash names on its worker threads and only probe here
+ - Time: O(1) average, Space: O(1)
+ */
+task* nameIndexFindHashed(nameindex* idx, const char* name, size_t length, unsigned int hash) {
+    idx->lookups++;
+
+    if (idx->count == 0) {
+        idx->misses++;
+        return NULL;
+    }
+
+    int mask = idx->capacity - 1;
+    int pos = hash & mask;
+    int probe = 0;
+    task* found = NULL;
+
+    // Linear probing stops at the first empty slot
+    while (idx->slots[pos].task_data) {
+        probe++;
+        if (idx->slots[pos].hash == hash &&
+            taskCold(idx->slots[pos].task_data)->name.length == length &&
+            memcmp(taskName(idx->slots[pos].task_data), name, length) == 0) {
+            found = idx->slots[pos].task_data;
+            break;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    idx->probes += probe;
+    if (probe > idx->max_probe) {
+        idx->max_probe = probe;
+    }
+
+    if (found) {
+        idx->hits++;
+    } else {
+        idx->misses++;
+    }
+    return found;
+}
+
+
+/*
+nameIndexFindLength() - Looks up a task by exact name given as bytes and a length
+ - The name need not be NUL-terminated (e.g. a field of a mapped file)
+ - Time: O(1) average, Space: O(1)
+ - Sample Case:
+    Input: Index holding ["Study", "Project"], name = "Project,Slides", length = 7
+    Output: pointer to the "Project" task (NULL if not found)
+ */
+task* nameIndexFindLength(nameindex* idx, const char* name, size_t length) {
+    return nameIndexFindHashed(idx, name, length, hashTaskNameLength(name, length));
+}
+
+
+/*
+nameIndexFind() - Looks up a task by exact name
+ - Time: O(1) average, Space: O(1)
+ - Sample Case:
+    Input: Index holding ["Study", "Project"], name = "Project"
+    Output: pointer to the "Project" task (NULL if not found)
+ */
+task* nameIndexFind(nameindex* idx, const char* name) {
+    return nameIndexFindLength(idx, name, strlen(name));
+}
+
+
+/*
+nameIndexInsert() - Adds a task to the index under its current name
+ - Time: O(1) amortized, Space: O(1)
+ - Returns 1 on success, 0 if the table is full and cannot grow
+ */
+int nameIndexInsert(nameindex* idx, task* t) {
+    return nameIndexInsertHashed(idx, t, hashTaskName(taskName(t)));
+}
+
+
+/*
+nameIndexInsertHashed() - nameIndexInsert() for a task whose name hash is already known
+ - Lets a snapshot restore index names without reading them
+ - Time: O(1) amortized, Space: O(1)
+ - Returns 1 on success, 0 if the table is full and cannot grow
+ */
+int nameIndexInsertHashed(nameindex* idx, task* t, unsigned int hash) {
+    // Keep the load factor below 0.7
+    if ((idx->count + 1) * 10 > idx->capacity * 7) {
+        if (!growNameIndex(idx) && idx->count + 1 >= idx->capacity) {
+            printf("Memory allocation failed for name index.\n");
+            return 0;
+        }
+    }
+
+    int mask = idx->capacity - 1;
+    int pos = hash & mask;
+    while (idx->slots[pos].task_data) {
+        pos = (pos + 1) & mask;
+    }
+
+    idx->slots[pos].hash = hash;
+    idx->slots[pos].task_data = t;
+    idx->count++;
+    return 1;
+}
+
+
+/*
+nameIndexRemove() - Removes a task from the index
+ - Must be called BEFORE the task's name is changed or the task is freed
+ - Uses backward-shift deletion so no tombstones are left behind
+ - Time: O(1) average, Space: O(1)
+ */
+void nameIndexRemove(nameindex* idx, task* t) {
+    if (idx->count == 0) return;
+
+    int mask = idx->capacity - 1;
+    int pos = hashTaskName(taskName(t)) & mask;
+
+    while (idx->slots[pos].task_data && idx->slots[pos].task_data != t) {
+        pos = (pos + 1) & mask;
+    }
+    if (!idx->slots[pos].task_data) {
+        return; // Not indexed
+    }
+
+    // Shift following entries back into the hole when their home slot allows it
+    int hole = pos;
+    int next = (pos + 1) & mask;
+    while (idx->slots[next].task_data) {
+        int home = idx->slots[next].hash & mask;
+        int can_move = (hole <= next) ? (home <= hole || home > next)
+                                      : (home <= hole && home > next);
+        if (can_move) {
+            idx->slots[hole] = idx->slots[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+
+    idx->slots[hole].task_data = NULL;
+    idx->slots[hole].hash = 0;
+    idx->count--;
+}
+
+
+/*
+freeNameIndex() - Releases the table (tasks themselves are not freed)
+ - Time: O(1), Space: O(1)
+ */
+void freeNameIndex(nameindex* idx) {
+    free(idx->slots);
+    memset(idx, 0, sizeof(*idx));
+}
+
+
+/*
+printNameIndexStats() - Prints hit/miss counts and probe lengths
+ - Time: O(capacity), Space: O(1)
+ - Sample Case:
+    Output:
+      --- Name Index ---
+      Entries: 150 / 256 slots (load 0.59)
+      Lookups: 320 (hits: 170, misses: 150)
+      Average probe length: 1.21, longest: 4
+ */
+void printNameIndexStats(nameindex* idx) {
+    printf("--- Name Index ---\n");
+    printf("Entries: %d / %d slots (load %.2f)\n", idx->count, idx->capacity,
+           idx->capacity ? (double)idx->count / idx->capacity : 0.0);
+    printf("Lookups: %ld (hits: %ld, misses: %ld)\n", idx->lookups, idx->hits, idx->misses);
+    printf("Average probe length: %.2f, longest: %d\n",
+           idx->lookups ? (double)idx->probes / idx->lookups : 0.0, idx->max_probe);
+
+    // Distance of every stored entry from its home slot
+    long distance_buckets[5] = {0}; // 0, 1, 2-3, 4-7, 8+
+    int mask = idx->capacity - 1;
+    for (int i = 0; i < idx->capacity; i++) {
+        if (!idx->slots[i].task_data) continue;
+        int distance = (i - (int)(idx->slots[i].hash & mask)) & mask;
+        if (distance == 0) distance_buckets[0]++;
+        else if (distance == 1) distance_buckets[1]++;
+        else if (distance < 4) distance_buckets[2]++;
+        else if (distance < 8) distance_buckets[3]++;
+        else distance_buckets[4]++;
+    }
+    printf("Displacement: 0: %ld | 1: %ld | 2-3: %ld | 4-7: %ld | 8+: %ld\n",
+           distance_buckets[0], distance_buckets[1], distance_buckets[2],
+           distance_buckets[3], distance_buckets[4]);
+}
@@ -0,0 +1,39 @@
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <stddef.h>
+#include "scheduler.h"
+
+// One slot of the open-addressing table (task == NULL means empty)
+typedef struct {
+    unsigned int hash;
+    task* task_data;
+} nameslot;
+
+// Hash index on task name, kept alongside the linked list
+typedef struct {
+    nameslot* slots;
+    int capacity;   // always a power of two
+    int count;
+
+    // lookup statistics for the debug report
+    long lookups;
+    long hits;
+    long misses;
+    long probes;
+    int max_probe;
+} nameindex;
+
+unsigned int hashTaskNameLength(const char* name, size_t length);
+unsigned int hashTaskName(const char* name);
+task* nameIndexFindHashed(nameindex* idx, const char* name, size_t length, unsigned int hash);
+task* nameIndexFindLength(nameindex* idx, const char* name, size_t length);
+task* nameIndexFind(nameindex* idx, const char* name);
+int nameIndexInsert(nameindex* idx, task* t);
+int nameIndexInsertHashed(nameindex* idx, task* t, unsigned int hash);
+int nameIndexReserve(nameindex* idx, int count);
+void nameIndexRemove(nameindex* idx, task* t);
+void freeNameIndex(nameindex* idx);
+void printNameIndexStats(nameindex* idx);
+
+#endif
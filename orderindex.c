@@ -0,0 +1,349 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "orderindex.h"
+#include "task_management.h"
+#include "taskstore.h"
+
+
+
+/*
+orderGroup() - Section of the standard view a task belongs to
+ - Time: O(1), Space: O(1)
+ - Example: orderGroup(t) -> ORDER_GROUP_OVERDUE for an overdue task of any priority
+ */
+int orderGroup(const task* t) {
+    if (t->status == OVERDUE) {
+        return ORDER_GROUP_OVERDUE;
+    }
+    if (t->priority >= 1 && t->priority <= 3) {
+        return t->priority;
+    }
+    return ORDER_GROUP_OTHER;
+}
+
+
+/*
+orderPriority() - Priority slot of a task in priority_counts (0 for a priority outside 1-3)
+ - Time: O(1), Space: O(1)
+ */
+static int orderPriority(const task* t) {
+    return t->priority >= 1 && t->priority <= 3 ? t->priority : 0;
+}
+
+
+/*
+orderCompare() - Orders two tasks by group, due date (no date last) and newest first
+ - Newest first matches the head-first order of the linked list for ties
+ - Also sorts copies of tasks taken by a reader thread into the same order
+ - Time: O(1), Space: O(1)
+ */
+int orderCompare(const task* a, const task* b) {
+    int ga = orderGroup(a), gb = orderGroup(b);
+    if (ga != gb) {
+        return ga < gb ? -1 : 1;
+    }
+    unsigned int da = a->due_date_set ? a->due : 0xFFFFFFFFu;
+    unsigned int db = b->due_date_set ? b->due : 0xFFFFFFFFu;
+    if (da != db) {
+        return da < db ? -1 : 1;
+    }
+    if (a->seq != b->seq) {
+        return a->seq > b->seq ? -1 : 1;
+    }
+    return 0;
+}
+
+
+static int nodeHeight(ordernode* n) {
+    return n ? n->height : 0;
+}
+
+
+static void updateHeight(ordernode* n) {
+    int l = nodeHeight(n->left), r = nodeHeight(n->right);
+    n->height = (l > r ? l : r) + 1;
+}
+
+
+static ordernode* rotateRight(ordernode* n) {
+    ordernode* l = n->left;
+    n->left = l->right;
+    l->right = n;
+    updateHeight(n);
+    updateHeight(l);
+    return l;
+}
+
+
+static ordernode* rotateLeft(ordernode* n) {
+    ordernode* r = n->right;
+    n->right = r->left;
+    r->left = n;
+    updateHeight(n);
+    updateHeight(r);
+    return r;
+}
+
+
+/*
+rebalance() - Restores the AVL height rule at one node after an insert or remove
+ - Time: O(1), Space: O(1)
+ */
+static ordernode* rebalance(ordernode* n) {
+    updateHeight(n);
+    int balance = nodeHeight(n->left) - nodeHeight(n->right);
+    if (balance > 1) {
+        if (nodeHeight(n->left->left) < nodeHeight(n->left->right)) {
+            n->left = rotateLeft(n->left);
+        }
+        return rotateRight(n);
+    }
+    if (balance < -1) {
+        if (nodeHeight(n->right->right) < nodeHeight(n->right->left)) {
+            n->right = rotateRight(n->right);
+        }
+        return rotateLeft(n);
+    }
+    return n;
+}
+
+
+static ordernode* insertNode(ordernode* n, ordernode* node) {
+    if (!n) {
+        return node;
+    }
+    if (orderCompare(node->task_data, n->task_data) < 0) {
+        n->left = insertNode(n->left, node);
+    } else {
+        n->right = insertNode(n->right, node);
+    }
+    return rebalance(n);
+}
+
+
+/*
+removeNode() - Unlinks the node holding t from a subtree
+ - *removed receives the node so the caller can free it
+ - Time: O(log n), Space: O(log n) recursion
+ */
+static ordernode* removeNode(ordernode* n, const task* t, ordernode** removed) {
+    if (!n) {
+        return NULL;
+    }
+    int cmp = orderCompare(t, n->task_data);
+    if (cmp < 0) {
+        n->left = removeNode(n->left, t, removed);
+    } else if (cmp > 0) {
+        n->right = removeNode(n->right, t, removed);
+    } else {
+        *removed = n;
+        if (!n->left || !n->right) {
+            return n->left ? n->left : n->right;
+        }
+        // Replace with the smallest node of the right subtree
+        ordernode* successor = n->right;
+        while (successor->left) {
+            successor = successor->left;
+        }
+        ordernode* ignored = NULL;
+        successor->right = removeNode(n->right, successor->task_data, &ignored);
+        successor->left = n->left;
+        n = successor;
+    }
+    return rebalance(n);
+}
+
+
+/*
+orderIndexInsert() - Adds a task under its current key
+ - Time: O(log n), Space: O(1)
+ - Returns 1 on success, 0 if memory allocation failed
+ */
+int orderIndexInsert(orderindex* idx, task* t) {
+    ordernode* node = (ordernode*)slabAlloc(&currentStore->order_slab);
+    if (!node) {
+        return 0;
+    }
+    node->task_data = t;
+    orderIndexPut(idx, node);
+    return 1;
+}
+
+
+/*
+orderIndexPut() - Puts a node from orderIndexTake() back under its task's current key
+ - Does not allocate, so moving a task in the view order cannot fail
+ - A NULL node (the task was not in the index) is ignored
+ - Time: O(log n), Space: O(1)
+ */
+void orderIndexPut(orderindex* idx, ordernode* node) {
+    if (!node) {
+        return;
+    }
+    task* t = node->task_data;
+    node->left = node->right = NULL;
+    node->height = 1;
+    idx->root = insertNode(idx->root, node);
+    idx->count++;
+    idx->group_counts[orderGroup(t)]++;
+    idx->priority_counts[orderPriority(t)]++;
+}
+
+
+static void freeNodes(ordernode* n);
+
+
+/*
+buildBalanced() - Builds a balanced subtree over sorted[first..last)
+ - Time: O(last - first), Space: O(log n) recursion
+ - Returns the subtree root; *failed is set (and nothing is kept) if the
+   slab runs out of memory
+ */
+static ordernode* buildBalanced(task** sorted, int first, int last, int* failed) {
+    if (first >= last || *failed) {
+        return NULL;
+    }
+    int mid = first + (last - first) / 2;
+    ordernode* left = buildBalanced(sorted, first, mid, failed);
+    ordernode* node = *failed ? NULL : (ordernode*)slabAlloc(&currentStore->order_slab);
+    if (!node) {
+        *failed = 1;
+        freeNodes(left);
+        return NULL;
+    }
+    node->left = left;
+    node->task_data = sorted[mid];
+    node->right = buildBalanced(sorted, mid + 1, last, failed);
+    if (*failed) {
+        freeNodes(node);
+        return NULL;
+    }
+    updateHeight(node);
+    return node;
+}
+
+
+/*
+orderIndexBuild() - Fills an empty index from tasks already in view order
+ - Used when a snapshot is loaded: one O(n) pass instead of n inserts
+ - The order is checked first; an index that is not empty, tasks out of
+   order or a failed allocation leave the index untouched
+ - Time: O(n), Space: O(log n) recursion
+ - Returns 1 on success, 0 if the caller has to insert the tasks one by one
+ */
+int orderIndexBuild(orderindex* idx, task** sorted, int count) {
+    if (idx->root) {
+        return 0;
+    }
+    for (int i = 1; i < count; i++) {
+        if (orderCompare(sorted[i - 1], sorted[i]) >= 0) {
+            return 0;
+        }
+    }
+    int failed = 0;
+    ordernode* root = buildBalanced(sorted, 0, count, &failed);
+    if (failed) {
+        return 0;
+    }
+    idx->root = root;
+    idx->count = count;
+    for (int i = 0; i < count; i++) {
+        idx->group_counts[orderGroup(sorted[i])]++;
+        idx->priority_counts[orderPriority(sorted[i])]++;
+    }
+    return 1;
+}
+
+
+/*
+orderIndexTake() - Removes a task but keeps its node for orderIndexPut()
+ - Its key must be the one it was inserted with
+ - Time: O(log n), Space: O(1)
+ - Returns the node, or NULL if the task was not in the index
+ - Example: n = orderIndexTake(&list->order, t); t->priority = 1; orderIndexPut(&list->order, n);
+ */
+ordernode* orderIndexTake(orderindex* idx, task* t) {
+    ordernode* removed = NULL;
+    idx->root = removeNode(idx->root, t, &removed);
+    if (removed) {
+        idx->count--;
+        idx->group_counts[orderGroup(t)]--;
+        idx->priority_counts[orderPriority(t)]--;
+    }
+    return removed;
+}
+
+
+/*
+orderIndexRemove() - Removes a task; its key must be the one it was inserted with
+ - Time: O(log n), Space: O(1)
+ - Example: orderIndexRemove(&list->order, t) when t leaves the list
+ */
+void orderIndexRemove(orderindex* idx, task* t) {
+    slabFree(&currentStore->order_slab, orderIndexTake(idx, t));
+}
+
+
+/*
+orderIterBegin() - Starts an in-order walk at the first task
+ - Time: O(log n), Space: O(1)
+ */
+void orderIterBegin(orderiter* it, orderindex* idx) {
+    it->depth = 0;
+    for (ordernode* n = idx->root; n; n = n->left) {
+        it->stack[it->depth++] = n;
+    }
+}
+
+
+/*
+orderIterPeek() - Returns the next task without advancing (NULL at the end)
+ - Time: O(1), Space: O(1)
+ */
+task* orderIterPeek(orderiter* it) {
+    return it->depth ? it->stack[it->depth - 1]->task_data : NULL;
+}
+
+
+/*
+orderIterNext() - Returns the next task in order and advances (NULL at the end)
+ - Time: O(1) amortized, Space: O(1)
+ - Example: for (t = orderIterNext(&it); t; t = orderIterNext(&it)) { ... }
+ */
+task* orderIterNext(orderiter* it) {
+    if (it->depth == 0) {
+        return NULL;
+    }
+    ordernode* n = it->stack[--it->depth];
+    for (ordernode* c = n->right; c; c = c->left) {
+        // c's right subtree is walked soon after c; start loading it now
+        __builtin_prefetch(c->right);
+        it->stack[it->depth++] = c;
+    }
+    return n->task_data;
+}
+
+
+static void freeNodes(ordernode* n) {
+    if (!n) return;
+    freeNodes(n->left);
+    freeNodes(n->right);
+    slabFree(&currentStore->order_slab, n);
+}
+
+
+/*
+freeOrderIndex() - Returns every node of the tree to the slab
+ - Time: O(n), Space: O(log n) recursion
+ */
+void freeOrderIndex(orderindex* idx) {
+    freeNodes(idx->root);
+    idx->root = NULL;
+    idx->count = 0;
+    for (int g = 0; g < ORDER_GROUPS; g++) {
+        idx->group_counts[g] = 0;
+    }
+    for (int p = 0; p < 4; p++) {
+        idx->priority_counts[p] = 0;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef ORDERINDEX_H
+#define ORDERINDEX_H
+
+#include "scheduler.h"
+#include "slab.h"
+
+// Groups of the standard view, in display order
+#define ORDER_GROUP_OVERDUE 0
+#define ORDER_GROUP_HIGH 1
+#define ORDER_GROUP_MEDIUM 2
+#define ORDER_GROUP_LOW 3
+#define ORDER_GROUP_OTHER 4     // priority outside 1-3 (never displayed)
+#define ORDER_GROUPS 5
+
+// AVL tree node; one per task in the list
+typedef struct ordernode {
+    struct ordernode* left;
+    struct ordernode* right;
+    task* task_data;
+    int height;
+} ordernode;
+
+// Tasks ordered by (overdue first, priority, due date, newest first).
+// The key of a task must not change while it is in the tree: take it out,
+// change priority/due/status, then put it back.
+typedef struct {
+    ordernode* root;
+    int count;
+    int group_counts[ORDER_GROUPS];
+    int priority_counts[4];     // by priority 1-3 whatever the group (0: other)
+    unsigned int next_seq;      // handed to task->seq on insert
+} orderindex;
+
+// In-order walk with an explicit stack (AVL height stays below 64)
+typedef struct {
+    ordernode* stack[64];
+    int depth;
+} orderiter;
+
+
+int orderGroup(const task* t);
+int orderCompare(const task* a, const task* b);
+int orderIndexInsert(orderindex* idx, task* t);
+int orderIndexBuild(orderindex* idx, task** sorted, int count);
+void orderIndexPut(orderindex* idx, ordernode* node);
+ordernode* orderIndexTake(orderindex* idx, task* t);
+void orderIndexRemove(orderindex* idx, task* t);
+void orderIterBegin(orderiter* it, orderindex* idx);
+task* orderIterPeek(orderiter* it);
+task* orderIterNext(orderiter* it);
+void freeOrderIndex(orderindex* idx);
+
+#endif
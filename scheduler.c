@@ -4,6 +4,59 @@
 #include <time.h>
 #include "scheduler.h"
 #include "task_management.h"
+#include "journal.h"
+
+// Days before the first of each month, for common and leap years
+static const int cumulativeDays[2][13] = {
+    {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365},
+    {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366}
+};
+
+// Days from 01/01/0001 to 01/01 of a year (proleptic Gregorian)
+#define DAYS_BEFORE_YEAR(y) ((y - 1) * 365 + (y - 1) / 4 - (y - 1) / 100 + (y - 1) / 400)
+
+// Serial day 0 is 01/01/1900, the earliest date isValidDate() accepts
+#define SERIAL_EPOCH_YEAR 1900
+
+static int isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+}
+
+/*
+dateToDays() - Converts a date to its serial day number
+ - Table lookup plus arithmetic; exact across month and year boundaries
+ - Time: O(1), Space: O(1)
+ - Sample Case:
+    Input: {1, 1, 1900} -> 0, {31, 12, 2025} -> 46020, {1, 1, 2026} -> 46021
+ */
+int dateToDays(date d) {
+    if (d.month < 1 || d.month > 12) {
+        return 0;
+    }
+    return DAYS_BEFORE_YEAR(d.year) - DAYS_BEFORE_YEAR(SERIAL_EPOCH_YEAR)
+           + cumulativeDays[isLeapYear(d.year)][d.month - 1] + d.day - 1;
+}
+
+/*
+daysToDate() - Inverse of dateToDays()
+ - Year from the 400-year cycle length, month from the cumulative table
+ - Time: O(1) (at most 12 table steps), Space: O(1)
+ - Example: daysToDate(46021) -> {1, 1, 2026}
+ */
+date daysToDate(int days) {
+    int n = days + DAYS_BEFORE_YEAR(SERIAL_EPOCH_YEAR);   // days since 01/01/0001
+    int year = (int)((long long)n * 400 / 146097) + 1;
+    while (DAYS_BEFORE_YEAR(year + 1) <= n) year++;
+    while (DAYS_BEFORE_YEAR(year) > n) year--;
+
+    int day_of_year = n - DAYS_BEFORE_YEAR(year);
+    const int* table = cumulativeDays[isLeapYear(year)];
+    int month = 1;
+    while (day_of_year >= table[month]) month++;
+
+    date d = {day_of_year - table[month - 1] + 1, month, year};
+    return d;
+}
 
 /*
 compareDates() - Compares two dates
@@ -15,9 +68,35 @@ compareDates() - Compares two dates
     Output: -5 (d1 is earlier than d2)
  */
 int compareDates(date d1, date d2) {
-    if (d1.year != d2.year) return d1.year - d2.year;
-    if (d1.month != d2.month) return d1.month - d2.month;
-    return d1.day - d2.day;
+    return dateToDays(d1) - dateToDays(d2);
+}
+
+/*
+taskDueDate() - Returns the due date of a task as a date struct
+ - Time: O(1), Space: O(1)
+ */
+date taskDueDate(const task* t) {
+    return daysToDate((int)t->due);
+}
+
+/*
+daysUntilDue() - Days from today to a task's due date (negative when overdue)
+ - One integer subtraction on the stored serial day
+ - Time: O(1), Space: O(1)
+ - Example: due 05/05/2025, today 01/05/2025 -> 4
+ */
+int daysUntilDue(const task* t, date today) {
+    return (int)t->due - dateToDays(today);
+}
+
+/*
+isDueSoon() - Checks if a task is due within threshold days (today included)
+ - Time: O(1), Space: O(1)
+ - Example: isDueSoon(t, today, 2) -> true if t is due today, tomorrow or the day after
+ */
+int isDueSoon(const task* t, date today, int daysThreshold) {
+    int days = daysUntilDue(t, today);
+    return days >= 0 && days <= daysThreshold;
 }
 
 /*
@@ -43,14 +122,9 @@ int isValidDate(int day, int month, int year) {
     if (year < 1900 || month < 1 || month > 12 || day < 1)
         return 0;
         
-    // Days in each month
-    int daysInMonth[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    
-    // Adjust for leap years
-    if (month == 2 && ((year % 4 == 0 && year % 100 != 0) || (year % 400 == 0)))
-        daysInMonth[2] = 29;
-        
-    return day <= daysInMonth[month];
+    // Days in the month, from the cumulative table
+    const int* table = cumulativeDays[isLeapYear(year)];
+    return day <= table[month] - table[month - 1];
 }
 
 /*
@@ -60,9 +134,8 @@ setDueDate() - Sets due date for a task
  */
 void setDueDate(task* t, int day, int month, int year) {
     if (t) {
-        t->duedate.day = day;
-        t->duedate.month = month;
-        t->duedate.year = year;
+        date d = {day, month, year};
+        t->due = (unsigned int)dateToDays(d);
         t->due_date_set = 1;
     }
 }
@@ -71,117 +144,149 @@ void setDueDate(task* t, int day, int month, int year) {
 
 /*
 adjustPriority() - Upgrades overdue tasks to high priority
- - Time: O(n), Space: O(1)
- - Example: adjustPriority(tasks, today) -> overdue tasks become priority 1
+ - Time: O(n + changed·log n), Space: O(1)
+ - Example: adjustPriority(&tasks, today) -> overdue tasks become priority 1
  */
-void adjustPriority(task* head, date today) {
-    while (head) {
-        if (!head->completed && head->due_date_set && compareDates(today, head->duedate) > 0 && head->priority != 1) {
-            head->priority = 1;
-            printf("Priority adjusted to HIGH for overdue task: %s\n", head->name);
+void adjustPriority(tasklist* list, date today) {
+    unsigned int today_days = (unsigned int)dateToDays(today);
+    for (task* current = list->head; current; current = current->next) {
+        if (!current->completed && current->due_date_set && today_days > current->due && current->priority != 1) {
+            if (!setTaskPriority(list, current, 1)) {
+                printf("Memory allocation failed.\n");
+                return;
+            }
+            printf("Priority adjusted to HIGH for overdue task: %s\n", taskName(current));
         }
-        head = head->next;
     }
 }
 
 /*
 clearcompletedtask() - Removes all completed tasks
+ - Tasks go back to the task slab one by one; the log arrays are freed
  - Time: O(n), Space: O(1)
  - Sample Case:
-    Before: Stack with 3 completed tasks
-    After: Empty stack
+    Before: Log with 3 completed tasks
+    After: Empty log
     Output: "All completed tasks cleared."
  */
-void clearcompletedtask(stacknode** top_ptr) { 
-    stacknode* current = *top_ptr;
-    stacknode* temp;
-
-    if (current == NULL) {
+void clearcompletedtask(completionlog* done) { 
+    if (done->count == 0) {
         printf("No completed tasks to clear.\n");
         return;
     }
 
     printf("Clearing all completed tasks...\n");
-    while (current != NULL) {
-        temp = current;
-        current = current->next;
 
-        // Free the dynamically allocated task data first
-        if (temp->task_data) { 
-            free(temp->task_data);
-        }
-        // free the stack node itself
-        free(temp);
-    }
+    // Free the task records back to the slab and cold store, then the log itself
+    freeCompleted(done);
+    journalClear();
 
-    *top_ptr = NULL; // Set the top pointer to NULL
     printf("All completed tasks cleared.\n");
 }
 
 
 /*
 updateTaskStatuses() - Updates task status based on due date
- - Time: O(n), Space: O(1)
- - Example: updateTaskStatuses(tasks, today) -> marks overdue tasks
+ - Moving the date forward pops only the tasks whose due day has just
+   passed off the due tracker; asking again for the same day does nothing
+ - Moving the date back (simulated day change) walks the list once and
+   returns overdue tasks that are no longer late to PENDING
+ - Time: O(1) for the same day, O(k log n) for k newly overdue tasks,
+   O(n log n) worst case when the date moves back; Space: O(1)
+ - Example: updateTaskStatuses(&tasks, today) -> marks overdue tasks
  */
-void updateTaskStatuses(task* head, date today) {
-    task* current = head;
-    while (current) {
-        if (!current->completed && current->due_date_set) {
-            // Check if task is overdue
-            if (compareDates(today, current->duedate) > 0) {
-                current->status = OVERDUE;
-            } 
-            // Check if task is due soon (within 2 days)
-            else if (isDateSoon(today, current->duedate, 2)) {
-                current->status = PENDING;  // Still pending but will mark as urgent in display
+void updateTaskStatuses(tasklist* list, date today) {
+    duetracker* dt = &list->due;
+    unsigned int today_days = (unsigned int)dateToDays(today);
+    if (today_days == dt->today) {
+        return;
+    }
+
+    if (today_days < dt->today) {
+        dt->rewinds++;
+        dt->today = today_days;
+        for (task* current = list->head; current; current = current->next) {
+            if (!current->completed && current->due_date_set &&
+                current->status == OVERDUE && current->due >= today_days) {
+                // Re-tracking sets the status for the new day; with room
+                // reserved and the view order node reused it cannot fail
+                if (!dueTrackerReserve(dt)) {
+                    printf("Memory allocation failed.\n");
+                    continue;
+                }
+                ordernode* node = orderIndexTake(&list->order, current);
+                dueTrackerRemove(dt, current);
+                dueTrackerInsert(dt, current);
+                orderIndexPut(&list->order, node);
             }
         }
-        current = current->next;
+        return;
+    }
+
+    dt->advances++;
+    dt->today = today_days;
+    task* current;
+    while ((current = dueTrackerPopOverdue(dt, today_days)) != NULL) {
+        setTaskStatus(list, current, OVERDUE);
     }
 }
 
+
+// qsort comparator: newest linked first, i.e. list order
+static int compareNewestFirst(const void* a, const void* b) {
+    const task* ta = *(task* const*)a;
+    const task* tb = *(task* const*)b;
+    return (ta->seq < tb->seq) - (ta->seq > tb->seq);
+}
+
 /*
 autoPriorityAdjust() - Auto-adjusts priority based on due date
- - Time: O(n), Space: O(1)
+ - Tasks due within 2 days (or overdue) are raised to HIGH priority
+ - Only the tasks popped off the due tracker's priority heap are touched;
+   they are reported in list order
+ - Time: O(k log n) for k raised tasks, Space: O(k)
  - Sample Case:
     Input: Task "Essay" with Medium priority, due tomorrow
     Output:
       "Priority for 'Essay' auto-adjusted to HIGH"
       Task priority changed from 2 to 1
  */
-void autoPriorityAdjust(task* head, date today) {
-    task* current = head;
-    while (current) {
-        if (!current->completed && current->due_date_set) {
-            // Calculate days until due
-            int daysUntilDue = getDaysBetween(today, current->duedate);
-            
-            // Auto-adjust priority based on due date
-            if (daysUntilDue < 0) {
-                // Overdue tasks are always high priority
-                if (current->priority != 1) {
-                    current->priority = 1;
-                    printf("Priority for '%s' auto-adjusted to HIGH \n", current->name);
-                }
-            }
-            else if (daysUntilDue <= 2) {
-                // Tasks due within 2 days are at least medium priority
-                if (current->priority > 1) {
-                    current->priority = 1;
-                    printf("Priority for '%s' auto-adjusted to HIGH \n", current->name);
-                }
-            }
-            else if (daysUntilDue <= 1) {
-                // Tasks due tomorrow are high priority
-                if (current->priority != 1) {
-                    current->priority = 1;
-                    printf("Priority for '%s' auto-adjusted to HIGH \n", current->name);
+void autoPriorityAdjust(tasklist* list, date today) {
+    unsigned int today_days = (unsigned int)dateToDays(today);
+    task** raised = NULL;
+    int count = 0, capacity = 0;
+
+    task* current;
+    while ((current = dueTrackerPopUrgent(&list->due, today_days)) != NULL) {
+        if (count == capacity) {
+            int new_capacity = capacity ? capacity * 2 : 16;
+            task** grown = (task**)realloc(raised, new_capacity * sizeof(task*));
+            if (!grown) {
+                // Out of memory: raise it right away, outside list order
+                if (setTaskPriority(list, current, 1)) {
+                    printf("Priority for '%s' auto-adjusted to HIGH \n", taskName(current));
+                } else {
+                    printf("Memory allocation failed.\n");
                 }
+                continue;
             }
+            raised = grown;
+            capacity = new_capacity;
+        }
+        raised[count++] = current;
+    }
+
+    if (count > 1) {
+        qsort(raised, count, sizeof(task*), compareNewestFirst);
+    }
+    for (int i = 0; i < count; i++) {
+        if (!setTaskPriority(list, raised[i], 1)) {
+            printf("Memory allocation failed.\n");
+            continue;
         }
-        current = current->next;
+        printf("Priority for '%s' auto-adjusted to HIGH \n", taskName(raised[i]));
     }
+    free(raised);
 }
 
 /*
@@ -194,62 +299,59 @@ getDaysBetween() - Calculates days between two dates
     Output: 4 (days difference)
  */
 int getDaysBetween(date d1, date d2) {
-    // Check if dates are valid
-    
-    // Approximate days in each month (ignoring leap years)
-    const int daysInMonth[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    
-    // Convert dates to days since year 0 
-    int days1 = d1.year * 365 + d1.day;
-    int days2 = d2.year * 365 + d2.day;
-    
-    // Add days for months
-    for (int i = 1; i < d1.month; i++) days1 += daysInMonth[i];
-    for (int i = 1; i < d2.month; i++) days2 += daysInMonth[i];
-    
-    // Add leap years 
-    days1 += d1.year / 4;
-    days2 += d2.year / 4;
-    
-    return days2 - days1;
+    return dateToDays(d2) - dateToDays(d1);
 }
 
 /*
-isDateSoon() - Checks if date is within threshold days
+isDateSoon() - Checks if date is within threshold days (today included)
  - Time: O(1), Space: O(1)
  - Example: isDateSoon(today, duedate, 2) -> true if due within 2 days
  */
 int isDateSoon(date today, date duedate, int daysThreshold) {
-    // Check if due date is valid
-    
-    // If years are different
-    if (duedate.year > today.year) {
-        if (duedate.month == 1 && today.month == 12) {
-            // Special case: December -> January transition
-            return (31 - today.day + duedate.day) <= daysThreshold;
-        }
-        return 0; // Not soon if more than a month away
+    int days = dateToDays(duedate) - dateToDays(today);
+    return days >= 0 && days <= daysThreshold;
+}
+
+// Status groups of simulateDayChange()
+#define DAY_CHANGE_OVERDUE 0
+#define DAY_CHANGE_URGENT 1
+#define DAY_CHANGE_NORMAL 2
+
+
+// Group of a pending dated task on the new date, or -1 for the other tasks
+static int dayChangeKind(const task* t, date today, unsigned int today_days) {
+    if (t->completed || !t->due_date_set) {
+        return -1;
     }
-    
-    // If within same year but different months
-    if (duedate.month > today.month) {
-        if (duedate.month - today.month == 1) {
-            // Tasks due early next month
-            int daysInCurrentMonth;
-            switch (today.month) {
-                case 2: daysInCurrentMonth = 28; break; // Simplified, ignoring leap years
-                case 4: case 6: case 9: case 11: daysInCurrentMonth = 30; break;
-                default: daysInCurrentMonth = 31;
-            }
-            return (daysInCurrentMonth - today.day + duedate.day) <= daysThreshold;
+    if (today_days > t->due) {
+        return DAY_CHANGE_OVERDUE;
+    }
+    return isDueSoon(t, today, 2) ? DAY_CHANGE_URGENT : DAY_CHANGE_NORMAL;
+}
+
+
+// Prints the tasks of one group in list order, numbered from count; returns the next number
+static int printDayChangeTasks(tasklist* list, date today, unsigned int today_days, int kind,
+                               const char* label, int count) {
+    for (task* current = list->head; current; current = current->next) {
+        if (dayChangeKind(current, today, today_days) != kind) {
+            continue;
         }
-        return 0; // Not soon if more than a month away
+        char priority_str[10];
+        switch(current->priority) {
+            case 1: strcpy(priority_str, "High"); break;
+            case 2: strcpy(priority_str, "Medium"); break;
+            case 3: strcpy(priority_str, "Low"); break;
+            default: strcpy(priority_str, "Unknown");
+        }
+        date due = taskDueDate(current);
+        printf("%-5d %-25s %-10s %02d/%02d/%04d %s\n", count++, taskName(current), priority_str,
+               due.day, due.month, due.year, label);
     }
-    
-    // Same month, just compare days
-    return (duedate.day - today.day) <= daysThreshold && (duedate.day - today.day) >= 0;
+    return count;
 }
 
+
 /*
 simulateDayChange() - Changes system date for testing
  - Time: O(n), Space: O(n)
@@ -266,7 +368,7 @@ simulateDayChange() - Changes system date for testing
       Overdue tasks: 1
       Urgent tasks: 1
  */
-void simulateDayChange(task* head, date* currentDate) {
+void simulateDayChange(tasklist* list, date* currentDate) {
     date newDate;
     
     printf("\n=== Simulate Day Change ===\n");
@@ -293,35 +395,24 @@ void simulateDayChange(task* head, date* currentDate) {
     printf("\nDate changed to: %02d/%02d/%04d\n", currentDate->day, currentDate->month, currentDate->year);
     
     
-    updateTaskStatuses(head, newDate);
+    updateTaskStatuses(list, newDate);
     
     // Auto-adjust priorities based on due dates
-    autoPriorityAdjust(head, newDate);
+    autoPriorityAdjust(list, newDate);
     
-    // Create arrays to store tasks by status
-    task* overdue_tasks[100];
-    task* urgent_tasks[100];
-    task* normal_tasks[100];
-    int overdue_count = 0;
-    int urgent_count = 0;
-    int normal_count = 0;
-    
-    // Categorize tasks
-    task* current = head;
-    while (current) {
-        if (!current->completed && current->due_date_set) {
-            if (compareDates(newDate, current->duedate) > 0) {
-                overdue_tasks[overdue_count++] = current;
-            } 
-            else if (isDateSoon(newDate, current->duedate, 2)) {
-                urgent_tasks[urgent_count++] = current;
-            }
-            else {
-                normal_tasks[normal_count++] = current;
-            }
+    // Count the tasks by status, then list the overdue and the urgent ones
+    // in a pass each, so a list of any size needs no buffers
+    unsigned int new_days = (unsigned int)dateToDays(newDate);
+    int counts[3] = {0, 0, 0};
+    for (task* current = list->head; current; current = current->next) {
+        int kind = dayChangeKind(current, newDate, new_days);
+        if (kind >= 0) {
+            counts[kind]++;
         }
-        current = current->next;
     }
+    int overdue_count = counts[DAY_CHANGE_OVERDUE];
+    int urgent_count = counts[DAY_CHANGE_URGENT];
+    int normal_count = counts[DAY_CHANGE_NORMAL];
     
     
     printf("\n=== Task Status Overview ===\n");
@@ -333,45 +424,13 @@ void simulateDayChange(task* head, date* currentDate) {
     // show overdue tasks
     if (overdue_count > 0) {
         printf("\n--- OVERDUE TASKS ---\n");
-        for (int i = 0; i < overdue_count; i++) {
-            char priority_str[10];
-            switch(overdue_tasks[i]->priority) {
-                case 1: strcpy(priority_str, "High"); break;
-                case 2: strcpy(priority_str, "Medium"); break;
-                case 3: strcpy(priority_str, "Low"); break;
-                default: strcpy(priority_str, "Unknown");
-            }
-            
-            printf("%-5d %-25s %-10s %02d/%02d/%04d OVERDUE\n", 
-                   count++, 
-                   overdue_tasks[i]->name, 
-                   priority_str,
-                   overdue_tasks[i]->duedate.day, 
-                   overdue_tasks[i]->duedate.month, 
-                   overdue_tasks[i]->duedate.year);
-        }
+        count = printDayChangeTasks(list, newDate, new_days, DAY_CHANGE_OVERDUE, "OVERDUE", count);
     }
     
     // show urgent tasks
     if (urgent_count > 0) {
         printf("\n--- URGENT TASKS (Due within 2 days) ---\n");
-        for (int i = 0; i < urgent_count; i++) {
-            char priority_str[10];
-            switch(urgent_tasks[i]->priority) {
-                case 1: strcpy(priority_str, "High"); break;
-                case 2: strcpy(priority_str, "Medium"); break;
-                case 3: strcpy(priority_str, "Low"); break;
-                default: strcpy(priority_str, "Unknown");
-            }
-            
-            printf("%-5d %-25s %-10s %02d/%02d/%04d URGENT\n", 
-                   count++, 
-                   urgent_tasks[i]->name, 
-                   priority_str,
-                   urgent_tasks[i]->duedate.day, 
-                   urgent_tasks[i]->duedate.month, 
-                   urgent_tasks[i]->duedate.year);
-        }
+        count = printDayChangeTasks(list, newDate, new_days, DAY_CHANGE_URGENT, "URGENT", count);
     }
     
     // Show summary in a clean format
@@ -405,11 +464,6 @@ isDateWithinDays() - Checks if date within range
     Output: 1 (date is within 7 days)
  */
 int isDateWithinDays(date today, date check_date, int days) {
-    // Calculate total days for both dates 
-    int today_days = today.year * 365 + today.month * 30 + today.day;
-    int check_days = check_date.year * 365 + check_date.month * 30 + check_date.day;
-    
-    // Check if the date is within the specified range
-    int diff = check_days - today_days;
+    int diff = dateToDays(check_date) - dateToDays(today);
     return (diff >= 0 && diff <= days);
 }
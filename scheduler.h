@@ -3,7 +3,8 @@
 
 
 typedef struct task task;
-typedef struct stacknode stacknode;
+typedef struct tasklist tasklist;
+typedef struct completionlog completionlog;
 
 
 typedef enum {
@@ -20,14 +21,19 @@ typedef struct {
 
 
 int compareDates(date d1, date d2);
+int dateToDays(date d);
+date daysToDate(int days);
+date taskDueDate(const task* t);
+int daysUntilDue(const task* t, date today);
+int isDueSoon(const task* t, date today, int daysThreshold);
 date getToday();
 void setDueDate(task* t, int day, int month, int year);
-void simulateDayChange(task* head, date* currentDate);
-void adjustPriority(task* head, date today);
-void autoPriorityAdjust(task* head, date today);  
+void simulateDayChange(tasklist* list, date* currentDate);
+void adjustPriority(tasklist* list, date today);
+void autoPriorityAdjust(tasklist* list, date today);  
 int getDaysBetween(date d1, date d2);  
-void clearcompletedtask(stacknode** completedstack);
-void updateTaskStatuses(task* head, date today);
+void clearcompletedtask(completionlog* done);
+void updateTaskStatuses(tasklist* list, date today);
 int isDateSoon(date today, date duedate, int daysThreshold);
 
 // checking if a date is valid
@@ -1,15 +1,257 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <stdbool.h>
 #include "scheduler.h"       
 #include "task_management.h"
 #include "searchandstat.h"
+#include "textsearch.h"
+#include "epoch.h"
+
+
+/*
+keywordMatches() - Exact check of one task for the name (1), description (2),
+   all-fields keyword (7) and all-fields ignoring case (8) searches
+ - Name and description lengths come from the arena, so the SIMD kernel
+   reads them without a strlen() first; search 8 uses the case-folding one
+ - Safe on a reader thread: the fields are read with coldText()
+ - Time: O(text length), Space: O(1)
+*/
+static int keywordMatches(task* t, int search_option, const char* keyword) {
+    size_t keyword_len = strlen(keyword);
+    taskcold* cold = taskCold(t);
+    arenastr name = coldText(cold, &cold->name);
+    arenastr description = coldText(cold, &cold->description);
+    substringfn find = search_option == 8 ? findSubstringNoCase : findSubstring;
+    switch (search_option) {
+        case 1:
+            return find(arenaString(name), name.length, keyword, keyword_len) != NULL;
+        case 2:
+            return find(arenaString(description), description.length, keyword, keyword_len) != NULL;
+        default:
+            if (find(arenaString(name), name.length, keyword, keyword_len) ||
+                find(arenaString(description), description.length, keyword, keyword_len)) {
+                return 1;
+            }
+            for (int i = 0; i < taskTagCount(t); i++) {
+                const char* tag = taskTagName(t, i);
+                if (find(tag, strlen(tag), keyword, keyword_len)) {
+                    return 1;
+                }
+            }
+            return 0;
+    }
+}
+
+
+static void printKeywordMatch(task* t, int search_option) {
+    printTaskInfo(t);
+    // Keyword search also shows the tags
+    if (search_option >= 7 && taskTagCount(t) > 0) {
+        printf("Tags: ");
+        writeTaskTags(stdout, t);
+        printf("\n");
+        printf("-------------------------\n");
+    }
+}
+
+
+// qsort comparator: pending tasks in list order, then completed tasks most recent first
+static int compareSearchOrder(const void* a, const void* b) {
+    const task* ta = *(task* const*)a;
+    const task* tb = *(task* const*)b;
+    if (ta->completed != tb->completed) {
+        return ta->completed - tb->completed;
+    }
+    return (ta->seq < tb->seq) - (ta->seq > tb->seq);
+}
+
+
+// Appends t to a growing match array; 0 if memory ran out
+static int appendMatch(task*** matches, int* count, int* capacity, task* t) {
+    if (*count == *capacity) {
+        int new_capacity = *capacity ? *capacity * 2 : 16;
+        task** grown = (task**)realloc(*matches, new_capacity * sizeof(task*));
+        if (!grown) {
+            return 0;
+        }
+        *matches = grown;
+        *capacity = new_capacity;
+    }
+    (*matches)[(*count)++] = t;
+    return 1;
+}
+
+
+static int comparePointers(const void* a, const void* b) {
+    const task* ta = *(task* const*)a;
+    const task* tb = *(task* const*)b;
+    return (ta > tb) - (ta < tb);
+}
+
+
+/*
+dropRepeatedMatches() - Keeps the first of each task in a match array
+ - A reader scanning beside the writer sees a task completed mid-scan both
+   in the list and in the completion log
+ - Time: O(m log m), Space: O(m)
+ - Returns the new count (unchanged if memory ran out)
+ */
+static int dropRepeatedMatches(task** matches, int count) {
+    task** sorted = (task**)malloc(count * sizeof(task*));
+    if (!sorted) {
+        return count;
+    }
+    memcpy(sorted, matches, count * sizeof(task*));
+    qsort(sorted, count, sizeof(task*), comparePointers);
+    int repeated = 0;
+    for (int i = 1; i < count && !repeated; i++) {
+        repeated = sorted[i] == sorted[i - 1];
+    }
+    if (!repeated) {
+        free(sorted);
+        return count;
+    }
+    unsigned char* seen = (unsigned char*)calloc(count, 1);
+    if (!seen) {
+        free(sorted);
+        return count;
+    }
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        task** slot = (task**)bsearch(&matches[i], sorted, count, sizeof(task*), comparePointers);
+        while (slot > sorted && slot[-1] == matches[i]) {
+            slot--;
+        }
+        if (!seen[slot - sorted]) {
+            seen[slot - sorted] = 1;
+            matches[kept++] = matches[i];
+        }
+    }
+    free(seen);
+    free(sorted);
+    return kept;
+}
+
+
+/*
+scanKeywordMatches() - Checks every pending and completed task for a keyword
+ - The fallback of collectKeywordMatches(); touches nothing but the tasks,
+   so reader threads of the server run it inside a read section
+ - Pending tasks come first in list order, then completed ones most recent first;
+   a task completed during a reader's scan is kept where it was seen first
+ - Time: O(n · text length), Space: O(matches)
+ - Returns the number of matches (*out must be freed), or -1 if memory ran out
+ */
+int scanKeywordMatches(task* head, completionlog* done, int search_option, const char* keyword, task*** out) {
+    task** matches = NULL;
+    int matched = 0, capacity = 0;
+    *out = NULL;
+    for (task* t = head; t; t = EPOCH_LOAD(t->next)) {
+        if (keywordMatches(t, search_option, keyword) && !appendMatch(&matches, &matched, &capacity, t)) {
+            free(matches);
+            return -1;
+        }
+    }
+    // The count is published after its entry, so load it before the entries
+    int count = EPOCH_LOAD(done->count);
+    completion* entries = EPOCH_LOAD(done->entries);
+    for (int i = count - 1; i >= 0; i--) {
+        task* t = entries[i].task_data;
+        if (keywordMatches(t, search_option, keyword) && !appendMatch(&matches, &matched, &capacity, t)) {
+            free(matches);
+            return -1;
+        }
+    }
+    if (epochShared() && matched > 1) {
+        matched = dropRepeatedMatches(matches, matched);
+    }
+    *out = matches;
+    return matched;
+}
+
+
+/*
+collectKeywordMatches() - Pending and completed tasks matching a keyword, in listing order
+ - search_option is 1 (name), 2 (description), 7 (all fields, tags included)
+   or 8 (all fields, ignoring ASCII case)
+ - Keywords of 3+ characters only check the candidates from the trigram
+   index; shorter ones, and search 8 (the index is case-sensitive), scan
+   every pending and completed task
+ - Reader threads of the server run it inside a read section (see textIndexQuery())
+ - Pending tasks come first in list order, then completed ones most recent first
+ - Time: O(candidates · text length + m log m) for m matches, O(n · text length) for short keywords;
+   Space: O(candidates)
+ - Returns the number of matches (*out must be freed), or -1 if memory ran out
+ - Example: collectKeywordMatches(tasks.head, &doneLog, 7, "report", &matches)
+ */
+int collectKeywordMatches(task* head, completionlog* done, int search_option, const char* keyword,
+                          task*** out) {
+    task** candidates;
+    int count = search_option == 8 ? -1 : textIndexQuery(keyword, &candidates);
+    *out = NULL;
+
+    if (count < 0) {
+        // Too short for the index, or ignoring case: check every task
+        return scanKeywordMatches(head, done, search_option, keyword, out);
+    }
+
+    // Keep exact matches only, then restore the usual listing order
+    int matches = 0;
+    for (int i = 0; i < count; i++) {
+        if (keywordMatches(candidates[i], search_option, keyword)) {
+            candidates[matches++] = candidates[i];
+        }
+    }
+    if (matches > 1) {
+        qsort(candidates, matches, sizeof(task*), compareSearchOrder);
+        // A reader may get a task twice if it was re-indexed mid-query
+        int unique = 1;
+        for (int i = 1; i < matches; i++) {
+            if (candidates[i] != candidates[unique - 1]) {
+                candidates[unique++] = candidates[i];
+            }
+        }
+        matches = unique;
+    }
+    *out = candidates;
+    return matches;
+}
+
+
+/*
+searchByKeyword() - Prints pending and completed tasks matching a keyword
+ - Time: as collectKeywordMatches(), Space: O(candidates)
+ - Returns 1 if anything matched
+ */
+static int searchByKeyword(task* head, completionlog* done, int search_option, const char* keyword) {
+    task** matches;
+    int count = collectKeywordMatches(head, done, search_option, keyword, &matches);
+    if (count < 0) {
+        printf("Memory allocation failed. Search aborted.\n");
+        return 0;
+    }
+
+    int i = 0;
+    printf("--- Pending Tasks ---\n");
+    for (; i < count && !matches[i]->completed; i++) {
+        printKeywordMatch(matches[i], search_option);
+    }
+    printf("--- Completed Tasks ---\n");
+    for (; i < count; i++) {
+        printKeywordMatch(matches[i], search_option);
+    }
+    free(matches);
+    return count > 0;
+}
 
 
 /*
 searchTasks() - Search tasks by multiple criteria
- - Time: O(n), Space: O(1)
+ - Name, description and keyword searches go through the trigram index;
+   the keyword search ignoring case scans with the case-folding kernel
+ - Time: O(n) for the other criteria, Space: O(1)
  - Sample Case:
     Input:
       Choice: 7 (Keyword search)
@@ -24,7 +266,7 @@ searchTasks() - Search tasks by multiple criteria
       Name: Project Proposal
       -------------------------
  */
-void searchTasks(task* head, completedstack* stack, const char* keyword) {
+void searchTasks(task* head, completionlog* done, const char* keyword) {
     int found = 0;
     int search_option;
     int min_priority = 0, max_priority = 0;
@@ -41,7 +283,8 @@ void searchTasks(task* head, completedstack* stack, const char* keyword) {
     printf("5. Due Date Range\n");
     printf("6. Tasks with No Due Date\n");
     printf("7. Keyword (search all fields)\n");
-    printf("Enter your choice (1-7): ");
+    printf("8. Keyword, ignoring case (search all fields)\n");
+    printf("Enter your choice (1-8): ");
     
     if (fgets(buffer, sizeof(buffer), stdin) == NULL || sscanf(buffer, "%d", &search_option) != 1) {
         printf("Invalid input. Search aborted.\n");
@@ -68,30 +311,7 @@ void searchTasks(task* head, completedstack* stack, const char* keyword) {
             
             printf("\n=== Search Results for '%s' ===\n", new_keyword);
             
-            // Search pending tasks
-            printf("--- Pending Tasks ---\n");
-            task* current = head;
-            while (current) {
-                if ((search_option == 1 && strstr(current->name, new_keyword)) ||
-                    (search_option == 2 && strstr(current->description, new_keyword))) {
-                    printTaskInfo(current);
-                    found = 1;
-                }
-                current = current->next;
-            }
-            
-            // Search completed tasks
-            printf("--- Completed Tasks ---\n");
-            stacknode* node = stack->top;
-            while (node) {
-                task* t = node->task_data;
-                if ((search_option == 1 && strstr(t->name, new_keyword)) ||
-                    (search_option == 2 && strstr(t->description, new_keyword))) {
-                    printTaskInfo(t);
-                    found = 1;
-                }
-                node = node->next;
-            }
+            found = searchByKeyword(head, done, search_option, new_keyword);
             break;
             
         case 3: // Priority Range
@@ -118,7 +338,7 @@ void searchTasks(task* head, completedstack* stack, const char* keyword) {
             
             // Search pending tasks
             printf("--- Pending Tasks ---\n");
-            current = head;
+            task* current = head;
             while (current) {
                 if (current->priority >= min_priority && current->priority <= max_priority) {
                     printTaskInfo(current);
@@ -129,14 +349,12 @@ void searchTasks(task* head, completedstack* stack, const char* keyword) {
             
             // Search completed tasks
             printf("--- Completed Tasks ---\n");
-            node = stack->top;
-            while (node) {
-                task* t = node->task_data;
+            for (int i = done->count - 1; i >= 0; i--) {
+                task* t = done->entries[i].task_data;
                 if (t->priority >= min_priority && t->priority <= max_priority) {
                     printTaskInfo(t);
                     found = 1;
                 }
-                node = node->next;
             }
             break;
             
@@ -167,17 +385,15 @@ void searchTasks(task* head, completedstack* stack, const char* keyword) {
                   (search_status == PENDING) ? "Pending" : 
                   (search_status == COMPLETED) ? "Completed" : "Overdue");
             
-            // For completed tasks : search the stack
+            // For completed tasks : search the completion log
             if (search_status == COMPLETED) {
                 printf("--- Completed Tasks ---\n");
-                stacknode* status_node = stack->top;
-                while (status_node) {
-                    task* t = status_node->task_data;
+                for (int i = done->count - 1; i >= 0; i--) {
+                    task* t = done->entries[i].task_data;
                     if (t->status == search_status) {
                         printTaskInfo(t);
                         found = 1;
                     }
-                    status_node = status_node->next;
                 }
             } else {
                 // For PENDING/OVERDUE : search the main list
@@ -225,14 +441,17 @@ void searchTasks(task* head, completedstack* stack, const char* keyword) {
                    start_date.day, start_date.month, start_date.year,
                    end_date.day, end_date.month, end_date.year);
             
+            // Packed dates compare like the dates themselves
+            unsigned int start_days = (unsigned int)dateToDays(start_date);
+            unsigned int end_days = (unsigned int)dateToDays(end_date);
+            
             // Search pending tasks
             printf("--- Pending Tasks ---\n");
             task* date_current = head;
             while (date_current) {
                 if (date_current->due_date_set) {
                     // Check if task due date is within range
-                    if (compareDates(date_current->duedate, start_date) >= 0 && 
-                        compareDates(date_current->duedate, end_date) <= 0) {
+                    if (date_current->due >= start_days && date_current->due <= end_days) {
                         printTaskInfo(date_current);
                         found = 1;
                     }
@@ -242,18 +461,15 @@ void searchTasks(task* head, completedstack* stack, const char* keyword) {
             
             // Search completed tasks
             printf("--- Completed Tasks ---\n");
-            stacknode* date_node = stack->top;
-            while (date_node) {
-                task* t = date_node->task_data;
+            for (int i = done->count - 1; i >= 0; i--) {
+                task* t = done->entries[i].task_data;
                 if (t->due_date_set) {
                     // Check if task due date is within range
-                    if (compareDates(t->duedate, start_date) >= 0 && 
-                        compareDates(t->duedate, end_date) <= 0) {
+                    if (t->due >= start_days && t->due <= end_days) {
                         printTaskInfo(t);
                         found = 1;
                     }
                 }
-                date_node = date_node->next;
             }
             break;
             
@@ -273,18 +489,17 @@ void searchTasks(task* head, completedstack* stack, const char* keyword) {
             
             // Search completed tasks
             printf("--- Completed Tasks ---\n");
-            stacknode* nodate_node = stack->top;
-            while (nodate_node) {
-                task* t = nodate_node->task_data;
+            for (int i = done->count - 1; i >= 0; i--) {
+                task* t = done->entries[i].task_data;
                 if (!t->due_date_set) {
                     printTaskInfo(t);
                     found = 1;
                 }
-                nodate_node = nodate_node->next;
             }
             break;
             
         case 7: // Keyword search
+        case 8: // Keyword search ignoring case
             printf("Enter keyword to search in all fields: ");
             if (fgets(new_keyword, sizeof(new_keyword), stdin) == NULL) {
                 printf("Error reading keyword. Search aborted.\n");
@@ -294,95 +509,7 @@ void searchTasks(task* head, completedstack* stack, const char* keyword) {
             
             printf("\n=== Keyword Search Results for '%s' ===\n", new_keyword);
             
-            // Search pending tasks
-            printf("--- Pending Tasks ---\n");
-            task* keyword_current = head;
-            while (keyword_current) {
-                // Check name, description, and tags
-                int found_in_task = 0;
-                
-                // Check name
-                if (strstr(keyword_current->name, new_keyword)) {
-                    found_in_task = 1;
-                }
-                
-                // Check description
-                if (!found_in_task && strstr(keyword_current->description, new_keyword)) {
-                    found_in_task = 1;
-                }
-                
-                // Check tags
-                if (!found_in_task) {
-                    for (int i = 0; i < keyword_current->tag_count; i++) {
-                        if (strstr(keyword_current->tags[i], new_keyword)) {
-                            found_in_task = 1;
-                            break;
-                        }
-                    }
-                }
-                
-                if (found_in_task) {
-                    printTaskInfo(keyword_current);
-                    // Add tag information to output
-                    if (keyword_current->tag_count > 0) {
-                        printf("Tags: ");
-                        for (int i = 0; i < keyword_current->tag_count; i++) {
-                            printf("%s%s", keyword_current->tags[i], 
-                                  (i < keyword_current->tag_count - 1) ? ", " : "\n");
-                        }
-                        printf("-------------------------\n");
-                    }
-                    found = 1;
-                }
-                
-                keyword_current = keyword_current->next;
-            }
-            
-            // Search completed tasks
-            printf("--- Completed Tasks ---\n");
-            stacknode* keyword_node = stack->top;
-            while (keyword_node) {
-                task* t = keyword_node->task_data;
-                
-                // Check name, description, and tags
-                int found_in_task = 0;
-                
-                // Check name
-                if (strstr(t->name, new_keyword)) {
-                    found_in_task = 1;
-                }
-                
-                // Check description
-                if (!found_in_task && strstr(t->description, new_keyword)) {
-                    found_in_task = 1;
-                }
-                
-                // Check tags
-                if (!found_in_task) {
-                    for (int i = 0; i < t->tag_count; i++) {
-                        if (strstr(t->tags[i], new_keyword)) {
-                            found_in_task = 1;
-                            break;
-                        }
-                    }
-                }
-                
-                if (found_in_task) {
-                    printTaskInfo(t);
-                    // Add tag information to output
-                    if (t->tag_count > 0) {
-                        printf("Tags: ");
-                        for (int i = 0; i < t->tag_count; i++) {
-                            printf("%s%s", t->tags[i], 
-                                  (i < t->tag_count - 1) ? ", " : "\n");
-                        }
-                        printf("-------------------------\n");
-                    }
-                    found = 1;
-                }
-                
-                keyword_node = keyword_node->next;
-            }
+            found = searchByKeyword(head, done, search_option, new_keyword);
             break;
             
         default:
@@ -410,8 +537,8 @@ printTaskInfo() - Displays detailed task information
       -------------------------
  */
 void printTaskInfo(task* t) {
-    printf("Name: %s\n", t->name);
-    printf("Description: %s\n", t->description);
+    printf("Name: %s\n", taskName(t));
+    printf("Description: %s\n", taskDescription(t));
     printf("Priority: %d (%s)\n", t->priority, 
            (t->priority == 1) ? "High" : (t->priority == 2) ? "Medium" : "Low");
     printf("Status: %s\n", 
@@ -419,7 +546,7 @@ void printTaskInfo(task* t) {
            (t->status == COMPLETED) ? "Completed" : "Overdue");
     if (t->due_date_set) {
         printf("Due Date: %02d/%02d/%04d\n", 
-               t->duedate.day, t->duedate.month, t->duedate.year);
+               taskDueDate(t).day, taskDueDate(t).month, taskDueDate(t).year);
     } else {
         printf("Due Date: Not Set\n");
     }
@@ -430,19 +557,20 @@ void printTaskInfo(task* t) {
 /*
 showStats() - Shows overall task statistics
  - Time: O(n), Space: O(1)
- - Example: showStats(tasks, stack, today) -> "Total: 10, Completed: 50%"
+ - Example: showStats(tasks, &doneLog, today) -> "Total: 10, Completed: 50%"
  */
-void showStats(task* head, completedstack* stack, date today) {
+void showStats(task* head, completionlog* done, date today) {
     int total = 0, completed = 0, pending = 0, overdue = 0;
+    unsigned int today_days = (unsigned int)dateToDays(today);
     
-    // Count pending and overdue tasks
+    // Count pending and overdue tasks (hot records only)
     task* p = head;
     while (p) {
         if (p->completed) {
             
             completed++;
         } else if (p->status == OVERDUE || 
-                   (p->due_date_set && compareDates(today, p->duedate) > 0)) {
+                   (p->due_date_set && today_days > p->due)) {
             overdue++;
         } else {
             pending++;
@@ -450,14 +578,8 @@ void showStats(task* head, completedstack* stack, date today) {
         p = p->next;
     }
     
-    // Count completed tasks in stack
-    stacknode* s = stack->top;
-    while (s) {
-        if (s->task_data) {
-            completed++;
-        }
-        s = s->next;
-    }
+    // Completed tasks are all in the log
+    completed += done->count;
     
     // Total tasks
     total = pending + completed + overdue;
@@ -496,49 +618,25 @@ void showStats(task* head, completedstack* stack, date today) {
 
 /*
 doneToday() - Shows tasks completed today
- - Time: O(n), Space: O(1)
- - Example: doneToday(&tasks, &stack) -> lists today's completed tasks
+ - Binary search for today's first entry in the completion log, then a
+   walk over today's entries only (newest first)
+ - Time: O(log days + k) for k tasks completed today, Space: O(1)
+ - Example: doneToday(&doneLog, today) -> lists today's completed tasks
  */
-void doneToday(tasklist* list, completedstack* stack) {
-    date today = getToday();
+void doneToday(completionlog* done, date today) {
+    int first = completionLogFirstFrom(done, (unsigned int)dateToDays(today));
     int count = 0;
     
     printf("\n=== Tasks Completed Today (%02d/%02d/%04d) ===\n", 
            today.day, today.month, today.year);
     
-    // Update task statuses before checking
-    
-    // check pending tasks
-    task* current = list->head;
-    while (current) {
-        if (current->completed && current->status == COMPLETED) {
-            
-            printf("Task: %s\n", current->name);
-            printf("Description: %s\n", current->description);
-            printf("Priority: %d\n", current->priority);
-            printf("-------------------------\n");
-            count++;
-        }
-        current = current->next;
-    }
-    
-    // check completed tasks in the stack
-    stacknode* node = stack->top;
-    while (node) {
-        if (node->task_data) {
-            // Assuming the task in the stack is completed today
-            printf("Task: %s\n", node->task_data->name);
-            printf("Description: %s\n", node->task_data->description);
-            printf("Priority: %d\n", node->task_data->priority);
-            printf("-------------------------\n");
-            count++;
-            
-            // Limit to top 5 most recently completed tasks
-            if (count >= 5) {
-                break; 
-            }
-        }
-        node = node->next;
+    for (int i = done->count - 1; i >= first; i--) {
+        task* t = done->entries[i].task_data;
+        printf("Task: %s\n", taskName(t));
+        printf("Description: %s\n", taskDescription(t));
+        printf("Priority: %d\n", t->priority);
+        printf("-------------------------\n");
+        count++;
     }
     
     if (count == 0) {
@@ -563,7 +661,7 @@ show_combined_stats() - Menu for all/weekly/monthly stats
       
       [====!    ] 40.0% completed
  */
-void show_combined_stats(task* head, completedstack* stack, date today) {
+void show_combined_stats(task* head, completionlog* done, date today) {
     int choice;
     char buffer[10];
     
@@ -580,17 +678,17 @@ void show_combined_stats(task* head, completedstack* stack, date today) {
     
     switch(choice) {
         case 1:
-            showStats(head, stack, today);  // Original all times stats function
+            showStats(head, done, today);  // Original all times stats function
             break;
         case 2:
-            show_time_stats(head, stack, today, 0);  // Weekly stats 
+            show_time_stats(head, done, today, 0);  // Weekly stats 
             break;
         case 3:
-            show_time_stats(head, stack, today, 1);  // Monthly stats 
+            show_time_stats(head, done, today, 1);  // Monthly stats 
             break;
         default:
             printf("Invalid option. Showing all-time statistics.\n");
-            showStats(head, stack, today);
+            showStats(head, done, today);
     }
 }
 
@@ -598,9 +696,10 @@ void show_combined_stats(task* head, completedstack* stack, date today) {
 /*
 show_time_stats() - Shows stats for specific period
  - Time: O(n), Space: O(1)
- - Example: show_time_stats(tasks, stack, today, 0) -> weekly stats
+ - Completions in the period are a range count on the completion log
+ - Example: show_time_stats(tasks, &doneLog, today, 0) -> weekly stats
  */
-void show_time_stats(task* head, completedstack* stack, date today, int period) {
+void show_time_stats(task* head, completionlog* done, date today, int period) {
     int total = 0, completed = 0, pending = 0, overdue = 0;
     int high_priority = 0, medium_priority = 0, low_priority = 0;
     
@@ -612,7 +711,7 @@ void show_time_stats(task* head, completedstack* stack, date today, int period)
     // Count pending and overdue tasks for the specified period
     task* p = head;
     while (p) {
-        if (p->due_date_set && isDateWithinDays(today, p->duedate, days_period)) {
+        if (p->due_date_set && isDateWithinDays(today, taskDueDate(p), days_period)) {
             if (p->completed) {
                 completed++;
             } else if (p->status == OVERDUE) {
@@ -631,16 +730,10 @@ void show_time_stats(task* head, completedstack* stack, date today, int period)
         p = p->next;
     }
     
-    // Count completed tasks in stack for the specified period
-    int stack_items = 0;
-    stacknode* s = stack->top;
-    while (s && stack_items < days_period) { 
-        if (s->task_data) {
-            completed++;
-        }
-        stack_items++;
-        s = s->next;
-    }
+    // Count tasks completed in the last days_period days (today included)
+    unsigned int today_days = (unsigned int)dateToDays(today);
+    unsigned int first_day = today_days >= (unsigned int)days_period ? today_days - days_period + 1 : 0;
+    completed += completionLogCountRange(done, first_day, today_days);
     
     // Total tasks
     total = pending + completed + overdue;
@@ -5,13 +5,16 @@
 #include "task_management.h"
 
 
-void searchTasks(task* head, completedstack* stack, const char* keyword);
-void showStats(task* head, completedstack* stack, date today);
-void show_time_stats(task* head, completedstack* stack, date today, int period);
-void doneToday(tasklist* list, completedstack* stack);
+void searchTasks(task* head, completionlog* done, const char* keyword);
+int scanKeywordMatches(task* head, completionlog* done, int search_option, const char* keyword, task*** out);
+int collectKeywordMatches(task* head, completionlog* done, int search_option, const char* keyword,
+                          task*** out);
+void showStats(task* head, completionlog* done, date today);
+void show_time_stats(task* head, completionlog* done, date today, int period);
+void doneToday(completionlog* done, date today);
 void printTaskInfo(task* t);
 
 
-void show_combined_stats(task* head, completedstack* stack, date today);
+void show_combined_stats(task* head, completionlog* done, date today);
 
 #endif 
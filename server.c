@@ -0,0 +1,1079 @@
+#define _GNU_SOURCE  // accept4(), EPOLLEXCLUSIVE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "server.h"
+#include "scheduler.h"
+#include "checkpoint.h"
+#include "epoch.h"
+#include "journal.h"
+
+static volatile sig_atomic_t serverStop = 0;
+
+// Marks the wake-up eventfd in a worker's epoll set (the listening socket is NULL)
+static char serverWakeEvent;
+
+
+static double serverSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+static void stopServer(int signal_number) {
+    (void)signal_number;
+    serverStop = 1;
+}
+
+
+/*
+serverThreadCount() - Number of worker threads
+ - TODO_SERVER_THREADS overrides the default of one per online CPU
+ - Time: O(1), Space: O(1)
+ - Example: TODO_SERVER_THREADS=4 ./todo_progress --serve -> 4 workers
+ */
+static int serverThreadCount(void) {
+    const char* setting = getenv("TODO_SERVER_THREADS");
+    long threads = setting ? strtol(setting, NULL, 10) : 0;
+    if (threads < 1) {
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+    return threads > SERVER_MAX_THREADS ? SERVER_MAX_THREADS : (int)threads;
+}
+
+
+/*
+serverSocketPath() - Socket the server listens on and the load generator connects to
+ - TODO_SOCKET overrides SERVER_DEFAULT_SOCKET
+ - Time: O(1), Space: O(1)
+ */
+const char* serverSocketPath(void) {
+    const char* path = getenv("TODO_SOCKET");
+    return path && path[0] ? path : SERVER_DEFAULT_SOCKET;
+}
+
+
+/*
+serverListen() - Binds a non-blocking listening socket at path
+ - A socket file left behind by a server that is gone is replaced; one
+   that still accepts connections is not. Called before the tasks are
+   loaded, so a second server never touches the first one's files
+ - Time: O(1), Space: O(1)
+ - Returns the socket, or -1 with errno set
+ */
+int serverListen(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    struct stat info;
+    if (lstat(path, &info) == 0 && S_ISSOCK(info.st_mode)) {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int in_use = probe >= 0 && connect(probe, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+        if (probe >= 0) {
+            close(probe);
+        }
+        if (in_use) {
+            errno = EADDRINUSE;
+            return -1;
+        }
+        unlink(path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SERVER_BACKLOG) != 0) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
+
+
+// Registers the events c should be woken for, if they changed. With none
+// (a command is with the owner) c leaves the set, so a hang-up is not
+// reported over and over meanwhile
+static void watchClient(serverworker* w, serverclient* c, unsigned int events) {
+    if (events == c->events) {
+        return;
+    }
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.ptr = c;
+    int op = events == 0 ? EPOLL_CTL_DEL : c->events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    epoll_ctl(w->epoll_fd, op, c->fd, &ev);
+    c->events = events;
+}
+
+
+/*
+openClient() - Sets up a connection that was just accepted by w
+ - Time: O(1), Space: O(1) until it sends something
+ - Returns 0 (and closes fd) if it could not be set up
+ */
+static int openClient(serverworker* w, int fd) {
+    server* s = w->s;
+    serverclient* c = (serverclient*)calloc(1, sizeof(serverclient));
+    if (!c) {
+        close(fd);
+        return 0;
+    }
+    c->fd = fd;
+    c->out = open_memstream(&c->out_data, &c->out_size);
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = c;
+    if (!c->out || epoll_ctl(w->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        if (c->out) {
+            fclose(c->out);
+            free(c->out_data);
+        }
+        free(c);
+        close(fd);
+        return 0;
+    }
+    c->events = EPOLLIN;
+    batchrun run = {s->shards, s->shard_count, NULL, NULL, getToday(), c->out, 0, 0, w->reader, 0, 0};
+    c->run = run;
+    c->worker = w;
+
+    c->next = w->clients;
+    if (w->clients) {
+        w->clients->prev = c;
+    }
+    w->clients = c;
+    w->accepted++;
+    long active = __atomic_add_fetch(&s->active, 1, __ATOMIC_RELAXED);
+    long peak = __atomic_load_n(&s->peak, __ATOMIC_RELAXED);
+    while (active > peak &&
+           !__atomic_compare_exchange_n(&s->peak, &peak, active, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    return 1;
+}
+
+
+static void closeClient(serverworker* w, serverclient* c) {
+    epoll_ctl(w->epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    fclose(c->out);
+    free(c->out_data);
+    free(c->in);
+    if (c->prev) {
+        c->prev->next = c->next;
+    } else {
+        w->clients = c->next;
+    }
+    if (c->next) {
+        c->next->prev = c->prev;
+    }
+    w->commands += c->run.commands;
+    w->failed += c->run.failed;
+    w->reads += c->run.reads;
+    __atomic_sub_fetch(&w->s->active, 1, __ATOMIC_RELAXED);
+    free(c);
+}
+
+
+// Accepts every connection waiting on the listening socket
+static void acceptClients(serverworker* w) {
+    while (1) {
+        int fd = accept4(w->s->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("Failed to accept a connection");
+            }
+            return;
+        }
+        openClient(w, fd);
+    }
+}
+
+
+/*
+queueCommand() - Hands a command line of c to the owner thread of what it changes
+ - A named list has one owner; a shard of the default list has its own, and
+   a command on several shards goes to the first (see applyCommands())
+ - c runs no further lines until the answer is back (see takeAnswers())
+ - Time: O(line length) plus the wait if the queue is full, Space: O(line length)
+ - Returns 0 if memory ran out (the line is then answered with an error)
+ */
+static int queueCommand(serverworker* w, serverclient* c, const char* line, size_t length) {
+    servercommand* command = (servercommand*)malloc(sizeof(servercommand) + length + 1);
+    if (!command) {
+        return 0;
+    }
+    command->client = c;
+    command->next = NULL;
+    command->stores = c->run.stores;
+    command->store_count = c->run.store_count;
+    command->shard = batchLineShard(line, length, c->run.store_count);
+    serverowner* owner = c->named ? c->named->owner : &w->s->owners[command->shard < 0 ? 0 : command->shard];
+    command->answer = NULL;
+    command->answer_size = 0;
+    command->length = length;
+    memcpy(command->line, line, length);
+    command->line[length] = '\0';
+    c->pending = 1;
+    w->in_flight++;
+    w->queued++;
+    taskQueuePush(&owner->commands, command);
+    return 1;
+}
+
+
+/*
+openNamedList() - Finds the list called name, opening it on first use
+ - Its files are <name>.snap and <name>.journal in taskStoreListDir()
+   (not kept when snapshots or the journal are off); the directory is
+   made if it is missing. Loading holds the registry, so other first uses
+   wait for it
+ - Each list is given to an owner by name hash and stays open until the
+   server stops
+ - Time: O(1) average once open, O(list size) to load, Space: O(list size)
+ - Returns the list, or NULL if it could not be opened
+ */
+static serverlist* openNamedList(server* s, const char* name) {
+    unsigned int hash = hashTaskName(name);
+    serverlist** bucket = &s->lists[hash % SERVER_LIST_BUCKETS];
+    pthread_mutex_lock(&s->lists_lock);
+    serverlist* list = *bucket;
+    while (list && strcmp(list->store->name, name) != 0) {
+        list = list->next;
+    }
+    if (list) {
+        pthread_mutex_unlock(&s->lists_lock);
+        return list;
+    }
+
+    if (mkdir(taskStoreListDir(), 0755) != 0 && errno != EEXIST) {
+        perror("Failed to make the list directory");
+        pthread_mutex_unlock(&s->lists_lock);
+        return NULL;
+    }
+    char* snapshot = snapshotPath() ? taskStoreListPath(name, "snap") : NULL;
+    char* journal = journalPath() ? taskStoreListPath(name, "journal") : NULL;
+    char* copy = strdup(name);
+    list = (serverlist*)calloc(1, sizeof(serverlist));
+    taskstore* store = copy && list && (snapshot || !snapshotPath()) && (journal || !journalPath())
+                           ? taskStoreCreate(snapshot, journal) : NULL;
+    free(snapshot);
+    free(journal);
+    if (!store) {
+        free(copy);
+        free(list);
+        pthread_mutex_unlock(&s->lists_lock);
+        return NULL;
+    }
+    store->name = copy;
+    taskStoreLoad(store);
+    taskStoreReady(store);
+    fflush(stdout);
+
+    list->store = store;
+    list->owner = &s->owners[hash % (unsigned int)s->owner_count];
+    list->next = *bucket;
+    *bucket = list;
+    list->owner_next = __atomic_load_n(&list->owner->lists, __ATOMIC_RELAXED);
+    __atomic_store_n(&list->owner->lists, list, __ATOMIC_RELEASE);
+    s->list_count++;
+    pthread_mutex_unlock(&s->lists_lock);
+    return list;
+}
+
+
+/*
+useList() - Runs a use line of c: "use\t<name>" picks a named list, "use" the default list
+ - Later lines of c run on that list; the answer is "ok" or an error
+ - Time: O(1) average once the list is open, Space: O(1)
+ */
+static void useList(server* s, serverclient* c, char* line, size_t length) {
+    while (length > 0 && line[length - 1] == '\r') {
+        line[--length] = '\0';
+    }
+    const char* error = NULL;
+    if (length == 3) {
+        c->named = NULL;
+        c->run.stores = s->shards;
+        c->run.store_count = s->shard_count;
+    } else if (!taskStoreValidName(line + 4)) {
+        error = "bad list name";
+    } else {
+        serverlist* list = openNamedList(s, line + 4);
+        if (list) {
+            c->named = list;
+            c->run.stores = &list->store;
+            c->run.store_count = 1;
+        } else {
+            error = "cannot open list";
+        }
+    }
+    if (error) {
+        fprintf(c->out, "error %s\n", error);
+        c->run.failed++;
+    } else {
+        fputs("ok\n", c->out);
+    }
+    c->run.commands++;
+}
+
+
+// Whether a line (its newline cut off) is a use command
+static int isUseLine(const char* line, size_t length) {
+    while (length > 0 && line[length - 1] == '\r') {
+        length--;
+    }
+    return length >= 3 && memcmp(line, "use", 3) == 0 && (length == 3 || line[3] == '\t');
+}
+
+
+/*
+runClientLines() - Runs the complete lines received from c, in order
+ - Reads and use lines are answered here; the first write is queued for
+   its owner and the lines after it wait for its answer. A partial last
+   line is kept
+ - Time: O(bytes received) plus the reads run, Space: O(1)
+ */
+static void runClientLines(serverworker* w, serverclient* c) {
+    char* start = c->in;
+    char* end = c->in + c->in_used;
+    char* newline;
+    while (!c->pending && start < end && (newline = (char*)memchr(start, '\n', end - start))) {
+        size_t length = (size_t)(newline - start);
+        if (isUseLine(start, length)) {
+            *newline = '\0';
+            useList(w->s, c, start, length);
+        } else if (batchLineAccess(start, length) != BATCH_WRITE) {
+            *newline = '\0';
+            batchExecute(&c->run, start, length);
+        } else if (!queueCommand(w, c, start, length)) {
+            fprintf(c->out, "error out of memory\n");
+            c->run.commands++;
+            c->run.failed++;
+        }
+        start = newline + 1;
+    }
+    c->in_used = (size_t)(end - start);
+    memmove(c->in, start, c->in_used);
+    fflush(c->out);
+}
+
+
+/*
+readClient() - Reads what c sent and runs the complete commands in it
+ - Stops at EAGAIN, at end of input, once a command of c is with the
+   owner, or once SERVER_OUTPUT_LIMIT bytes of answers are waiting to be sent
+ - Time: O(bytes read) plus the commands, Space: O(longest line)
+ - Returns 0 if the connection has to be closed
+ */
+static int readClient(serverworker* w, serverclient* c) {
+    while (!c->pending && c->out_size - c->out_sent < SERVER_OUTPUT_LIMIT) {
+        if (c->in_capacity - c->in_used < SERVER_READ_CHUNK) {
+            size_t new_capacity = c->in_used + SERVER_READ_CHUNK;
+            char* grown = (char*)realloc(c->in, new_capacity);
+            if (!grown) {
+                return 0;
+            }
+            c->in = grown;
+            c->in_capacity = new_capacity;
+        }
+        ssize_t n = read(c->fd, c->in + c->in_used, SERVER_READ_CHUNK);
+        if (n > 0) {
+            c->in_used += (size_t)n;
+            w->bytes_in += (unsigned long long)n;
+            runClientLines(w, c);
+            if (!c->pending && c->in_used > SERVER_MAX_LINE) {
+                return 0;
+            }
+            continue;
+        }
+        if (n == 0) {
+            c->closing = 1;
+            return 1;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    return 1;
+}
+
+
+/*
+writeClient() - Sends as many of c's waiting answers as the socket takes
+ - Once everything is sent the stream is rewound, so its buffer is reused
+ - Time: O(bytes sent), Space: O(1)
+ - Returns 0 if the connection has to be closed
+ */
+static int writeClient(serverworker* w, serverclient* c) {
+    while (c->out_sent < c->out_size) {
+        ssize_t n = send(c->fd, c->out_data + c->out_sent, c->out_size - c->out_sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            c->out_sent += (size_t)n;
+            w->bytes_out += (unsigned long long)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return 1;
+        }
+        return 0;
+    }
+    if (c->out_size > 0) {
+        rewind(c->out);
+        fflush(c->out);
+        c->out_sent = 0;
+    }
+    return 1;
+}
+
+
+/*
+settleClient() - Sends what c has waiting, then closes it or picks the events to wait for
+ - ok is 0 when reading failed. A client with a command at the owner is
+   never closed here: the answer comes back to it (see takeAnswers())
+ - Reads only while nothing is pending and fewer than SERVER_OUTPUT_LIMIT
+   bytes of answers wait, writes while any do
+ - Time: O(bytes sent), Space: O(1)
+ */
+static void settleClient(serverworker* w, serverclient* c, int ok) {
+    if (ok && !c->broken) {
+        ok = writeClient(w, c);
+    }
+    if (!ok) {
+        c->broken = 1;
+    }
+    size_t waiting = c->out_size - c->out_sent;
+    if (!c->pending && (c->broken || (c->closing && waiting == 0))) {
+        closeClient(w, c);
+        return;
+    }
+
+    int read_more = !c->closing && !c->broken && !c->pending && waiting < SERVER_OUTPUT_LIMIT;
+    if (!c->closing && waiting >= SERVER_OUTPUT_LIMIT && (c->events & EPOLLIN)) {
+        w->paused++;
+    }
+    watchClient(w, c, (read_more ? EPOLLIN : 0) | (waiting && !c->broken ? EPOLLOUT : 0));
+}
+
+
+/*
+serveClient() - Handles one epoll event of a connection
+ - Time: O(bytes moved) plus the commands, Space: O(1)
+ */
+static void serveClient(serverworker* w, serverclient* c, unsigned int ready) {
+    int ok = !(ready & EPOLLERR);
+    if (ok && (c->events & EPOLLIN) && (ready & (EPOLLIN | EPOLLHUP | EPOLLRDHUP))) {
+        ok = readClient(w, c);
+    }
+    settleClient(w, c, ok);
+}
+
+
+/*
+takeAnswers() - Gives back the answers the owner finished for w's clients
+ - Each answer goes after what its client already has waiting; unless
+   the worker is stopping, the client's lines after it run next
+ - Time: O(answers + the lines run after them), Space: O(1)
+ */
+static void takeAnswers(serverworker* w, int stopping) {
+    unsigned long long count;
+    if (read(w->wake_fd, &count, sizeof(count)) < 0) {
+        // Nothing written since the last read: the answers were already taken
+    }
+    servercommand* finished = __atomic_exchange_n(&w->finished, NULL, __ATOMIC_ACQUIRE);
+    while (finished) {
+        servercommand* command = finished;
+        finished = command->next;
+        serverclient* c = command->client;
+        if (command->answer_size > 0) {
+            fwrite(command->answer, 1, command->answer_size, c->out);
+        }
+        free(command->answer);
+        free(command);
+        c->pending = 0;
+        w->in_flight--;
+        if (stopping) {
+            fflush(c->out);
+            continue;
+        }
+        runClientLines(w, c);
+        settleClient(w, c, 1);
+    }
+}
+
+
+/*
+runWorker() - Thread body: one epoll loop over the listening socket and its own connections
+ - Every worker waits on the listening socket (EPOLLEXCLUSIVE wakes one of
+   them per connection) and keeps the connections it accepted
+ - Runs until stop is set, then waits for the answers of the commands it
+   queued, answers what it can and closes
+ - Time: O(1) per event plus the commands, Space: O(its connections + waiting bytes)
+ */
+static void* runWorker(void* arg) {
+    serverworker* w = (serverworker*)arg;
+    struct epoll_event events[SERVER_EVENTS];
+    while (!__atomic_load_n(&w->stop, __ATOMIC_ACQUIRE)) {
+        int ready = epoll_wait(w->epoll_fd, events, SERVER_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Event loop failed");
+            break;
+        }
+        // Answers may close other clients, so they wait until every
+        // client event of this round has been handled
+        int woken = 0;
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.ptr == &serverWakeEvent) {
+                woken = 1;
+            } else if (!events[i].data.ptr) {
+                acceptClients(w);
+            } else {
+                serveClient(w, (serverclient*)events[i].data.ptr, events[i].events);
+            }
+        }
+        if (woken) {
+            takeAnswers(w, 0);
+        }
+    }
+
+    while (w->in_flight > 0) {
+        struct pollfd wake = {w->wake_fd, POLLIN, 0};
+        poll(&wake, 1, -1);
+        takeAnswers(w, 1);
+    }
+    __atomic_sub_fetch(&w->s->running, 1, __ATOMIC_RELEASE);
+    while (w->clients) {
+        if (!w->clients->broken) {
+            writeClient(w, w->clients);
+        }
+        closeClient(w, w->clients);
+    }
+    return NULL;
+}
+
+
+/*
+openWorker() - Gives a worker its epoll set, wake-up eventfd and epoch slot
+ - Time: O(1), Space: O(1)
+ - Returns 0 if any of them could not be set up (nothing is left open)
+ */
+static int openWorker(server* s, serverworker* w) {
+    memset(w, 0, sizeof(*w));
+    w->s = s;
+    w->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    w->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    w->reader = epochRegister();
+
+    struct epoll_event listen_ev, wake_ev;
+    memset(&listen_ev, 0, sizeof(listen_ev));
+    listen_ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+    listen_ev.data.ptr = NULL;  // the listening socket
+    memset(&wake_ev, 0, sizeof(wake_ev));
+    wake_ev.events = EPOLLIN;
+    wake_ev.data.ptr = &serverWakeEvent;
+    if (w->epoll_fd >= 0 && w->wake_fd >= 0 && w->reader >= 0 &&
+        epoll_ctl(w->epoll_fd, EPOLL_CTL_ADD, s->listen_fd, &listen_ev) == 0 &&
+        epoll_ctl(w->epoll_fd, EPOLL_CTL_ADD, w->wake_fd, &wake_ev) == 0) {
+        return 1;
+    }
+    if (w->epoll_fd >= 0) close(w->epoll_fd);
+    if (w->wake_fd >= 0) close(w->wake_fd);
+    epochUnregister(w->reader);
+    return 0;
+}
+
+
+static void closeWorker(serverworker* w) {
+    close(w->epoll_fd);
+    close(w->wake_fd);
+    epochUnregister(w->reader);
+}
+
+
+static void wakeWorker(serverworker* w) {
+    unsigned long long one = 1;
+    if (write(w->wake_fd, &one, sizeof(one)) < 0) {
+        // The eventfd is already signalled; the worker wakes either way
+    }
+}
+
+
+// Takes the locks of the other shards' owners for a command on every shard
+// (the first owner only); owners past the shards only hold named lists
+static void lockOtherOwners(server* s) {
+    for (int i = 1; i < s->shard_count; i++) {
+        pthread_mutex_lock(&s->owners[i].apply);
+    }
+}
+
+
+static void unlockOtherOwners(server* s) {
+    for (int i = s->shard_count - 1; i >= 1; i--) {
+        pthread_mutex_unlock(&s->owners[i].apply);
+    }
+}
+
+
+// Lets go of the journal held for held, indexes any deferred tasks and
+// reclaims what its readers have moved past
+static void releaseStore(taskstore* held) {
+    if (held) {
+        taskStoreUse(held);
+        journalRelease();
+        textIndexFlush();
+        epochReclaim();
+    }
+}
+
+
+/*
+applyCommands() - Applies a batch of queued commands on an owner thread
+ - Each command sees the ones before it, as if one client had sent them
+   all. The journal of a store is held while commands in a row change it,
+   memory the readers have moved past is reclaimed once after them, and
+   each worker is woken once for all of its answers
+ - A command on every shard (first owner only) runs with the locks of
+   the other shards' owners taken, so no shard is changing meanwhile
+ - Time: O(count) plus the commands, Space: O(answers)
+ */
+static void applyCommands(serverowner* o, servercommand** batch, int count) {
+    server* s = o->s;
+    taskstore* held = NULL;
+    pthread_mutex_lock(&o->apply);
+    for (int i = 0; i < count; i++) {
+        servercommand* command = batch[i];
+        taskstore* store = command->shard == BATCH_ALL_SHARDS ? NULL : command->stores[command->shard];
+        if (store != held) {
+            releaseStore(held);
+            held = store;
+            if (held) {
+                taskStoreUse(held);
+                journalHold();
+            }
+        }
+        o->run.stores = command->stores;
+        o->run.store_count = command->store_count;
+        if (!store) {
+            lockOtherOwners(s);
+        }
+        batchExecute(&o->run, command->line, command->length);
+        if (!store) {
+            for (int k = 0; k < command->store_count; k++) {
+                taskStoreUse(command->stores[k]);
+                epochReclaim();
+            }
+            unlockOtherOwners(s);
+        }
+        fflush(o->out);
+        if (o->out_size > 0) {
+            command->answer = (char*)malloc(o->out_size);
+            if (command->answer) {
+                memcpy(command->answer, o->out_data, o->out_size);
+                command->answer_size = o->out_size;
+            }
+            rewind(o->out);
+            fflush(o->out);
+        }
+    }
+    releaseStore(held);
+    pthread_mutex_unlock(&o->apply);
+
+    unsigned char woken[SERVER_MAX_THREADS] = {0};
+    for (int i = 0; i < count; i++) {
+        servercommand* command = batch[i];
+        serverworker* w = command->client->worker;
+        command->next = __atomic_load_n(&w->finished, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&w->finished, &command->next, command, 1, __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED)) {
+        }
+        woken[w - s->workers] = 1;
+    }
+    for (int i = 0; i < s->worker_count; i++) {
+        if (woken[i]) {
+            wakeWorker(&s->workers[i]);
+        }
+    }
+}
+
+
+// The periodic work on one store: today's statuses, a checkpoint, the
+// text indexing a restore deferred (reader searches scan until then), reclaiming
+static void tickStore(taskstore* store, date today) {
+    taskStoreUse(store);
+    if (dateToDays(today) != dateToDays(store->today)) {
+        store->today = today;
+        updateTaskStatuses(&store->list, today);
+    }
+    checkpointPoll(&store->list, &store->done);
+    textIndexFlush();
+    epochReclaim();
+}
+
+
+/*
+serverTick() - An owner's periodic work between batches, on every store it owns
+ - Moves the statuses on when the date changes and polls for a checkpoint
+ - Time: O(stores + changed statuses), Space: O(1)
+ */
+static void serverTick(serverowner* o) {
+    server* s = o->s;
+    date today = getToday();
+    o->run.today = today;
+    pthread_mutex_lock(&o->apply);
+    if (o->index < s->shard_count) {
+        tickStore(s->shards[o->index], today);
+    }
+    for (serverlist* list = __atomic_load_n(&o->lists, __ATOMIC_ACQUIRE); list; list = list->owner_next) {
+        tickStore(list->store, today);
+    }
+    pthread_mutex_unlock(&o->apply);
+}
+
+
+/*
+runOwner() - An owner thread's loop: applies queued commands in batches
+ - Drains up to TASKQUEUE_BATCH commands at a time, sleeping on the queue
+   while it is empty, and runs serverTick() every SERVER_TICK_MS
+ - Runs until a stop signal, or with stopping set until every worker has
+   had the answers to all it queued (see runServer())
+ - Time: O(1) per command plus the commands, Space: O(TASKQUEUE_BATCH)
+ */
+static void runOwner(serverowner* o, int stopping) {
+    server* s = o->s;
+    void* batch[TASKQUEUE_BATCH];
+    double next_tick = serverSeconds();  // at once: a restore may have deferred text indexing
+    while (stopping ? __atomic_load_n(&s->running, __ATOMIC_ACQUIRE) > 0 : !serverStop) {
+        int count = taskQueueDrain(&o->commands, batch, TASKQUEUE_BATCH);
+        if (count > 0) {
+            applyCommands(o, (servercommand**)batch, count);
+        }
+        double now = serverSeconds();
+        if (now >= next_tick) {
+            serverTick(o);
+            next_tick = now + SERVER_TICK_MS / 1000.0;
+        } else if (count == 0) {
+            int wait_ms = stopping ? SERVER_STOP_WAIT_MS : (int)((next_tick - now) * 1000.0) + 1;
+            taskQueueWait(&o->commands, wait_ms);
+        }
+    }
+}
+
+
+// Thread body of every owner but the first: runs until the stop signal,
+// then until the workers have had every answer
+static void* runOwnerThread(void* arg) {
+    serverowner* o = (serverowner*)arg;
+    runOwner(o, 0);
+    runOwner(o, 1);
+    return NULL;
+}
+
+
+/*
+serverOwnerCount() - Number of owner threads
+ - TODO_SERVER_OWNERS overrides the default of one per shard; there are
+   never fewer owners than shards
+ - Time: O(1), Space: O(1)
+ - Example: TODO_SHARDS=4 TODO_SERVER_OWNERS=8 ./todo_progress --serve -> 8 owners
+ */
+static int serverOwnerCount(int shard_count) {
+    const char* setting = getenv("TODO_SERVER_OWNERS");
+    long owners = setting ? strtol(setting, NULL, 10) : 0;
+    if (owners < shard_count) {
+        owners = shard_count;
+    }
+    return owners > SERVER_MAX_OWNERS ? SERVER_MAX_OWNERS : (int)owners;
+}
+
+
+/*
+openOwner() - Gives an owner its command queue, answer stream and lock
+ - Time: O(TASKQUEUE_CAPACITY), Space: O(TASKQUEUE_CAPACITY)
+ - Returns 0 if any of them could not be set up (nothing is left open)
+ */
+static int openOwner(server* s, serverowner* o, int index) {
+    memset(o, 0, sizeof(*o));
+    o->s = s;
+    o->index = index;
+    o->out = open_memstream(&o->out_data, &o->out_size);
+    if (!o->out) {
+        return 0;
+    }
+    if (!taskQueueInit(&o->commands, TASKQUEUE_CAPACITY)) {
+        fclose(o->out);
+        free(o->out_data);
+        return 0;
+    }
+    batchrun run = {s->shards, s->shard_count, NULL, NULL, getToday(), o->out, 0, 0, -1, 0, 0};
+    o->run = run;
+    pthread_mutex_init(&o->apply, NULL);
+    return 1;
+}
+
+
+static void closeOwner(serverowner* o) {
+    taskQueueFree(&o->commands);
+    fclose(o->out);
+    free(o->out_data);
+    pthread_mutex_destroy(&o->apply);
+}
+
+
+// Sums the reclamation counters of a store into total
+static void addEpochCounters(epochlimbo* total, const taskstore* store) {
+    total->retired += store->limbo.retired;
+    total->released += store->limbo.released;
+    total->peak_pending += store->limbo.peak_pending;
+    total->synchronizes += store->limbo.synchronizes;
+}
+
+
+/*
+closeNamedLists() - Closes every named list (see taskStoreClose()) once the server has stopped
+ - A list left empty is not saved and its files are removed, as using it
+   again starts it empty anyway; a load generator's scratch list so leaves
+   nothing behind
+ - Time: O(lists + their tasks), Space: O(1)
+ */
+static void closeNamedLists(server* s, epochlimbo* epochs) {
+    for (int b = 0; b < SERVER_LIST_BUCKETS; b++) {
+        while (s->lists[b]) {
+            serverlist* list = s->lists[b];
+            s->lists[b] = list->next;
+            taskstore* store = list->store;
+            addEpochCounters(epochs, store);
+            char* snapshot = NULL;
+            char* journal = NULL;
+            if (!EPOCH_LOAD(store->list.head) && store->done.count == 0) {
+                snapshot = store->snapshot_path;
+                journal = store->journal_path;  // the journal keeps using it until closed
+                store->snapshot_path = NULL;
+                store->journal_path = NULL;
+            }
+            taskStoreClose(store);
+            if (snapshot) {
+                unlink(snapshot);
+            }
+            if (journal) {
+                unlink(journal);
+            }
+            free(snapshot);
+            free(journal);
+            free(list);
+        }
+    }
+}
+
+
+/*
+runServer() - Serves the default list (shard_count shards) and any named lists until SIGINT or SIGTERM
+ - Starts serverThreadCount() workers (see runWorker()) and
+   serverOwnerCount() owners; this thread is the first owner (see runOwner())
+ - listen_fd comes from serverListen(); it is closed and path removed on
+   return. Named lists are closed on return; the shards are the caller's
+ - Time: O(1) per event plus the commands, Space: O(connections + waiting bytes)
+ - Returns 1 after a clean shutdown, 0 if the threads could not be set up
+ */
+int runServer(taskstore** shards, int shard_count, int listen_fd, const char* path) {
+    server* sp = (server*)calloc(1, sizeof(server));
+    if (!sp) {
+        perror("Failed to set up the server");
+        close(listen_fd);
+        unlink(path);
+        return 0;
+    }
+    server* s = sp;
+    s->path = path;
+    s->shards = shards;
+    s->shard_count = shard_count;
+    s->listen_fd = listen_fd;
+    pthread_mutex_init(&s->lists_lock, NULL);
+    int owners = serverOwnerCount(shard_count);
+    int threads = serverThreadCount();
+    s->owners = (serverowner*)calloc(owners, sizeof(serverowner));
+    s->workers = (serverworker*)calloc(threads, sizeof(serverworker));
+    while (s->owners && s->workers && s->owner_count < owners && openOwner(s, &s->owners[s->owner_count],
+                                                                           s->owner_count)) {
+        s->owner_count++;
+    }
+    if (s->owner_count < owners) {
+        perror("Failed to set up the command queues");
+        for (int i = 0; i < s->owner_count; i++) {
+            closeOwner(&s->owners[i]);
+        }
+        free(s->owners);
+        free(s->workers);
+        pthread_mutex_destroy(&s->lists_lock);
+        free(s);
+        close(listen_fd);
+        unlink(path);
+        return 0;
+    }
+
+    // Every worker is registered as a reader before any of them runs a command
+    int opened = 0;
+    while (opened < threads && openWorker(s, &s->workers[opened])) {
+        opened++;
+    }
+    if (opened < threads) {
+        perror("Failed to set up the event loops");
+        for (int i = 0; i < opened; i++) {
+            closeWorker(&s->workers[i]);
+        }
+        for (int i = 0; i < s->owner_count; i++) {
+            closeOwner(&s->owners[i]);
+        }
+        free(s->owners);
+        free(s->workers);
+        pthread_mutex_destroy(&s->lists_lock);
+        free(s);
+        close(listen_fd);
+        unlink(path);
+        return 0;
+    }
+
+    // Workers and owner threads start with the stop signals blocked, so
+    // only this thread takes them. No SA_RESTART: the signal interrupts the
+    // first owner's wait and ends its loop
+    sigset_t stop_signals, old_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    struct sigaction stop, old_int, old_term;
+    memset(&stop, 0, sizeof(stop));
+    stop.sa_handler = stopServer;
+    sigemptyset(&stop.sa_mask);
+    sigaction(SIGINT, &stop, &old_int);
+    sigaction(SIGTERM, &stop, &old_term);
+    serverStop = 0;
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &old_mask);
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&s->workers[i].thread, NULL, runWorker, &s->workers[i]) != 0) {
+            perror("Failed to start a server thread");
+            break;
+        }
+        s->worker_count++;
+    }
+    s->running = s->worker_count;
+    int owner_threads = 1;
+    while (s->worker_count > 0 && owner_threads < s->owner_count &&
+           pthread_create(&s->owners[owner_threads].thread, NULL, runOwnerThread, &s->owners[owner_threads]) == 0) {
+        owner_threads++;
+    }
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+
+    if (s->worker_count > 0 && owner_threads < s->owner_count) {
+        perror("Failed to start an owner thread");
+        serverStop = 1;
+    } else {
+        printf("Serving on %s with %d threads and %d owners, %d shard(s) (SIGINT or SIGTERM stops the server)\n",
+               path, s->worker_count, s->owner_count, s->shard_count);
+        fflush(stdout);
+    }
+    if (s->worker_count > 0) {
+        runOwner(&s->owners[0], 0);
+    }
+
+    // Workers stop taking commands, but the ones already queued are still
+    // applied and answered before the workers close their connections
+    for (int i = 1; i < owner_threads; i++) {
+        taskQueueWake(&s->owners[i].commands);
+    }
+    for (int i = 0; i < s->worker_count; i++) {
+        __atomic_store_n(&s->workers[i].stop, 1, __ATOMIC_RELEASE);
+        wakeWorker(&s->workers[i]);
+    }
+    runOwner(&s->owners[0], 1);
+    for (int i = 1; i < owner_threads; i++) {
+        pthread_join(s->owners[i].thread, NULL);
+    }
+    serverworker total;
+    memset(&total, 0, sizeof(total));
+    for (int i = 0; i < s->worker_count; i++) {
+        pthread_join(s->workers[i].thread, NULL);
+    }
+    for (int i = 0; i < threads; i++) {
+        serverworker* w = &s->workers[i];
+        total.accepted += w->accepted;
+        total.commands += w->commands;
+        total.failed += w->failed;
+        total.reads += w->reads;
+        total.queued += w->queued;
+        total.bytes_in += w->bytes_in;
+        total.bytes_out += w->bytes_out;
+        total.paused += w->paused;
+        closeWorker(w);
+    }
+    for (int i = 0; i < s->owner_count; i++) {
+        total.commands += s->owners[i].run.commands;
+        total.failed += s->owners[i].run.failed;
+    }
+    close(s->listen_fd);
+    unlink(path);
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+
+    epochlimbo epochs;
+    memset(&epochs, 0, sizeof(epochs));
+    for (int k = 0; k < shard_count; k++) {
+        addEpochCounters(&epochs, shards[k]);
+    }
+    long lists = s->list_count;
+    closeNamedLists(s, &epochs);
+    fprintf(stderr, "Server: %ld connections (%ld at once), %ld commands (%ld failed, %ld read sections, "
+            "%ld queued to the owners), %llu bytes in, %llu bytes out, reading paused %ld times\n",
+            total.accepted, s->peak, total.commands, total.failed, total.reads, total.queued, total.bytes_in,
+            total.bytes_out, total.paused);
+    if (lists > 0) {
+        fprintf(stderr, "Lists: %ld named lists opened\n", lists);
+    }
+    for (int i = 0; i < s->owner_count; i++) {
+        if (s->owner_count > 1) {
+            fprintf(stderr, "Owner %d: ", i);
+        }
+        printTaskQueueStats(&s->owners[i].commands, stderr);
+        closeOwner(&s->owners[i]);
+    }
+    fprintf(stderr, "Epochs: %lu, %ld objects retired, %ld released (%ld waiting at most), "
+            "%ld grace-period waits\n",
+            epochState.global, epochs.retired, epochs.released, epochs.peak_pending, epochs.synchronizes);
+    free(s->owners);
+    free(s->workers);
+    pthread_mutex_destroy(&s->lists_lock);
+    free(s);
+    return 1;
+}
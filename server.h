@@ -0,0 +1,147 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdio.h>
+#include "task_management.h"
+#include "batch.h"
+#include "taskqueue.h"
+#include "taskstore.h"
+
+// Server mode (todo_progress --serve) listens on a Unix domain socket and
+// serves any number of clients from a few worker threads, each running
+// its own epoll loop over the connections it accepted. The protocol is the
+// batch command language (see batch.h): a client sends commands one per
+// line, may send many without waiting, and gets the answers in order.
+// list, stats and searches run on the worker that received them,
+// without a lock (see epoch.h). Commands that change the list are queued
+// (see taskqueue.h) to its owner thread, the only writer, which applies
+// them in batches and hands each answer back to its worker; a client's
+// later lines wait for that answer, so answers stay in order.
+//
+// The default list may be split into TODO_SHARDS shards (see taskstore.h),
+// each with its own owner thread. "use\t<name>" switches a connection to
+// the list called name, kept in TODO_LIST_DIR and opened on first use, and
+// a bare "use" switches back to the default list; any number of lists are
+// spread over the owners. A command that changes several shards
+// (batchLineShard()) goes to the first owner, which waits for the others
+// to finish their batch and keeps them out while it runs.
+// Sockets are non-blocking; a client whose answers are not being read is
+// not read from until SERVER_OUTPUT_LIMIT bytes of them have drained.
+#define SERVER_DEFAULT_SOCKET "todo.sock"   // TODO_SOCKET overrides
+#define SERVER_BACKLOG 128
+#define SERVER_EVENTS 64                    // events taken per epoll_wait()
+#define SERVER_READ_CHUNK (64u << 10)
+#define SERVER_MAX_LINE (1u << 20)          // longer command lines close the connection
+#define SERVER_OUTPUT_LIMIT (4u << 20)      // unsent answers that pause reading
+#define SERVER_TICK_MS 1000                 // owner's checks for checkpoints and the date
+#define SERVER_STOP_WAIT_MS 10              // owner's wait between checks while workers stop
+#define SERVER_MAX_THREADS 64               // TODO_SERVER_THREADS (default: one per online CPU)
+#define SERVER_MAX_OWNERS 64                // TODO_SERVER_OWNERS (default and least: one per shard)
+#define SERVER_LIST_BUCKETS 4096            // hash buckets of the named lists
+
+struct serverowner;
+
+// A named list: its store and the owner thread that changes it
+typedef struct serverlist {
+    taskstore* store;
+    struct serverowner* owner;
+    struct serverlist* next;                // in its bucket
+    struct serverlist* owner_next;          // on its owner's lists
+} serverlist;
+
+// One connection
+typedef struct serverclient {
+    int fd;
+    char* in;                               // bytes received and not run yet
+    size_t in_used;
+    size_t in_capacity;
+    FILE* out;                              // open_memstream() of the answers
+    char* out_data;
+    size_t out_size;
+    size_t out_sent;
+    unsigned int events;                    // epoll events registered (0: not in the set)
+    int closing;                            // peer finished sending; close once answered
+    int pending;                            // a command is with the owner; later lines wait
+    int broken;                             // send or receive failed; closed once not pending
+    batchrun run;                           // reader run for the lines answered here
+    serverlist* named;                      // list picked with use, NULL for the default list
+    struct serverworker* worker;
+    struct serverclient* prev;              // every open connection, for shutdown
+    struct serverclient* next;
+} serverclient;
+
+// A command line queued for an owner thread, then its answer on the way back
+typedef struct servercommand {
+    serverclient* client;
+    struct servercommand* next;             // on the worker's finished stack
+    taskstore** stores;                     // the list it runs on (see batchrun)
+    int store_count;
+    int shard;                              // shard it changes, or BATCH_ALL_SHARDS
+    char* answer;
+    size_t answer_size;
+    size_t length;
+    char line[];
+} servercommand;
+
+typedef struct server server;
+
+// One worker thread and the connections it accepted
+typedef struct serverworker {
+    server* s;
+    pthread_t thread;
+    int epoll_fd;
+    int wake_fd;                            // eventfd: answers finished, or stop
+    int reader;                             // epoch slot for its read sections
+    int stop;                               // set by runServer() (atomic)
+    servercommand* finished;                // answers from the owner (lock-free stack)
+    long in_flight;                         // commands with the owner (only its thread)
+    serverclient* clients;
+    // Counters for the summary printed on shutdown (only its thread writes them)
+    long accepted;
+    long commands;
+    long failed;
+    long reads;
+    long queued;                            // commands handed to the owners
+    unsigned long long bytes_in;
+    unsigned long long bytes_out;
+    long paused;                            // times a client stopped being read for backpressure
+} serverworker;
+
+// One owner thread: the only writer of the shard with its index and of
+// the named lists given to it. The first owner runs on the thread that
+// called runServer()
+typedef struct serverowner {
+    server* s;
+    pthread_t thread;
+    int index;
+    taskqueue commands;                     // commands for this owner
+    batchrun run;                           // its run: every change it makes goes through it
+    FILE* out;                              // open_memstream() of the answer being made
+    char* out_data;
+    size_t out_size;
+    pthread_mutex_t apply;                  // held while it changes its stores
+    serverlist* lists;                      // named lists it owns, newest first (atomic)
+} serverowner;
+
+struct server {
+    int listen_fd;
+    const char* path;
+    taskstore** shards;                     // the default list
+    int shard_count;
+    serverowner* owners;
+    int owner_count;
+    serverworker* workers;
+    int worker_count;
+    int running;                            // workers that may still queue commands (atomic)
+    long active;                            // open connections (atomic)
+    long peak;
+    serverlist* lists[SERVER_LIST_BUCKETS]; // named lists by name hash
+    pthread_mutex_t lists_lock;             // held while a named list is looked up or opened
+    long list_count;
+};
+
+const char* serverSocketPath(void);
+int serverListen(const char* path);
+int runServer(taskstore** shards, int shard_count, int listen_fd, const char* path);
+
+#endif
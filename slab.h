@@ -0,0 +1,43 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stddef.h>
+
+// A chunk holds objects_per_chunk objects right after its header
+typedef struct slabchunk {
+    struct slabchunk* next;
+} slabchunk;
+
+// Fixed-size object allocator with free-list reuse
+typedef struct {
+    const char* name;
+    size_t object_size;
+    int objects_per_chunk;
+
+    slabchunk* chunks;      // every chunk ever allocated (newest last is not required)
+    slabchunk* current;     // chunk we are bump-allocating from
+    char* bump;             // next never-used object in current chunk
+    char* bump_end;
+    void* free_list;        // objects returned by slabFree()
+
+    // allocation counters for the debug report
+    long allocs;
+    long reused;            // allocations served from the free list
+    long frees;
+    long live;
+    long peak;
+    long chunk_allocs;      // malloc() calls actually made
+    long resets;
+} slab;
+
+// Static initializer: slab s = SLAB_INIT("task", task, 1024);
+#define SLAB_INIT(label, type, per_chunk) { label, sizeof(type), per_chunk, \
+    NULL, NULL, NULL, NULL, NULL, 0, 0, 0, 0, 0, 0, 0 }
+
+void* slabAlloc(slab* s);
+void slabFree(slab* s, void* obj);
+void slabReset(slab* s);
+void slabRelease(slab* s);
+void printSlabStats(slab* s);
+
+#endif
@@ -0,0 +1,662 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "snapshot.h"
+#include "writebuffer.h"
+#include "journal.h"
+#include "taskstore.h"
+
+
+/*
+snapshotPath() - File the snapshot is saved to and loaded from
+ - TODO_SNAPSHOT overrides SNAPSHOT_DEFAULT_FILE; setting it to an empty
+   string turns snapshots off
+ - Time: O(1), Space: O(1)
+ - Returns the path, or NULL when snapshots are off
+ */
+const char* snapshotPath(void) {
+    const char* path = getenv("TODO_SNAPSHOT");
+    if (!path) {
+        return SNAPSHOT_DEFAULT_FILE;
+    }
+    return path[0] ? path : NULL;
+}
+
+
+static double snapshotSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+static unsigned long long alignSection(unsigned long long offset) {
+    return (offset + SNAPSHOT_ALIGN - 1) & ~(unsigned long long)(SNAPSHOT_ALIGN - 1);
+}
+
+
+// Zero bytes up to the next section
+static void padToOffset(writebuffer* out, unsigned long long offset) {
+    unsigned long long position = (unsigned long long)out->written + out->used;
+    while (position < offset) {
+        writeBufferChar(out, '\0');
+        position++;
+    }
+}
+
+
+// Bytes a string takes in the arena section (nothing for the empty string)
+static unsigned long long arenaBytes(arenastr s) {
+    return s.offset == ARENA_NO_OFFSET ? 0 : (unsigned long long)s.length + 1;
+}
+
+
+static unsigned long long sectionText(arenastr s, unsigned long long* next) {
+    if (s.offset == ARENA_NO_OFFSET) {
+        return (unsigned long long)ARENA_NO_OFFSET;
+    }
+    unsigned long long offset = *next;
+    *next += (unsigned long long)s.length + 1;
+    return offset;
+}
+
+
+/*
+writeSnapshotSections() - Writes every section after the header
+ - all holds the pending tasks oldest first, then the completion log
+ - rank maps a cold id to its record index (filled here, read by the view section)
+ - Time: O(n + total text), Space: O(1) besides the caller's arrays
+ */
+static void writeSnapshotSections(writebuffer* out, const snapshotheader* h, tasklist* list,
+                                  completionlog* done, task** all, unsigned int* rank) {
+    unsigned int total = h->pending_count + h->completed_count;
+
+    padToOffset(out, h->records_offset);
+    unsigned long long next_text = 0;
+    unsigned int next_tag = 0;
+    for (unsigned int i = 0; i < total; i++) {
+        task* t = all[i];
+        taskcold* cold = taskCold(t);
+        snaprecord rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.name_offset = sectionText(cold->name, &next_text);
+        rec.description_offset = sectionText(cold->description, &next_text);
+        rec.name_length = cold->name.length;
+        rec.description_length = cold->description.length;
+        rec.due = t->due;
+        rec.day = i < h->pending_count ? 0 : done->entries[i - h->pending_count].day;
+        rec.tag_first = next_tag;
+        rec.tag_count = (unsigned int)cold->tag_count;
+        rec.priority = t->priority;
+        rec.status = t->status;
+        rec.due_date_set = t->due_date_set;
+        rec.completed = t->completed;
+        rec.name_hash = hashTaskNameLength(arenaString(cold->name), cold->name.length);
+        writeBufferText(out, (const char*)&rec, sizeof(rec));
+        next_tag += rec.tag_count;
+        if (i < h->pending_count) {
+            rank[t->id] = i;
+        }
+    }
+
+    padToOffset(out, h->view_offset);
+    orderiter it;
+    orderIterBegin(&it, &list->order);
+    for (task* t = orderIterNext(&it); t; t = orderIterNext(&it)) {
+        writeBufferText(out, (const char*)&rank[t->id], sizeof(unsigned int));
+    }
+
+    padToOffset(out, h->tag_ids_offset);
+    for (unsigned int i = 0; i < total; i++) {
+        taskcold* cold = taskCold(all[i]);
+        writeBufferText(out, (const char*)cold->tag_ids, cold->tag_count * sizeof(unsigned int));
+    }
+
+    padToOffset(out, h->tag_names_offset);
+    for (unsigned int id = 0; id < h->tag_count; id++) {
+        const char* name = tagName(id);
+        writeBufferText(out, name, strlen(name) + 1);
+    }
+
+    padToOffset(out, h->arena_offset);
+    for (unsigned int i = 0; i < total; i++) {
+        taskcold* cold = taskCold(all[i]);
+        if (cold->name.offset != ARENA_NO_OFFSET) {
+            writeBufferText(out, arenaString(cold->name), cold->name.length + 1);
+        }
+        if (cold->description.offset != ARENA_NO_OFFSET) {
+            writeBufferText(out, arenaString(cold->description), cold->description.length + 1);
+        }
+    }
+}
+
+
+/*
+snapshotWritable() - Whether the tasks in memory may replace the snapshot file
+ - Not after a load that ran out of memory: the file holds tasks that are not in memory
+ - Time: O(1), Space: O(1)
+ */
+int snapshotWritable(void) {
+    return !currentStore->load.out_of_memory;
+}
+
+
+/*
+snapshotWrite() - Writes every pending and completed task to a snapshot file
+ - Written to filename.tmp, synced and renamed over filename, so a crash
+   leaves either the old snapshot or the new one
+ - Names and descriptions are packed without the arena's dead bytes
+ - generation and offset are the journal position (journalMark()) the
+   tasks are saved at; the next start replays the journal from there
+ - Prints nothing, so a checkpoint child can call it
+ - Time: O(n + total text), Space: O(n) for the record order
+ - Returns the number of tasks saved, or -1 with errno set on failure
+ */
+int snapshotWrite(tasklist* list, completionlog* done, const char* filename, unsigned long long generation,
+                  unsigned long long offset) {
+    if (!snapshotWritable()) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    unsigned int pending = (unsigned int)list->order.count;
+    unsigned int total = pending + (unsigned int)done->count;
+    task** all = (task**)malloc((total ? total : 1) * sizeof(task*));
+    unsigned int* rank = (unsigned int*)malloc((currentStore->cold.count ? currentStore->cold.count : 1) * sizeof(unsigned int));
+    size_t tmp_length = strlen(filename) + 5;
+    char* tmp = (char*)malloc(tmp_length);
+    if (!all || !rank || !tmp) {
+        free(all);
+        free(rank);
+        free(tmp);
+        errno = ENOMEM;
+        return -1;
+    }
+    snprintf(tmp, tmp_length, "%s.tmp", filename);
+
+    // Pending tasks oldest first (tail to head), then the log
+    unsigned int n = 0;
+    task* tail = list->head;
+    while (tail && tail->next) {
+        tail = tail->next;
+    }
+    for (task* t = tail; t && n < pending; t = t->prev) {
+        all[n++] = t;
+    }
+    for (int i = 0; i < done->count; i++) {
+        all[n++] = done->entries[i].task_data;
+    }
+
+    snapshotheader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.byte_order = SNAPSHOT_BYTE_ORDER;
+    h.header_size = sizeof(snapshotheader);
+    h.record_size = sizeof(snaprecord);
+    h.pending_count = pending;
+    h.completed_count = (unsigned int)done->count;
+    h.tag_count = currentStore->tag_dict.count;
+    h.today = list->due.today;
+    h.shard = (unsigned int)currentStore->shard;
+    h.shard_count = (unsigned int)currentStore->shard_count;
+    h.journal_generation = generation;
+    h.journal_offset = offset;
+    for (unsigned int i = 0; i < total; i++) {
+        taskcold* cold = taskCold(all[i]);
+        h.task_tag_count += (unsigned long long)cold->tag_count;
+        h.arena_bytes += arenaBytes(cold->name) + arenaBytes(cold->description);
+    }
+    for (unsigned int id = 0; id < currentStore->tag_dict.count; id++) {
+        h.tag_names_bytes += strlen(tagName(id)) + 1;
+    }
+    h.records_offset = alignSection(sizeof(h));
+    h.view_offset = alignSection(h.records_offset + (unsigned long long)total * sizeof(snaprecord));
+    h.tag_ids_offset = alignSection(h.view_offset + (unsigned long long)pending * sizeof(unsigned int));
+    h.tag_names_offset = alignSection(h.tag_ids_offset + h.task_tag_count * sizeof(unsigned int));
+    h.arena_offset = alignSection(h.tag_names_offset + h.tag_names_bytes);
+    h.file_size = h.arena_offset + h.arena_bytes;
+
+    writebuffer out;
+    int ok = writeBufferOpen(&out, tmp);
+    if (ok) {
+        writeBufferText(&out, (const char*)&h, sizeof(h));
+        writeSnapshotSections(&out, &h, list, done, all, rank);
+        ok = writeBufferSync(&out);
+        ok = writeBufferClose(&out) && ok;
+    }
+    if (ok && rename(tmp, filename) != 0) {
+        ok = 0;
+    }
+    int error = errno;
+    if (!ok) {
+        unlink(tmp);
+    }
+
+    free(all);
+    free(rank);
+    free(tmp);
+    errno = error;
+    return ok ? (int)total : -1;
+}
+
+
+/*
+snapshotSave() - snapshotWrite() that reports the result
+ - Time: O(n + total text), Space: O(n)
+ - Returns the number of tasks saved, or -1 on failure
+ - Example: snapshotSave(&tasks, &doneLog, "todo.snap", mark.generation, mark.offset) on exit
+ */
+int snapshotSave(tasklist* list, completionlog* done, const char* filename, unsigned long long generation,
+                 unsigned long long offset) {
+    if (!snapshotWritable()) {
+        printf("Warning: Only part of %s could be loaded; not overwriting it.\n", filename);
+        return -1;
+    }
+    int saved = snapshotWrite(list, done, filename, generation, offset);
+    if (saved < 0) {
+        perror("Failed to save snapshot");
+    } else {
+        printf("Saved %d tasks to %s\n", saved, filename);
+    }
+    return saved;
+}
+
+
+// Checks that [offset, offset + bytes) lies inside a file of size bytes
+static int sectionFits(unsigned long long offset, unsigned long long bytes, size_t size) {
+    return offset <= size && bytes <= size - offset;
+}
+
+
+/*
+checkSnapshotHeader() - Validates the header and the bounds of every section
+ - Time: O(1), Space: O(1)
+ - Returns NULL if the file can be used, otherwise what is wrong with it
+ */
+static const char* checkSnapshotHeader(const char* data, size_t size) {
+    const snapshotheader* h = (const snapshotheader*)data;
+    if (memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) != 0) {
+        return "is not a snapshot file";
+    }
+    if (h->version != SNAPSHOT_VERSION || h->byte_order != SNAPSHOT_BYTE_ORDER ||
+        h->header_size != sizeof(snapshotheader) || h->record_size != sizeof(snaprecord)) {
+        return "was written by another version or machine";
+    }
+    if (h->file_size != size) {
+        return "is truncated";
+    }
+    unsigned long long total = (unsigned long long)h->pending_count + h->completed_count;
+    if (total > INT_MAX || h->task_tag_count > size / sizeof(unsigned int)) {
+        return "is damaged";
+    }
+    if (h->records_offset % SNAPSHOT_ALIGN || h->view_offset % SNAPSHOT_ALIGN ||
+        h->tag_ids_offset % SNAPSHOT_ALIGN ||
+        !sectionFits(h->records_offset, total * sizeof(snaprecord), size) ||
+        !sectionFits(h->view_offset, (unsigned long long)h->pending_count * sizeof(unsigned int), size) ||
+        !sectionFits(h->tag_ids_offset, h->task_tag_count * sizeof(unsigned int), size) ||
+        !sectionFits(h->tag_names_offset, h->tag_names_bytes, size) ||
+        !sectionFits(h->arena_offset, h->arena_bytes, size)) {
+        return "is damaged";
+    }
+    if ((h->arena_bytes && data[h->arena_offset + h->arena_bytes - 1] != '\0') ||
+        (h->tag_count && (!h->tag_names_bytes ||
+                          data[h->tag_names_offset + h->tag_names_bytes - 1] != '\0'))) {
+        return "is damaged";
+    }
+    return NULL;
+}
+
+
+/*
+loadSnapshotTags() - Interns the saved tag names in id order
+ - The dictionary is empty at startup, so every name gets its saved id
+ - Time: O(total tag name length), Space: O(tags)
+ - Returns NULL on success, otherwise what went wrong
+ */
+static const char* loadSnapshotTags(const char* data) {
+    const snapshotheader* h = (const snapshotheader*)data;
+    const char* name = data + h->tag_names_offset;
+    const char* end = name + h->tag_names_bytes;
+    for (unsigned int id = 0; id < h->tag_count; id++) {
+        if (name >= end) {
+            return "is damaged";
+        }
+        unsigned int got = tagIntern(name);
+        if (got == TAG_NO_ID) {
+            return "could not be loaded (out of memory)";
+        }
+        if (got != id) {
+            return "is damaged";
+        }
+        name += strlen(name) + 1;
+    }
+    return NULL;
+}
+
+
+// Checks that a saved string lies inside the arena section and ends in its NUL
+static int snapshotTextValid(const snapshotheader* h, const char* arena,
+                             unsigned long long offset, unsigned int length) {
+    if (offset == (unsigned long long)ARENA_NO_OFFSET) {
+        return length == 0;
+    }
+    return offset < h->arena_bytes && length < h->arena_bytes - offset && arena[offset + length] == '\0';
+}
+
+
+/*
+restoreSnapshotRecord() - Rebuilds one task from its record
+ - Name and description keep their offsets: the arena is the mapped section
+ - Time: O(tags on the task), Space: O(tags on the task)
+ - Returns the task, or NULL (load->skipped or load->out_of_memory is set)
+ */
+static task* restoreSnapshotRecord(snapshotload* load, const snaprecord* rec) {
+    const snapshotheader* h = (const snapshotheader*)load->data;
+    const unsigned int* tag_ids = (const unsigned int*)(load->data + h->tag_ids_offset);
+    const char* arena = load->data + h->arena_offset;
+
+    if (!snapshotTextValid(h, arena, rec->name_offset, rec->name_length) ||
+        !snapshotTextValid(h, arena, rec->description_offset, rec->description_length) ||
+        (unsigned long long)rec->tag_first + rec->tag_count > h->task_tag_count ||
+        rec->status > OVERDUE) {
+        load->skipped++;
+        return NULL;
+    }
+
+    task* t = newTask();
+    if (!t) {
+        load->out_of_memory = 1;
+        return NULL;
+    }
+    taskcold* cold = taskCold(t);
+    cold->name.offset = (size_t)rec->name_offset;
+    cold->name.length = rec->name_length;
+    cold->description.offset = (size_t)rec->description_offset;
+    cold->description.length = rec->description_length;
+
+    for (unsigned int i = 0; i < rec->tag_count; i++) {
+        unsigned int id = tag_ids[rec->tag_first + i];
+        if (id >= h->tag_count || taskHasTag(t, id)) {
+            continue;
+        }
+        if (!taskAddTag(t, id)) {
+            destroyTask(t);
+            load->out_of_memory = 1;
+            return NULL;
+        }
+    }
+
+    t->priority = rec->priority;
+    t->due = rec->due;
+    t->due_date_set = rec->due_date_set ? 1 : 0;
+    t->status = rec->status;
+    t->completed = 0;
+    return t;
+}
+
+
+/*
+linkRestored() - linkTask() without the view order index
+ - The order index is built in one pass once every task is linked, and
+   text indexing waits for the first search (textIndexDefer())
+ - Time: O(name length + tags) average, Space: O(1) amortized
+ - Returns 1 on success, 0 if memory allocation failed (the task is not
+   linked and in none of the indexes)
+ */
+static int linkRestored(tasklist* list, task* t, unsigned int name_hash) {
+    if (!nameIndexInsertHashed(&list->names, t, name_hash)) {
+        return 0;
+    }
+    if (!tagIndexInsertTask(&list->tags, t)) {
+        nameIndexRemove(&list->names, t);
+        return 0;
+    }
+    if (!dueTrackerInsert(&list->due, t)) {
+        tagIndexRemoveTask(&list->tags, t);
+        nameIndexRemove(&list->names, t);
+        return 0;
+    }
+    t->prev = NULL;
+    t->next = list->head;
+    if (list->head) {
+        list->head->prev = t;
+    }
+    list->head = t;
+    t->seq = list->order.next_seq++;
+    textIndexDefer(t);
+    return 1;
+}
+
+
+/*
+buildRestoredOrder() - Builds the view order index from the saved view order
+ - Falls back to one insert per task if the saved order does not match
+ - Time: O(n) (O(n log n) on the fallback), Space: O(n)
+ */
+static void buildRestoredOrder(snapshotload* load, task** by_record, int count) {
+    const snapshotheader* h = (const snapshotheader*)load->data;
+    const unsigned int* view = (const unsigned int*)(load->data + h->view_offset);
+    orderindex* order = &load->list->order;
+
+    task** sorted = (task**)malloc((size_t)(count > 0 ? count : 1) * sizeof(task*));
+    int linked = 0, n = 0;
+    for (int i = 0; i < count; i++) {
+        linked += by_record[i] != NULL;
+    }
+    if (sorted) {
+        for (unsigned int k = 0; k < h->pending_count; k++) {
+            if (view[k] < (unsigned int)count && by_record[view[k]]) {
+                sorted[n++] = by_record[view[k]];
+            }
+        }
+    }
+    if (!sorted || n != linked || !orderIndexBuild(order, sorted, n)) {
+        for (int i = 0; i < count; i++) {
+            if (by_record[i] && !orderIndexInsert(order, by_record[i])) {
+                load->out_of_memory = 1;
+            }
+        }
+    }
+    free(sorted);
+}
+
+
+/*
+snapshotLoader() - Rebuilds the list, the indexes and the completion log, then replays the journal
+ - Runs on the loader thread; the main thread does not touch the list
+   until snapshotLoadFinish() has joined it
+ - Time: O(n + total tags), Space: O(n)
+ */
+static void* snapshotLoader(void* arg) {
+    snapshotload* load = (snapshotload*)arg;
+    taskStoreUse(load->store);
+    const snapshotheader* h = (const snapshotheader*)load->data;
+    const snaprecord* records = (const snaprecord*)(load->data + h->records_offset);
+    tasklist* list = load->list;
+    double start = snapshotSeconds();
+
+    int pending = (int)h->pending_count;
+    task** by_record = (task**)calloc(pending ? pending : 1, sizeof(task*));
+
+    // Statuses are recomputed for the saved day, then moved to today below
+    list->due.today = h->today;
+    nameIndexReserve(&list->names, list->names.count + pending);
+    for (int i = 0; i < pending && !load->out_of_memory; i++) {
+        task* t = restoreSnapshotRecord(load, &records[i]);
+        if (!t) {
+            continue;
+        }
+        if (by_record ? !linkRestored(list, t, records[i].name_hash) : !linkTask(list, t)) {
+            destroyTask(t);
+            load->out_of_memory = 1;
+            continue;
+        }
+        if (by_record) {
+            by_record[i] = t;
+        }
+        load->restored++;
+    }
+    if (by_record) {
+        buildRestoredOrder(load, by_record, pending);
+        free(by_record);
+    }
+
+    for (unsigned int i = 0; i < h->completed_count && !load->out_of_memory; i++) {
+        const snaprecord* rec = &records[pending + i];
+        task* t = restoreSnapshotRecord(load, rec);
+        if (!t) {
+            continue;
+        }
+        if (!completionLogAppend(load->done, t, rec->day)) {
+            destroyTask(t);
+            load->out_of_memory = 1;
+            break;
+        }
+        t->status = COMPLETED;
+        t->completed = 1;
+        t->seq = (unsigned int)(load->done->count - 1);
+        textIndexDefer(t);
+        load->restored++;
+    }
+
+    // Changes made after the snapshot was saved, unless it is incomplete
+    if (!load->out_of_memory) {
+        journalOpen(list, load->done, load->journal, h->journal_generation, h->journal_offset);
+    }
+    updateTaskStatuses(list, load->today);
+    load->seconds = snapshotSeconds() - start;
+    return NULL;
+}
+
+
+/*
+snapshotShardOf() - Which shard of its list a snapshot file holds, from its header
+ - Time: O(1), Space: O(1)
+ - Returns 1 and sets *shard and *shard_count if filename is a snapshot this
+   version can read, 0 otherwise (missing, foreign or damaged)
+ */
+int snapshotShardOf(const char* filename, int* shard, int* shard_count) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    snapshotheader h;
+    int ok = pread(fd, &h, sizeof(h), 0) == (ssize_t)sizeof(h) &&
+             memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) == 0 && h.version == SNAPSHOT_VERSION &&
+             h.byte_order == SNAPSHOT_BYTE_ORDER;
+    close(fd);
+    if (ok) {
+        *shard = (int)h.shard;
+        *shard_count = (int)h.shard_count;
+    }
+    return ok;
+}
+
+
+/*
+snapshotLoadStart() - Maps a snapshot and starts restoring it in the background
+ - The header, the section bounds and the tag dictionary are checked here;
+   the text arena then reads names and descriptions from the mapping in
+   place and a loader thread rebuilds everything else, then replays the
+   journal (see journalOpen()) on top
+ - A missing file is not an error (first run); a damaged one is reported
+   and the program starts empty
+ - Time: O(tags) before returning, Space: O(1) (the file is mapped, not read)
+ - Returns 1 if a load was started (call snapshotLoadFinish() before
+   touching the list), 0 otherwise
+ */
+int snapshotLoadStart(tasklist* list, completionlog* done, const char* filename, const char* journal,
+                      date today) {
+    if (!filename) {
+        return 0;
+    }
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        if (errno != ENOENT) {
+            perror("Failed to open snapshot");
+        }
+        return 0;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || (size_t)info.st_size < sizeof(snapshotheader)) {
+        printf("Warning: %s is not a snapshot file. Starting with an empty list.\n", filename);
+        close(fd);
+        return 0;
+    }
+    void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("Failed to map snapshot");
+        return 0;
+    }
+
+    const char* problem = checkSnapshotHeader((const char*)data, info.st_size);
+    if (!problem) {
+        problem = loadSnapshotTags((const char*)data);
+    }
+    if (problem) {
+        printf("Warning: Snapshot %s %s. Starting with an empty list.\n", filename, problem);
+        munmap(data, info.st_size);
+        return 0;
+    }
+
+    const snapshotheader* h = (const snapshotheader*)data;
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+    if (h->arena_bytes) {
+        arenaBorrow((const char*)data + h->arena_offset, h->arena_bytes);
+    }
+
+    snapshotload* load = &currentStore->load;
+    memset(load, 0, sizeof(*load));
+    load->data = (const char*)data;
+    load->size = info.st_size;
+    load->filename = filename;
+    load->journal = journal;
+    load->list = list;
+    load->done = done;
+    load->today = today;
+    load->store = currentStore;
+    load->loading = 1;
+    if (pthread_create(&load->loader, NULL, snapshotLoader, load) == 0) {
+        load->threaded = 1;
+    } else {
+        snapshotLoader(load);
+    }
+    return 1;
+}
+
+
+/*
+snapshotLoadFinish() - Waits for the loader thread and reports what it restored
+ - Called before every menu action; returns at once when no load is running
+ - Time: O(1) once the loader is done, Space: O(1)
+ */
+void snapshotLoadFinish(void) {
+    snapshotload* load = &currentStore->load;
+    if (!load->loading) {
+        return;
+    }
+    if (load->threaded) {
+        pthread_join(load->loader, NULL);
+        load->threaded = 0;
+    }
+    load->loading = 0;
+
+    const snapshotheader* h = (const snapshotheader*)load->data;
+    printf("Restored %d tasks from %s in %.3f s\n", load->restored, load->filename, load->seconds);
+    if (load->skipped) {
+        printf("Warning: %d damaged snapshot record(s) were skipped.\n", load->skipped);
+    }
+    if (load->out_of_memory) {
+        printf("Warning: Memory ran out after %d of %u tasks; the rest of the snapshot was not loaded.\n",
+               load->restored, h->pending_count + h->completed_count);
+    }
+}
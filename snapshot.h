@@ -0,0 +1,94 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include "task_management.h"
+
+// Binary snapshot of every task, saved on exit and mapped on startup.
+// The file is laid out as it is used: the string arena section becomes
+// the text arena in place (see arenaBorrow()), so names and descriptions
+// are never copied or parsed; only the hot records and the indexes are
+// rebuilt, by a loader thread, while the menu is already up.
+#define SNAPSHOT_MAGIC "TODOSNAP"       // 8 bytes, no NUL in the file
+#define SNAPSHOT_VERSION 4
+#define SNAPSHOT_BYTE_ORDER 0x01020304u // reads back differently on a foreign-endian machine
+#define SNAPSHOT_DEFAULT_FILE "todo.snap"
+#define SNAPSHOT_ALIGN 8                // every section starts on this boundary
+
+// File header; offsets are from the start of the file
+typedef struct {
+    char magic[8];
+    unsigned int version;
+    unsigned int byte_order;
+    unsigned int header_size;           // sizeof(snapshotheader) when written
+    unsigned int record_size;           // sizeof(snaprecord) when written
+    unsigned int pending_count;         // records [0, pending_count): the list, oldest first
+    unsigned int completed_count;       // then the completion log, oldest first
+    unsigned int tag_count;             // tag dictionary entries, in id order
+    unsigned int today;                 // serial day the pending statuses are correct for
+    unsigned int shard;                 // which shard of its list the file holds
+    unsigned int shard_count;           // 1 unless the list is sharded
+    unsigned long long task_tag_count;  // entries of the tag id section
+    unsigned long long records_offset;  // snaprecord[pending_count + completed_count]
+    unsigned long long view_offset;     // unsigned int[pending_count]: record index of each
+                                        // pending task in view order
+    unsigned long long tag_ids_offset;  // unsigned int[task_tag_count]
+    unsigned long long tag_names_offset;// tag_count NUL-terminated names
+    unsigned long long tag_names_bytes;
+    unsigned long long arena_offset;    // names and descriptions, each NUL-terminated
+    unsigned long long arena_bytes;
+    unsigned long long file_size;
+    unsigned long long journal_generation;  // journal position the snapshot holds every
+    unsigned long long journal_offset;      // change before (see journalOpen())
+} snapshotheader;
+
+// One task; text offsets are into the arena section
+typedef struct {
+    unsigned long long name_offset;     // ARENA_NO_OFFSET for the empty string
+    unsigned long long description_offset;
+    unsigned int name_length;
+    unsigned int description_length;
+    unsigned int due;                   // serial day, valid when due_date_set
+    unsigned int day;                   // completion day (completed records only)
+    unsigned int tag_first;             // first entry in the tag id section
+    unsigned int tag_count;
+    unsigned char priority;
+    unsigned char status;
+    unsigned char due_date_set;
+    unsigned char completed;
+    unsigned int name_hash;             // hashTaskName() of the name, so restoring never reads it
+} snaprecord;
+
+// A snapshot being restored. The file stays mapped until its store is
+// closed because the text arena may still be reading from it.
+typedef struct {
+    const char* data;
+    size_t size;
+    const char* filename;
+    const char* journal;                // replayed after the snapshot (NULL: off)
+    tasklist* list;
+    completionlog* done;
+    date today;
+    struct taskstore* store;            // the loader thread works on this store
+    pthread_t loader;
+    int loading;                        // started and not yet reported
+    int threaded;                       // loader runs on its own thread (not yet joined)
+    int restored;                       // tasks rebuilt by the loader
+    int skipped;                        // records that failed validation
+    int out_of_memory;
+    double seconds;                     // time the loader took
+} snapshotload;
+
+const char* snapshotPath(void);
+int snapshotWritable(void);
+int snapshotWrite(tasklist* list, completionlog* done, const char* filename, unsigned long long generation,
+                  unsigned long long offset);
+int snapshotSave(tasklist* list, completionlog* done, const char* filename, unsigned long long generation,
+                 unsigned long long offset);
+int snapshotLoadStart(tasklist* list, completionlog* done, const char* filename, const char* journal,
+                      date today);
+void snapshotLoadFinish(void);
+int snapshotShardOf(const char* filename, int* shard, int* shard_count);
+
+#endif
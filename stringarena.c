@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stringarena.h"
+#include "epoch.h"
+#include "taskstore.h"
+
+#define ARENA_INITIAL_CAPACITY (64 * 1024)
+
+// Compact once at least half of a reasonably large arena is dead
+#define ARENA_COMPACT_MIN_BYTES (64 * 1024)
+
+
+
+/*
+arenaStore() - Appends a copy of text to the arena
+ - The copy is NUL-terminated so arenaString() can be used as a C string
+ - Empty strings take no space (offset ARENA_NO_OFFSET)
+ - Pointers from arenaString() are invalid after the next store or compaction
+   (on reader threads: once their read section ends)
+ - Time: O(length) amortized, Space: O(length)
+ - Sample Case:
+    Input: text = "Study", length = 5
+    Output: returns 1, out = {offset of the copy, 5}
+ */
+int arenaStore(const char* text, size_t length, arenastr* out) {
+    stringarena* arena = &currentStore->arena;
+    if (length == 0) {
+        *out = arenaEmpty();
+        return 1;
+    }
+
+    size_t needed = arena->used + length + 1;
+    char* block = arena->blocks[arena->current];
+    if (needed > arena->capacity) {
+        size_t new_capacity = arena->capacity ? arena->capacity : ARENA_INITIAL_CAPACITY;
+        while (new_capacity < needed) {
+            new_capacity *= 2;
+        }
+        char* data;
+        if (arena->borrowed) {
+            // First store after a snapshot load: the text moves to the heap now
+            // (the mapping stays, so readers still on it are fine)
+            data = (char*)malloc(new_capacity);
+            if (!data) {
+                return 0;
+            }
+            memcpy(data, block, arena->used);
+            arena->borrowed = 0;
+        } else {
+            data = (char*)epochResize(block, arena->used, new_capacity);
+            if (!data) {
+                return 0;
+            }
+        }
+        block = data;
+        EPOCH_PUBLISH(arena->blocks[arena->current], block);
+        arena->capacity = new_capacity;
+    }
+
+    memcpy(block + arena->used, text, length);
+    block[arena->used + length] = '\0';
+    // The text is in place before a reader thread can load its offset
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    out->offset = ((size_t)arena->current << ARENA_BLOCK_SHIFT) | arena->used;
+    out->length = (unsigned int)length;
+    arena->used = needed;
+    return 1;
+}
+
+
+/*
+arenaBorrow() - Uses existing text (a mapped snapshot) as the arena in place
+ - Strings keep the offsets they have in data; nothing is copied until
+   the next arenaStore(), which moves the arena to the heap first
+ - data must stay valid until then and is never freed by the arena
+ - Time: O(1), Space: O(1)
+ - Example: arenaBorrow(map + header->arena_offset, header->arena_bytes)
+ */
+void arenaBorrow(const char* data, size_t used) {
+    stringarena* arena = &currentStore->arena;
+    arenaReset();
+    arena->blocks[0] = (char*)data;
+    arena->used = used;
+    arena->capacity = used;
+    arena->borrowed = 1;
+}
+
+
+/*
+arenaString() - Returns the text of an arena string
+ - Safe on reader threads: the offset names the block its text is in
+ - Time: O(1), Space: O(1)
+ */
+const char* arenaString(arenastr s) {
+    stringarena* arena = &currentStore->arena;
+    if (s.offset == ARENA_NO_OFFSET) {
+        return "";
+    }
+    // The offset was loaded first; the block it names is at least as new
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    const char* block = EPOCH_LOAD(arena->blocks[s.offset >> ARENA_BLOCK_SHIFT]);
+    return block ? block + (s.offset & ARENA_POSITION_MASK) : "";
+}
+
+
+/*
+arenaRelease() - Marks a string as dead so compaction can reclaim it
+ - Time: O(1), Space: O(1)
+ */
+void arenaRelease(arenastr s) {
+    stringarena* arena = &currentStore->arena;
+    if (s.offset != ARENA_NO_OFFSET) {
+        arena->dead += s.length + 1;
+    }
+}
+
+
+/*
+arenaEmpty() - Returns the empty arena string
+ - Time: O(1), Space: O(1)
+ */
+arenastr arenaEmpty(void) {
+    arenastr s = {ARENA_NO_OFFSET, 0};
+    return s;
+}
+
+
+/*
+arenaNeedsCompaction() - Checks whether dead bytes make up half the arena
+ - Time: O(1), Space: O(1)
+ */
+int arenaNeedsCompaction(void) {
+    stringarena* arena = &currentStore->arena;
+    return arena->used >= ARENA_COMPACT_MIN_BYTES && arena->dead * 2 >= arena->used;
+}
+
+
+// Retired block a compaction left: it may be reused once readers are done with it
+static void releaseOldBlock(void* block) {
+    stringarena* arena = &currentStore->arena;
+    for (int i = 0; i < ARENA_BLOCKS; i++) {
+        if (i != arena->current && arena->blocks[i] == block) {
+            arena->blocks[i] = NULL;
+        }
+    }
+    free(block);
+}
+
+
+// Same for a borrowed block, which belongs to the snapshot mapping
+static void forgetOldBlock(void* block) {
+    stringarena* arena = &currentStore->arena;
+    for (int i = 0; i < ARENA_BLOCKS; i++) {
+        if (i != arena->current && arena->blocks[i] == block) {
+            arena->blocks[i] = NULL;
+        }
+    }
+}
+
+
+/*
+arenaCompactionBegin() - Starts compacting into a fresh block of bytes
+ - The caller moves every live string with arenaMove(), stores the new
+   offsets, then calls arenaCompactionEnd()
+ - Time: O(1), Space: O(bytes)
+ - Returns 1 on success, 0 if memory ran out or the other block is still
+   held for reader threads (try again later)
+ */
+int arenaCompactionBegin(size_t bytes) {
+    stringarena* arena = &currentStore->arena;
+    int next = 1 - arena->current;
+    if (arena->blocks[next]) {
+        return 0;
+    }
+    char* block = (char*)malloc(bytes ? bytes : 1);
+    if (!block) {
+        return 0;
+    }
+    EPOCH_PUBLISH(arena->blocks[next], block);
+    arena->capacity = bytes ? bytes : 1;
+    arena->used = 0;
+    return 1;
+}
+
+
+/*
+arenaMove() - Copies one string into the block being compacted into
+ - Time: O(length), Space: O(1)
+ - Returns its new offset
+ */
+size_t arenaMove(arenastr s) {
+    stringarena* arena = &currentStore->arena;
+    int next = 1 - arena->current;
+    char* block = arena->blocks[next];
+    memcpy(block + arena->used, arenaString(s), s.length + 1);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    size_t offset = ((size_t)next << ARENA_BLOCK_SHIFT) | arena->used;
+    arena->used += s.length + 1;
+    return offset;
+}
+
+
+/*
+arenaCompactionEnd() - Makes the compacted block current and retires the old one
+ - Time: O(1), Space: O(1)
+ */
+void arenaCompactionEnd(void) {
+    stringarena* arena = &currentStore->arena;
+    char* old = arena->blocks[arena->current];
+    int borrowed = arena->borrowed;
+    arena->current = 1 - arena->current;
+    arena->borrowed = 0;
+    arena->dead = 0;
+    arena->compactions++;
+    if (old) {
+        epochRetire(old, borrowed ? forgetOldBlock : releaseOldBlock);
+    }
+}
+
+
+/*
+arenaReset() - Frees the whole arena at once
+ - Time: O(1), Space: O(1)
+ */
+void arenaReset(void) {
+    stringarena* arena = &currentStore->arena;
+    for (int i = 0; i < ARENA_BLOCKS; i++) {
+        if (!(arena->borrowed && i == arena->current)) {
+            free(arena->blocks[i]);
+        }
+        arena->blocks[i] = NULL;
+    }
+    arena->current = 0;
+    arena->borrowed = 0;
+    arena->used = arena->capacity = arena->dead = 0;
+}
+
+
+/*
+printArenaStats() - Prints arena size and dead bytes
+ - Time: O(1), Space: O(1)
+ - Sample Case:
+    Output:
+      --- String Arena ---
+      Used: 5400 bytes (120 dead) of 65536, compactions: 0
+ */
+void printArenaStats(void) {
+    stringarena* arena = &currentStore->arena;
+    printf("--- String Arena ---\n");
+    printf("Used: %zu bytes (%zu dead) of %zu, compactions: %ld%s\n",
+           arena->used, arena->dead, arena->capacity, arena->compactions,
+           arena->borrowed ? ", in place in the snapshot" : "");
+}
@@ -0,0 +1,47 @@
+#ifndef STRINGARENA_H
+#define STRINGARENA_H
+
+#include <stddef.h>
+
+// Offset of the empty string, which takes no arena space
+#define ARENA_NO_OFFSET ((size_t)-1)
+
+// The top bits of an offset pick the block it points into (see below)
+#define ARENA_BLOCKS 2
+#define ARENA_BLOCK_SHIFT 62
+#define ARENA_POSITION_MASK (((size_t)1 << ARENA_BLOCK_SHIFT) - 1)
+
+// A string stored in the arena (text is NUL-terminated in place)
+typedef struct {
+    size_t offset;       // block number and position in that block
+    unsigned int length;
+} arenastr;
+
+// Append-only buffer holding every task name and description.
+// Compaction copies the live strings into the other block and rewrites
+// their offsets one by one, so a reader thread that loaded an offset
+// before the rewrite still finds its string in the old block; that block
+// is released once no reader can hold such an offset (see epoch.h).
+typedef struct {
+    char* blocks[ARENA_BLOCKS];
+    int current;         // block new strings go to
+    size_t used;         // bytes used in the current block
+    size_t capacity;
+    size_t dead;         // bytes of strings that are no longer referenced
+    long compactions;
+    int borrowed;        // the current block is not ours (a mapped snapshot): copy before growing
+} stringarena;
+
+int arenaStore(const char* text, size_t length, arenastr* out);
+void arenaBorrow(const char* data, size_t used);
+const char* arenaString(arenastr s);
+void arenaRelease(arenastr s);
+arenastr arenaEmpty(void);
+int arenaNeedsCompaction(void);
+int arenaCompactionBegin(size_t bytes);
+size_t arenaMove(arenastr s);
+void arenaCompactionEnd(void);
+void arenaReset(void);
+void printArenaStats(void);
+
+#endif
@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tagdict.h"
+#include "task_management.h"
+#include "epoch.h"
+#include "taskstore.h"
+
+#define TAGDICT_INITIAL_CAPACITY 16
+#define TASK_TAGS_INITIAL_CAPACITY 4
+
+
+
+/*
+tagSlotFor() - Finds the table slot of a tag name (or the empty slot where it belongs)
+ - Time: O(1) average, Space: O(1)
+ */
+static unsigned int tagSlotFor(const char* name) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    unsigned int mask = dict->slot_capacity - 1;
+    unsigned int pos = hashTaskName(name) & mask;
+    while (dict->slots[pos] && strcmp(dict->names[dict->slots[pos] - 1], name) != 0) {
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+
+/*
+growTagDict() - Doubles the name array and the hash table
+ - Time: O(tags), Space: O(tags)
+ - Returns 1 on success, 0 if memory allocation failed (dictionary unchanged)
+ */
+static int growTagDict(void) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    unsigned int new_capacity = dict->capacity ? dict->capacity * 2 : TAGDICT_INITIAL_CAPACITY;
+    // Reader threads print tag names, so the old array is retired, not freed
+    char** names = (char**)epochResize(dict->names, dict->count * sizeof(char*), new_capacity * sizeof(char*));
+    if (!names) {
+        return 0;
+    }
+    EPOCH_PUBLISH(dict->names, names);
+    dict->capacity = new_capacity;
+
+    // Table is kept at most half full
+    unsigned int* slots = (unsigned int*)calloc(new_capacity * 2, sizeof(unsigned int));
+    if (!slots) {
+        return 0;
+    }
+    free(dict->slots);
+    dict->slots = slots;
+    dict->slot_capacity = new_capacity * 2;
+    for (unsigned int id = 0; id < dict->count; id++) {
+        dict->slots[tagSlotFor(dict->names[id])] = id + 1;
+    }
+    return 1;
+}
+
+
+/*
+tagIntern() - Returns the id of a tag name, adding the name if it is new
+ - Time: O(len) average, Space: O(len) for a new name
+ - Sample Case:
+    Input: tagIntern("urgent"), tagIntern("home"), tagIntern("urgent")
+    Output: 0, 1, 0
+ */
+unsigned int tagIntern(const char* name) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    if (dict->count > 0) {
+        unsigned int pos = tagSlotFor(name);
+        if (dict->slots[pos]) {
+            return dict->slots[pos] - 1;
+        }
+    }
+
+    if ((dict->count == dict->capacity || dict->count * 2 >= dict->slot_capacity) && !growTagDict()) {
+        return TAG_NO_ID;
+    }
+    char* copy = strdup(name);
+    if (!copy) {
+        return TAG_NO_ID;
+    }
+
+    unsigned int id = dict->count++;
+    dict->names[id] = copy;
+    dict->slots[tagSlotFor(name)] = id + 1;
+    return id;
+}
+
+
+/*
+tagLookup() - Returns the id of a tag name without adding it
+ - Time: O(len) average, Space: O(1)
+ - Example: tagLookup("never-used") -> TAG_NO_ID
+ */
+unsigned int tagLookup(const char* name) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    if (dict->count == 0) {
+        return TAG_NO_ID;
+    }
+    unsigned int pos = tagSlotFor(name);
+    return dict->slots[pos] ? dict->slots[pos] - 1 : TAG_NO_ID;
+}
+
+
+/*
+tagName() - Returns the name of a tag id
+ - Time: O(1), Space: O(1)
+ */
+const char* tagName(unsigned int id) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    return dict->names[id];
+}
+
+
+/*
+tagBit() - Bit of task->tag_mask that stands for a tag id
+ - The first 64 tags each get their own bit, so the test is exact until
+   the dictionary grows past 64 names
+ - Time: O(1), Space: O(1)
+ */
+unsigned long long tagBit(unsigned int id) {
+    return 1ULL << (id & 63);
+}
+
+
+/*
+taskHasTag() - Checks whether a task carries a tag
+ - Decided by the hot tag_mask alone while there are at most 64 tags
+ - Time: O(1), O(tags on the task) past 64 tags, Space: O(1)
+ - Example: taskHasTag(t, tagLookup("urgent")) -> 1 if t is tagged "urgent"
+ */
+int taskHasTag(const task* t, unsigned int id) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    if (id == TAG_NO_ID || !(t->tag_mask & tagBit(id))) {
+        return 0;
+    }
+    if (dict->count <= 64) {
+        return 1;
+    }
+    taskcold* cold = taskCold(t);
+    for (int i = 0; i < cold->tag_count; i++) {
+        if (cold->tag_ids[i] == id) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/*
+taskAddTag() - Appends a tag id to a task (caller checks for duplicates)
+ - Does not touch any tag index; use listAddTag() for tasks in a list
+ - Time: O(1) amortized, Space: O(1) amortized
+ - Returns 1 on success, 0 if memory allocation failed
+ */
+int taskAddTag(task* t, unsigned int id) {
+    taskcold* cold = taskCold(t);
+    if (cold->tag_count == cold->tag_capacity) {
+        int new_capacity = cold->tag_capacity ? cold->tag_capacity * 2 : TASK_TAGS_INITIAL_CAPACITY;
+        unsigned int* ids = (unsigned int*)epochResize(cold->tag_ids, cold->tag_count * sizeof(unsigned int),
+                                                       new_capacity * sizeof(unsigned int));
+        if (!ids) {
+            return 0;
+        }
+        EPOCH_PUBLISH(cold->tag_ids, ids);
+        unsigned int* slots = (unsigned int*)realloc(cold->tag_slots, new_capacity * sizeof(unsigned int));
+        if (!slots) {
+            return 0;
+        }
+        cold->tag_slots = slots;
+        cold->tag_capacity = new_capacity;
+    }
+    cold->tag_ids[cold->tag_count] = id;
+    EPOCH_PUBLISH(cold->tag_count, cold->tag_count + 1);  // the id is in place first
+    t->tag_mask |= tagBit(id);
+    return 1;
+}
+
+
+/*
+taskReplaceTag() - Swaps the tag at one position for another tag id
+ - Time: O(tags on the task), Space: O(1)
+ */
+void taskReplaceTag(task* t, int index, unsigned int id) {
+    taskcold* cold = taskCold(t);
+    cold->tag_ids[index] = id;
+
+    // Another tag may share the old tag's bit, so rebuild the mask
+    t->tag_mask = 0;
+    for (int i = 0; i < cold->tag_count; i++) {
+        t->tag_mask |= tagBit(cold->tag_ids[i]);
+    }
+}
+
+
+/*
+taskTagCount() - Returns how many tags a task has
+ - Time: O(1), Space: O(1)
+ */
+int taskTagCount(const task* t) {
+    return EPOCH_LOAD(taskCold(t)->tag_count);
+}
+
+
+/*
+taskTagName() - Returns the name of the index-th tag on a task
+ - Time: O(1), Space: O(1)
+ */
+const char* taskTagName(const task* t, int index) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    return EPOCH_LOAD(dict->names)[EPOCH_LOAD(taskCold(t)->tag_ids)[index]];
+}
+
+
+/*
+writeTaskTags() - Writes a task's tags as "a, b, c"
+ - Time: O(total tag length), Space: O(1)
+ - Returns the number of characters written (for column padding)
+ - Example: writeTaskTags(stdout, t) -> prints "urgent, home", returns 12
+ */
+int writeTaskTags(FILE* out, const task* t) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    taskcold* cold = taskCold(t);
+    int written = 0;
+    for (int i = 0; i < cold->tag_count; i++) {
+        written += fprintf(out, "%s%s", dict->names[cold->tag_ids[i]],
+                           (i < cold->tag_count - 1) ? ", " : "");
+    }
+    return written;
+}
+
+
+/*
+tagDictReset() - Frees every interned name
+ - Time: O(tags), Space: O(1)
+ */
+void tagDictReset(void) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    for (unsigned int id = 0; id < dict->count; id++) {
+        free(dict->names[id]);
+    }
+    free(dict->names);
+    free(dict->slots);
+    memset(dict, 0, sizeof(*dict));
+}
+
+
+/*
+printTagDictStats() - Prints the size of the tag dictionary
+ - Time: O(1), Space: O(1)
+ - Sample Case:
+    Output:
+      --- Tag Dictionary ---
+      Tags: 3 (capacity 16, table 32 slots), tag_mask exact: yes
+ */
+void printTagDictStats(void) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    printf("--- Tag Dictionary ---\n");
+    printf("Tags: %u (capacity %u, table %u slots), tag_mask exact: %s\n",
+           dict->count, dict->capacity, dict->slot_capacity,
+           dict->count <= 64 ? "yes" : "no");
+}
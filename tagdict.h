@@ -0,0 +1,33 @@
+#ifndef TAGDICT_H
+#define TAGDICT_H
+
+#include <stdio.h>
+#include "scheduler.h"
+
+// Returned when a tag name is not in the dictionary (or memory ran out)
+#define TAG_NO_ID 0xFFFFFFFFu
+
+// Every tag name used so far, interned to a small integer id.
+// Tasks store ids; the name is only looked up for printing.
+typedef struct {
+    char** names;            // names[id]
+    unsigned int count;
+    unsigned int capacity;
+    unsigned int* slots;     // open-addressing table of id + 1 (0 = empty)
+    unsigned int slot_capacity;
+} tagdictionary;
+
+unsigned int tagIntern(const char* name);
+unsigned int tagLookup(const char* name);
+const char* tagName(unsigned int id);
+unsigned long long tagBit(unsigned int id);
+int taskHasTag(const task* t, unsigned int id);
+int taskAddTag(task* t, unsigned int id);
+void taskReplaceTag(task* t, int index, unsigned int id);
+int taskTagCount(const task* t);
+const char* taskTagName(const task* t, int index);
+int writeTaskTags(FILE* out, const task* t);
+void tagDictReset(void);
+void printTagDictStats(void);
+
+#endif
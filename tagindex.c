@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tagindex.h"
+#include "task_management.h"
+
+#define POSTING_INITIAL_CAPACITY 8
+
+
+/*
+tagIndexCover() - Makes sure a posting list exists for a tag id
+ - Time: O(tags) when the list array grows, O(1) otherwise, Space: O(tags)
+ - Returns 1 on success, 0 if memory allocation failed
+ */
+static int tagIndexCover(tagindex* idx, unsigned int tag_id) {
+    if (tag_id < idx->count) {
+        return 1;
+    }
+    unsigned int new_count = idx->count ? idx->count : 16;
+    while (new_count <= tag_id) {
+        new_count *= 2;
+    }
+    tagposting* lists = (tagposting*)realloc(idx->lists, new_count * sizeof(tagposting));
+    if (!lists) {
+        return 0;
+    }
+    memset(lists + idx->count, 0, (new_count - idx->count) * sizeof(tagposting));
+    idx->lists = lists;
+    idx->count = new_count;
+    return 1;
+}
+
+
+/*
+tagIndexInsert() - Adds a task to the posting list of its tag_index-th tag
+ - Time: O(1) amortized, Space: O(1) amortized
+ - Returns 1 on success, 0 if memory allocation failed
+ */
+int tagIndexInsert(tagindex* idx, task* t, int tag_index) {
+    taskcold* cold = taskCold(t);
+    unsigned int tag_id = cold->tag_ids[tag_index];
+    if (!tagIndexCover(idx, tag_id)) {
+        return 0;
+    }
+
+    tagposting* list = &idx->lists[tag_id];
+    if (list->count == list->capacity) {
+        int new_capacity = list->capacity ? list->capacity * 2 : POSTING_INITIAL_CAPACITY;
+        task** tasks = (task**)realloc(list->tasks, new_capacity * sizeof(task*));
+        if (!tasks) {
+            return 0;
+        }
+        list->tasks = tasks;
+        list->capacity = new_capacity;
+    }
+    cold->tag_slots[tag_index] = list->count;
+    list->tasks[list->count++] = t;
+    return 1;
+}
+
+
+/*
+tagIndexRemove() - Removes a task from the posting list of its tag_index-th tag
+ - The last entry moves into the freed position, so removal is O(1)
+ - Time: O(tags on the moved task), Space: O(1)
+ */
+void tagIndexRemove(tagindex* idx, task* t, int tag_index) {
+    taskcold* cold = taskCold(t);
+    unsigned int tag_id = cold->tag_ids[tag_index];
+    unsigned int pos = cold->tag_slots[tag_index];
+    if (tag_id >= idx->count) {
+        return;
+    }
+    tagposting* list = &idx->lists[tag_id];
+    if ((int)pos >= list->count || list->tasks[pos] != t) {
+        return; // Never made it into the index (allocation failed on insert)
+    }
+
+    task* moved = list->tasks[--list->count];
+    list->tasks[pos] = moved;
+    if (moved != t) {
+        taskcold* moved_cold = taskCold(moved);
+        for (int i = 0; i < moved_cold->tag_count; i++) {
+            if (moved_cold->tag_ids[i] == tag_id) {
+                moved_cold->tag_slots[i] = pos;
+                break;
+            }
+        }
+    }
+}
+
+
+/*
+tagIndexInsertTask() - Adds a task to the posting lists of all its tags
+ - Time: O(tags on the task), Space: O(tags on the task)
+ - Returns 1 on success, 0 if memory allocation failed (the task is then
+   in none of the posting lists)
+ */
+int tagIndexInsertTask(tagindex* idx, task* t) {
+    for (int i = 0; i < taskCold(t)->tag_count; i++) {
+        if (!tagIndexInsert(idx, t, i)) {
+            tagIndexRemoveTask(idx, t);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*
+tagIndexRemoveTask() - Removes a task from the posting lists of all its tags
+ - Time: O(tags on the task), Space: O(1)
+ */
+void tagIndexRemoveTask(tagindex* idx, task* t) {
+    for (int i = 0; i < taskCold(t)->tag_count; i++) {
+        tagIndexRemove(idx, t, i);
+    }
+}
+
+
+/*
+tagIndexCount() - Number of tasks in the list carrying a tag
+ - Time: O(1), Space: O(1)
+ - Example: tagIndexCount(&tasks.tags, tagLookup("urgent")) -> 3
+ */
+int tagIndexCount(tagindex* idx, unsigned int tag_id) {
+    return tag_id < idx->count ? idx->lists[tag_id].count : 0;
+}
+
+
+/*
+tagIndexQuery() - Tasks carrying all (match_all) or any of the given tags
+ - AND walks only the shortest posting list and keeps tasks whose
+   tag_mask holds every other tag
+ - OR walks each posting list and skips tasks already reported
+   through an earlier tag of the query
+ - Results are newest-tagged first; *out must be freed by the caller
+ - Time: O(shortest list · n) for AND, O(total postings · n) for OR,
+   where n is the number of query tags; Space: O(matches)
+ - Sample Case:
+    Input: urgent = [A, B, C], home = [B, D], query {urgent, home}
+    Output: match_all = 1 -> [B]; match_all = 0 -> [C, B, A, D]
+ */
+int tagIndexQuery(tagindex* idx, const unsigned int* tag_ids, int n, int match_all, task*** out) {
+    *out = NULL;
+    idx->queries++;
+    if (n <= 0) {
+        return 0;
+    }
+
+    // Upper bound on the result size, and the shortest list for AND
+    int bound = 0;
+    int shortest = 0;
+    for (int q = 0; q < n; q++) {
+        int count = tagIndexCount(idx, tag_ids[q]);
+        if (match_all) {
+            if (count < tagIndexCount(idx, tag_ids[shortest])) {
+                shortest = q;
+            }
+        } else {
+            bound += count;
+        }
+    }
+    if (match_all) {
+        bound = tagIndexCount(idx, tag_ids[shortest]);
+    }
+    if (bound == 0) {
+        return 0;
+    }
+
+    task** found = (task**)malloc(bound * sizeof(task*));
+    if (!found) {
+        return 0;
+    }
+
+    int matches = 0;
+    for (int q = match_all ? shortest : 0; q < n; q++) {
+        if (tag_ids[q] >= idx->count) {
+            continue;
+        }
+        tagposting* list = &idx->lists[tag_ids[q]];
+        for (int i = list->count - 1; i >= 0; i--) {
+            task* t = list->tasks[i];
+            int keep = 1;
+            idx->candidates++;
+            if (match_all) {
+                for (int other = 0; other < n && keep; other++) {
+                    keep = (other == q) || taskHasTag(t, tag_ids[other]);
+                }
+            } else {
+                for (int earlier = 0; earlier < q && keep; earlier++) {
+                    keep = !taskHasTag(t, tag_ids[earlier]);
+                }
+            }
+            if (keep) {
+                found[matches++] = t;
+            }
+        }
+        if (match_all) {
+            break;
+        }
+    }
+
+    idx->matches += matches;
+    *out = found;
+    return matches;
+}
+
+
+/*
+freeTagIndex() - Frees every posting list
+ - Time: O(tags), Space: O(1)
+ */
+void freeTagIndex(tagindex* idx) {
+    for (unsigned int i = 0; i < idx->count; i++) {
+        free(idx->lists[i].tasks);
+    }
+    free(idx->lists);
+    idx->lists = NULL;
+    idx->count = 0;
+}
+
+
+/*
+printTagIndexStats() - Prints posting list sizes and query counters
+ - Time: O(tags), Space: O(1)
+ - Sample Case:
+    Output:
+      --- Tag Index ---
+      Tags with tasks: 2 | Postings: 3 | Longest list: 2
+      Queries: 4 | Candidates checked: 5 | Matches: 4
+ */
+void printTagIndexStats(tagindex* idx) {
+    unsigned int used = 0;
+    long postings = 0;
+    int longest = 0;
+    for (unsigned int i = 0; i < idx->count; i++) {
+        int count = idx->lists[i].count;
+        if (count > 0) used++;
+        postings += count;
+        if (count > longest) longest = count;
+    }
+
+    printf("--- Tag Index ---\n");
+    printf("Tags with tasks: %u | Postings: %ld | Longest list: %d\n", used, postings, longest);
+    printf("Queries: %ld | Candidates checked: %ld | Matches: %ld\n",
+           idx->queries, idx->candidates, idx->matches);
+}
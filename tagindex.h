@@ -0,0 +1,35 @@
+#ifndef TAGINDEX_H
+#define TAGINDEX_H
+
+#include "scheduler.h"
+
+// Tasks carrying one tag, in the order they were tagged
+typedef struct {
+    task** tasks;
+    int count;
+    int capacity;
+} tagposting;
+
+// Inverted index tag id -> posting list, kept alongside the linked list.
+// Each task remembers its position in every posting list (taskcold.tag_slots)
+// so removal is O(1).
+typedef struct {
+    tagposting* lists;   // lists[tag id]
+    unsigned int count;  // tag ids covered so far
+
+    // query statistics for the debug report
+    long queries;
+    long candidates;
+    long matches;
+} tagindex;
+
+int tagIndexInsert(tagindex* idx, task* t, int tag_index);
+void tagIndexRemove(tagindex* idx, task* t, int tag_index);
+int tagIndexInsertTask(tagindex* idx, task* t);
+void tagIndexRemoveTask(tagindex* idx, task* t);
+int tagIndexCount(tagindex* idx, unsigned int tag_id);
+int tagIndexQuery(tagindex* idx, const unsigned int* tag_ids, int n, int match_all, task*** out);
+void freeTagIndex(tagindex* idx);
+void printTagIndexStats(tagindex* idx);
+
+#endif
@@ -6,42 +6,34 @@
 #include "scheduler.h"
 #include "task_management.h"
 #include "searchandstat.h" 
+#include "journal.h"
+#include "epoch.h"
+#include "taskstore.h"
+
+
 
 
 /*
-sortTasksByDueDate() - Bubble sorts tasks by due date
- - Time: O(n²), Space: O(1)
- - Sample Case:
-    Input: [Task3(15/05), Task1(10/05), Task2(no date)]
-    Output: [Task1(10/05), Task3(15/05), Task2(no date)]
+readLine() - Reads one whole line of any length, without the newline
+ - Caller frees the returned string; NULL means end of input
+ - Time: O(length), Space: O(length)
+ - Example: char* name = readLine(stdin); -> "Complete Assignment"
  */
-void sortTasksByDueDate(task* tasks[], int count) {
-    for (int i = 0; i < count - 1; i++) {
-        for (int j = 0; j < count - i - 1; j++) {
-            // Task with no due date goes to the end
-            if (!tasks[j]->due_date_set && tasks[j+1]->due_date_set) {
-                // Swap
-                task* temp = tasks[j];
-                tasks[j] = tasks[j+1];
-                tasks[j+1] = temp;
-            }
-            // Both have due dates, compare them
-            else if (tasks[j]->due_date_set && tasks[j+1]->due_date_set) {
-                if (compareDates(tasks[j]->duedate, tasks[j+1]->duedate) > 0) {
-                    // Swap
-                    task* temp = tasks[j];
-                    tasks[j] = tasks[j+1];
-                    tasks[j+1] = temp;
-                }
-            }
-        }
+char* readLine(FILE* in) {
+    char* line = NULL;
+    size_t capacity = 0;
+    if (getline(&line, &capacity, in) < 0) {
+        free(line);
+        return NULL;
     }
+    line[strcspn(line, "\n")] = 0;
+    return line;
 }
 
 
 /*
 add() - Adds a new task to the linked list
- - Steps: 1) Allocate memory 2) Get user input 3) Validate 4) Insert at head
+ - Steps: 1) Get user input 2) Validate 3) createTask() allocates it and inserts it at head
  - Time: O(n), Space: O(1)
  - Example: add(&tasks) -> prompts for task details -> adds to list
 
@@ -56,27 +48,18 @@ add() - Adds a new task to the linked list
     List now contains: "Complete Assignment" -> [previous tasks]
  */
 void add(tasklist* list) {
-    task* new_task = (task*)malloc(sizeof(task));
-    if (!new_task) {
-        printf("Memory allocation failed.\n");
-        return;
-    }
-
-    // Initialize tag-related fields right after allocation
-    new_task->tag_count = 0;  // Initialize with no tags
-
-    char task_name[100];
+    char* task_name = NULL;
     bool is_valid_name = false; 
 
     do {
         printf("Enter task name: ");
-        if (fgets(task_name, sizeof(task_name), stdin) == NULL) {
+        free(task_name);
+        task_name = readLine(stdin); // Any length; newline already removed
+        if (task_name == NULL) {
              // Handle potential input error 
              printf("Error reading input.\n");
-             free(new_task); // Clean up allocated memory
              return;
         }
-        task_name[strcspn(task_name, "\n")] = 0; // Remove trailing newline
 
         // Input Validation : Start 
         is_valid_name = true; 
@@ -113,74 +96,103 @@ void add(tasklist* list) {
         // Loop continues if the name was invalid (empty, whitespace, or duplicate)
     } while (!is_valid_name);
 
-    // Copy validated name to the task struct
-    strcpy(new_task->name, task_name);
-
     printf("Enter task description: ");
   
-    fgets(new_task->description, sizeof(new_task->description), stdin);
-    new_task->description[strcspn(new_task->description, "\n")] = 0;
+    char* description = readLine(stdin);
 
     printf("Enter priority (1-High, 2-Medium, 3-Low): ");
     
     char buffer[20];
     int priority_input = 0;
     if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
-        if (sscanf(buffer, "%d", &priority_input) == 1) {
-             new_task->priority = priority_input;
-        } else {
+        if (sscanf(buffer, "%d", &priority_input) != 1) {
             printf("Invalid priority input. Setting to Medium (2).\n");
-            new_task->priority = 2;
+            priority_input = 2;
         }
     } else {
         printf("Error reading priority input. Setting to Medium (2).\n");
-        new_task->priority = 2; 
+        priority_input = 2; 
     }
    
 
-    // Validate priority range
-    if (new_task->priority < 1 || new_task->priority > 3) {
+    // Validate priority range before it goes into the one-byte field
+    if (priority_input < 1 || priority_input > 3) {
         printf("Invalid priority value. Setting to Medium (2).\n");
-        new_task->priority = 2;
+        priority_input = 2;
     }
 
     // Get due date
+    date due;
+    int has_due = 0;
     printf("Enter due date (DD MM YYYY): ");
     if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
         int day, month, year;
         if (sscanf(buffer, "%d %d %d", &day, &month, &year) == 3) {
             // Validate date
             if (isValidDate(day, month, year)) {
-                new_task->duedate.day = day;
-                new_task->duedate.month = month;
-                new_task->duedate.year = year;
-                new_task->due_date_set = 1;
+                due.day = day;
+                due.month = month;
+                due.year = year;
+                has_due = 1;
             } else {
                 printf("Invalid date (Day: %d, Month: %d, Year: %d). Due date not set.\n",
                        day, month, year);
-                new_task->due_date_set = 0;
             }
         } else {
             printf("Invalid date format. Due date not set.\n");
-            new_task->due_date_set = 0;
         }
     } else {
         printf("Error reading date input. Due date not set.\n");
-        new_task->due_date_set = 0;
     }
 
-    new_task->completed = 0;
-    new_task->status = PENDING;  
-    new_task->next = list->head;
-    list->head = new_task;
+    task* new_task = createTask(list, task_name, description ? description : "", priority_input,
+                                has_due ? &due : NULL);
+    free(task_name);
+    free(description);
+    if (!new_task) {
+        printf("Memory allocation failed.\n");
+        return;
+    }
 
     printf("Task added successfully!\n");
 }
 
 
+/*
+createTask() - Creates a pending task from fields that are already validated and links it
+ - The name must not be in the list yet; due may be NULL for no due date
+ - Shared by add() and anything else that adds tasks without prompting
+ - Time: O(log n + text length) amortized, Space: O(text length)
+ - Returns the task, or NULL if memory allocation failed (nothing is added)
+ - Example: createTask(&tasks, "Study", "Chapter 3", 1, NULL) -> new list head
+ */
+task* createTask(tasklist* list, const char* name, const char* description, int priority, const date* due) {
+    task* t = newTask();  // hot and cold records start zeroed (no tags)
+    if (!t) {
+        return NULL;
+    }
+    if (!setTaskName(t, name) || !setTaskDescription(t, description)) {
+        destroyTask(t);
+        return NULL;
+    }
+    t->priority = priority;
+    if (due) {
+        setDueDate(t, due->day, due->month, due->year);
+    }
+    t->completed = 0;
+    t->status = PENDING;
+    if (!linkTask(list, t)) {
+        destroyTask(t);
+        return NULL;
+    }
+    journalTask(t, JOURNAL_NO_DAY);
+    return t;
+}
+
+
 /*
 isTaskNameDuplicate() - Checks if task name already exists
- - Time: O(n), Space: O(1)
+ - Time: O(1) average, Space: O(1)
  - Sample Case:
     Input: 
       List: ["Study", "Project", "Meeting"]
@@ -189,20 +201,313 @@ isTaskNameDuplicate() - Checks if task name already exists
       Returns 1 (duplicate found)
  */
 int isTaskNameDuplicate(tasklist* list, const char* name) {
-    task* current = list->head;
-    while (current) {
-        if (strcmp(current->name, name) == 0) {
-            return 1; // Name exists
+    return findTask(list, name) != NULL;
+}
+
+
+/*
+findTask() - Finds a pending task by exact name using the name index
+ - Time: O(1) average, Space: O(1)
+ - Example: findTask(&tasks, "Study") -> pointer to "Study" or NULL
+ */
+task* findTask(tasklist* list, const char* name) {
+    return nameIndexFind(&list->names, name);
+}
+
+
+/*
+linkTask() - Inserts a task at the head of the list and indexes its name, tags, due date and view order
+ - A dated task gets its status for the tracked day (OVERDUE or PENDING)
+ - Its text goes into the trigram index unless it is already there (undo)
+ - The task gets its place in view order, its status and its index
+   entries before it is published as the head, so a reader thread walking
+   from the head never sees it half linked
+ - Time: O(log n + tags on the task) amortized, Space: O(1)
+ - Returns 1 on success, 0 if memory allocation failed (the task is in
+   none of the indexes and not in the list; the caller still owns it)
+ - Example: linkTask(&tasks, t) -> t becomes list->head
+ */
+int linkTask(tasklist* list, task* t) {
+    t->prev = NULL;
+    t->next = list->head;
+    if (!nameIndexInsert(&list->names, t)) {
+        return 0;
+    }
+    if (!tagIndexInsertTask(&list->tags, t)) {
+        nameIndexRemove(&list->names, t);
+        return 0;
+    }
+    if (!dueTrackerInsert(&list->due, t)) {
+        tagIndexRemoveTask(&list->tags, t);
+        nameIndexRemove(&list->names, t);
+        return 0;
+    }
+    t->seq = list->order.next_seq;
+    if (!orderIndexInsert(&list->order, t)) {
+        dueTrackerRemove(&list->due, t);
+        tagIndexRemoveTask(&list->tags, t);
+        nameIndexRemove(&list->names, t);
+        return 0;
+    }
+    list->order.next_seq++;
+    if (!textIndexHas(t)) {
+        textIndexTask(t);   // on failure searches fall back to a scan
+    }
+    if (list->head) {
+        list->head->prev = t;
+    }
+    EPOCH_PUBLISH(list->head, t);
+    return 1;
+}
+
+
+/*
+newTask() - Allocates a zeroed hot record and its cold record
+ - Time: O(1) amortized, Space: O(1)
+ - Example: task* t = newTask(); -> NULL if out of memory
+ */
+task* newTask(void) {
+    task* t = (task*)slabAlloc(&currentStore->task_slab);
+    if (!t) {
+        return NULL;
+    }
+    memset(t, 0, sizeof(task));
+    t->id = coldStoreAlloc();
+    if (t->id == COLDSTORE_NO_ID) {
+        slabFree(&currentStore->task_slab, t);
+        return NULL;
+    }
+    t->status = PENDING;
+    return t;
+}
+
+
+// Frees the records of a task no reader thread can reach any more
+static void releaseTask(void* object) {
+    task* t = (task*)object;
+    coldStoreFree(t->id);
+    slabFree(&currentStore->task_slab, t);
+}
+
+
+/*
+destroyTask() - Frees the hot and cold records of a task
+ - The task must already be unlinked from the list and the completion log;
+   while reader threads run, the records are kept until they have moved on
+ - Time: O(1), Space: O(1)
+ */
+void destroyTask(task* t) {
+    textIndexDrop(t);
+    epochRetire(t, releaseTask);
+}
+
+
+/*
+unlinkTask() - Removes a task from the list and all its indexes (does not free it)
+ - t->next is left alone, so a reader thread standing on t walks on into
+   the list; t->prev is only used by the writer and is cleared
+ - Time: O(log n + tags on the task), Space: O(1)
+ - Example: unlinkTask(&tasks, t) -> t is no longer reachable from list->head
+ */
+void unlinkTask(tasklist* list, task* t) {
+    nameIndexRemove(&list->names, t);
+    tagIndexRemoveTask(&list->tags, t);
+    orderIndexRemove(&list->order, t);
+    dueTrackerRemove(&list->due, t);
+    if (t->prev) {
+        EPOCH_PUBLISH(t->prev->next, t->next);
+    } else {
+        EPOCH_PUBLISH(list->head, t->next);
+    }
+    if (t->next) {
+        t->next->prev = t->prev;
+    }
+    t->prev = NULL;
+}
+
+
+static int compareTaskCopies(const void* a, const void* b) {
+    return orderCompare(&((const taskcopy*)a)->key, &((const taskcopy*)b)->key);
+}
+
+
+/*
+copyPendingTasks() - Copies the pending tasks for a reader thread, which cannot use the view order tree
+ - Walks the list from its head, leaving out tasks completed during the walk;
+   with view_order set the copies are sorted as the tree orders them
+   (undisplayed priorities last), otherwise they stay newest first
+ - Time: O(n log n) with view_order, else O(n); Space: O(n)
+ - Returns the number of copies (*out must be freed), or -1 if memory ran out
+ */
+int copyPendingTasks(tasklist* list, int view_order, taskcopy** out) {
+    taskcopy* copies = NULL;
+    int count = 0, capacity = 0;
+    *out = NULL;
+    for (task* t = EPOCH_LOAD(list->head); t; t = EPOCH_LOAD(t->next)) {
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            taskcopy* grown = (taskcopy*)realloc(copies, capacity * sizeof(taskcopy));
+            if (!grown) {
+                free(copies);
+                return -1;
+            }
+            copies = grown;
         }
-        current = current->next;
+        copies[count].key = *t;
+        copies[count].t = t;
+        if (!copies[count].key.completed) {
+            count++;
+        }
+    }
+    if (view_order && count > 1) {
+        qsort(copies, count, sizeof(taskcopy), compareTaskCopies);
+    }
+    *out = copies;
+    return count;
+}
+
+
+/*
+listAddTag() - Adds a tag to a task in the list and to the tag index
+ - The task's text is re-indexed so keyword search finds the new tag
+ - Time: O(text length) amortized, Space: O(1) amortized
+ - Returns 1 on success, 0 if memory allocation failed
+ */
+int listAddTag(tasklist* list, task* t, unsigned int tag_id) {
+    if (!taskAddTag(t, tag_id)) {
+        return 0;
+    }
+    tagIndexInsert(&list->tags, t, taskCold(t)->tag_count - 1);
+    textIndexTask(t);
+    journalTag(t, tag_id);
+    return 1;
+}
+
+
+/*
+listReplaceTag() - Replaces one tag of a task in the list and moves it between posting lists
+ - Time: O(tags on the task + text length), Space: O(1)
+ */
+void listReplaceTag(tasklist* list, task* t, int index, unsigned int tag_id) {
+    tagIndexRemove(&list->tags, t, index);
+    taskReplaceTag(t, index, tag_id);
+    tagIndexInsert(&list->tags, t, index);
+    textIndexTask(t);
+    journalRetag(t, index, tag_id);
+}
+
+
+/*
+setTaskPriority() - Changes the priority of a task in the list and moves it in the view order
+ - Also moves it in or out of the due tracker's priority-raise heap; the
+   change is journaled whether it came from edit() or an automatic raise
+ - Room in the due tracker is reserved first and the view order node is
+   reused, so nothing can fail once the task has been taken out
+ - Time: O(log n), Space: O(1)
+ - Returns 1 on success, 0 if memory allocation failed (priority unchanged)
+ - Example: setTaskPriority(&tasks, t, 1) -> t is now listed with the high priority tasks
+ */
+int setTaskPriority(tasklist* list, task* t, int priority) {
+    if (t->priority == priority) {
+        return 1;
+    }
+    if (!dueTrackerReserve(&list->due)) {
+        return 0;
+    }
+    ordernode* node = orderIndexTake(&list->order, t);
+    dueTrackerRemove(&list->due, t);
+    t->priority = priority;
+    dueTrackerInsert(&list->due, t);
+    orderIndexPut(&list->order, node);
+    journalPriority(t);
+    return 1;
+}
+
+
+/*
+setTaskStatus() - Changes the status of a task in the list and moves it in the view order
+ - Time: O(log n) when the status changes, O(1) otherwise, Space: O(1)
+ */
+void setTaskStatus(tasklist* list, task* t, int status) {
+    if (t->status == status) {
+        return;
+    }
+    ordernode* node = orderIndexTake(&list->order, t);
+    t->status = status;
+    orderIndexPut(&list->order, node);
+}
+
+
+/*
+setTaskDue() - Sets or clears (due == NULL) the due date of a task in the list
+ - The task is re-tracked, so its status and view position follow the new date
+ - Time: O(log n), Space: O(1)
+ - Returns 1 on success, 0 if memory allocation failed (due date unchanged)
+ - Example: date d = {10, 5, 2025}; setTaskDue(&tasks, t, &d);
+ */
+int setTaskDue(tasklist* list, task* t, const date* due) {
+    if (!dueTrackerReserve(&list->due)) {
+        return 0;
+    }
+    ordernode* node = orderIndexTake(&list->order, t);
+    dueTrackerRemove(&list->due, t);
+    if (due) {
+        setDueDate(t, due->day, due->month, due->year);
+    } else {
+        t->due_date_set = 0;
+    }
+    dueTrackerInsert(&list->due, t);
+    orderIndexPut(&list->order, node);
+    journalDue(t);
+    return 1;
+}
+
+
+/*
+renameTask() - Renames a task in the list; the new name must not be taken
+ - Time: O(name length) average, Space: O(name length)
+ - Returns 1 on success, 0 if memory allocation failed (name unchanged)
+ - Example: renameTask(&tasks, t, "Study for exam")
+ */
+int renameTask(tasklist* list, task* t, const char* name) {
+    // The old text may move once the new one is stored; the journal needs a copy
+    char* old_name = NULL;
+    if (journalEnabled() && !(old_name = strdup(taskName(t)))) {
+        return 0;
+    }
+    nameIndexRemove(&list->names, t);
+    int renamed = setTaskName(t, name);
+    nameIndexInsert(&list->names, t);
+    if (renamed) {
+        textIndexTask(t);
+        if (old_name) {
+            journalRename(old_name, name);
+        }
+    }
+    free(old_name);
+    return renamed;
+}
+
+
+/*
+describeTask() - Replaces the description of a task and re-indexes its text
+ - Time: O(text length) amortized, Space: O(description length)
+ - Returns 1 on success, 0 if memory allocation failed (description unchanged)
+ */
+int describeTask(task* t, const char* description) {
+    if (!setTaskDescription(t, description)) {
+        return 0;
     }
-    return 0; // Name doesn't exist
+    textIndexTask(t);
+    journalDescribe(t);
+    return 1;
 }
 
 
 /*
 view() - Displays tasks sorted by priority and due date
- - Time: O(n²), Space: O(n)
+ - In-order walk of the view order index; nothing is sorted here
+ - Time: O(n), Space: O(log n)
  - Sample Case:
     Input: List with 3 tasks of different priorities
     Output:
@@ -216,76 +521,38 @@ view() - Displays tasks sorted by priority and due date
       -------------------------
  */
 void view(tasklist* list, date today) {
-    task* current = list->head;
     printf("\n=== Task List ===\n");
     
-    if (!current) {
+    if (!list->head) {
         printf("No tasks available.\n");
         return;
     }
     
-    // update statuses based on current date
-    updateTaskStatuses(current, today);
+    // update statuses based on current date (moves newly overdue tasks in the index)
+    updateTaskStatuses(list, today);
 
-    // Create arrays to store tasks by priority and status
-    task* high_priority[100];
-    task* medium_priority[100];
-    task* low_priority[100];
-    task* overdue_tasks[100];
-    
-    int high_count = 0, medium_count = 0, low_count = 0, overdue_count = 0;
-    
-    // Organize tasks by priority and status
-    while (current) {
-        // If task is overdue -> add to overdue array regardless of priority
-        if (!current->completed && current->status == OVERDUE) {
-            overdue_tasks[overdue_count++] = current;
-        } 
-        // Otherwise, categorize by priority
-        else if (!current->completed) {
-            switch (current->priority) {
-                case 1: high_priority[high_count++] = current; break;
-                case 2: medium_priority[medium_count++] = current; break;
-                case 3: low_priority[low_count++] = current; break;
-            }
-        }
-        current = current->next;
-    }
-    
-    // Sort overdue tasks by how overdue they are (most overdue first)
-    for (int i = 0; i < overdue_count - 1; i++) {
-        for (int j = 0; j < overdue_count - i - 1; j++) {
-            if (overdue_tasks[j]->due_date_set && overdue_tasks[j+1]->due_date_set) {
-                if (compareDates(overdue_tasks[j]->duedate, overdue_tasks[j+1]->duedate) > 0) {
-                    // Swap
-                    task* temp = overdue_tasks[j];
-                    overdue_tasks[j] = overdue_tasks[j+1];
-                    overdue_tasks[j+1] = temp;
-                }
-            }
-        }
-    }
-    
-    // Sort each priority group by due date
-    sortTasksByDueDate(high_priority, high_count);
-    sortTasksByDueDate(medium_priority, medium_count);
-    sortTasksByDueDate(low_priority, low_count);
+    // The index keeps overdue tasks first (most overdue first), then each
+    // priority group sorted by due date, so one walk prints every section
+    const int* counts = list->order.group_counts;
+    orderiter it;
+    orderIterBegin(&it, &list->order);
     
     // Display overdue tasks first
-    if (overdue_count > 0) {
+    if (counts[ORDER_GROUP_OVERDUE] > 0) {
         printf("\n--- OVERDUE TASKS ---\n");
-        for (int i = 0; i < overdue_count; i++) {
-            printf("Name: %s [OVERDUE]\n", overdue_tasks[i]->name);
-            printf("Description: %s\n", overdue_tasks[i]->description);
-            printf("Priority: %d (%s)\n", overdue_tasks[i]->priority, 
-                   (overdue_tasks[i]->priority == 1) ? "High" : 
-                   (overdue_tasks[i]->priority == 2) ? "Medium" : "Low");
+        while (orderIterPeek(&it) && orderGroup(orderIterPeek(&it)) == ORDER_GROUP_OVERDUE) {
+            task* t = orderIterNext(&it);
+            printf("Name: %s [OVERDUE]\n", taskName(t));
+            printf("Description: %s\n", taskDescription(t));
+            printf("Priority: %d (%s)\n", t->priority, 
+                   (t->priority == 1) ? "High" : 
+                   (t->priority == 2) ? "Medium" : "Low");
             
-            if (overdue_tasks[i]->due_date_set) {
+            if (t->due_date_set) {
                 printf("Due Date: %02d/%02d/%04d (PAST DUE)\n", 
-                       overdue_tasks[i]->duedate.day, 
-                       overdue_tasks[i]->duedate.month, 
-                       overdue_tasks[i]->duedate.year);
+                       taskDueDate(t).day, 
+                       taskDueDate(t).month, 
+                       taskDueDate(t).year);
             } else {
                 printf("Due Date: Not Set\n");
             }
@@ -293,116 +560,42 @@ void view(tasklist* list, date today) {
         }
     }
     
-    // Display high priority tasks
-    if (high_count > 0) {
-        printf("\n--- HIGH PRIORITY TASKS ---\n");
-        printf("(Sorted by due date - earliest first)\n");
-        for (int i = 0; i < high_count; i++) {
-            printf("Name: %s", high_priority[i]->name);
-            
-            // Show urgent tag for tasks due soon
-            if (high_priority[i]->due_date_set && isDateSoon(today, high_priority[i]->duedate, 2)) {
-                printf(" [!]URGENT");
-            }
-            printf("\n");
-            
-            printf("Description: %s\n", high_priority[i]->description);
-            printf("Status: Pending\n");
-            
-            if (high_priority[i]->due_date_set) {
-                printf("Due Date: %02d/%02d/%04d", 
-                       high_priority[i]->duedate.day, 
-                       high_priority[i]->duedate.month, 
-                       high_priority[i]->duedate.year);
-                
-                // Calculate days until due
-                int daysLeft = getDaysBetween(today, high_priority[i]->duedate);
-                if (daysLeft == 0) {
-                    printf(" (DUE TODAY)");
-                } else if (daysLeft == 1) {
-                    printf(" (DUE TOMORROW)");
-                } else if (daysLeft > 0) {
-                    printf(" (%d days left)", daysLeft);
-                }
-                printf("\n");
-            } else {
-                printf("Due Date: Not Set\n");
-            }
-            printf("-------------------------\n");
-        }
-    } else {
-        printf("\n--- HIGH PRIORITY TASKS ---\n");
-        printf("No high priority tasks.\n");
-        printf("-------------------------\n");
-    }
+    // high, medium and low priority tasks
+    const char* group_titles[] = {"", "HIGH", "MEDIUM", "LOW"};
+    const char* group_names[] = {"", "high", "medium", "low"};
+    int urgent_count = 0;
     
-    // medium priority tasks
-    if (medium_count > 0) {
-        printf("\n--- MEDIUM PRIORITY TASKS ---\n");
-        printf("(Sorted by due date - earliest first)\n");
-        for (int i = 0; i < medium_count; i++) {
-            printf("Name: %s", medium_priority[i]->name);
-            
-            // Show urgent tag for tasks due soon
-            if (medium_priority[i]->due_date_set && isDateSoon(today, medium_priority[i]->duedate, 2)) {
-                printf(" [!]URGENT");
-            }
-            printf("\n");
-            
-            printf("Description: %s\n", medium_priority[i]->description);
-            printf("Status: Pending\n");
-            
-            if (medium_priority[i]->due_date_set) {
-                printf("Due Date: %02d/%02d/%04d", 
-                       medium_priority[i]->duedate.day, 
-                       medium_priority[i]->duedate.month, 
-                       medium_priority[i]->duedate.year);
-                
-                // Calculate days until due
-                int daysLeft = getDaysBetween(today, medium_priority[i]->duedate);
-                if (daysLeft == 0) {
-                    printf(" (DUE TODAY)");
-                } else if (daysLeft == 1) {
-                    printf(" (DUE TOMORROW)");
-                } else if (daysLeft > 0) {
-                    printf(" (%d days left)", daysLeft);
-                }
-                printf("\n");
-            } else {
-                printf("Due Date: Not Set\n");
-            }
+    for (int group = ORDER_GROUP_HIGH; group <= ORDER_GROUP_LOW; group++) {
+        printf("\n--- %s PRIORITY TASKS ---\n", group_titles[group]);
+        if (counts[group] == 0) {
+            printf("No %s priority tasks.\n", group_names[group]);
             printf("-------------------------\n");
+            continue;
         }
-    } else {
-        printf("\n--- MEDIUM PRIORITY TASKS ---\n");
-        printf("No medium priority tasks.\n");
-        printf("-------------------------\n");
-    }
-    
-    // low priority tasks
-    if (low_count > 0) {
-        printf("\n--- LOW PRIORITY TASKS ---\n");
+        
         printf("(Sorted by due date - earliest first)\n");
-        for (int i = 0; i < low_count; i++) {
-            printf("Name: %s", low_priority[i]->name);
+        while (orderIterPeek(&it) && orderGroup(orderIterPeek(&it)) == group) {
+            task* t = orderIterNext(&it);
+            printf("Name: %s", taskName(t));
             
             // Show urgent tag for tasks due soon
-            if (low_priority[i]->due_date_set && isDateSoon(today, low_priority[i]->duedate, 2)) {
+            if (t->due_date_set && isDueSoon(t, today, 2)) {
                 printf(" [!]URGENT");
+                urgent_count++;
             }
             printf("\n");
             
-            printf("Description: %s\n", low_priority[i]->description);
+            printf("Description: %s\n", taskDescription(t));
             printf("Status: Pending\n");
             
-            if (low_priority[i]->due_date_set) {
+            if (t->due_date_set) {
                 printf("Due Date: %02d/%02d/%04d", 
-                       low_priority[i]->duedate.day, 
-                       low_priority[i]->duedate.month, 
-                       low_priority[i]->duedate.year);
+                       taskDueDate(t).day, 
+                       taskDueDate(t).month, 
+                       taskDueDate(t).year);
                 
                 // Calculate days until due
-                int daysLeft = getDaysBetween(today, low_priority[i]->duedate);
+                int daysLeft = daysUntilDue(t, today);
                 if (daysLeft == 0) {
                     printf(" (DUE TODAY)");
                 } else if (daysLeft == 1) {
@@ -416,39 +609,19 @@ void view(tasklist* list, date today) {
             }
             printf("-------------------------\n");
         }
-    } else {
-        printf("\n--- LOW PRIORITY TASKS ---\n");
-        printf("No low priority tasks.\n");
-        printf("-------------------------\n");
     }
     
     // summary
-    int total_tasks = overdue_count + high_count + medium_count + low_count;
+    int total_tasks = counts[ORDER_GROUP_OVERDUE] + counts[ORDER_GROUP_HIGH] +
+                      counts[ORDER_GROUP_MEDIUM] + counts[ORDER_GROUP_LOW];
     printf("\n=== SUMMARY ===\n");
     printf("Total Active Tasks: %d\n", total_tasks);
-    printf("Overdue: %d\n", overdue_count);
-    printf("High Priority: %d\n", high_count);
-    printf("Medium Priority: %d\n", medium_count);
-    printf("Low Priority: %d\n", low_count);
-    
-    // Check if there are any urgent tasks due soon
-    int urgent_count = 0;
-    for (int i = 0; i < high_count; i++) {
-        if (high_priority[i]->due_date_set && isDateSoon(today, high_priority[i]->duedate, 2)) {
-            urgent_count++;
-        }
-    }
-    for (int i = 0; i < medium_count; i++) {
-        if (medium_priority[i]->due_date_set && isDateSoon(today, medium_priority[i]->duedate, 2)) {
-            urgent_count++;
-        }
-    }
-    for (int i = 0; i < low_count; i++) {
-        if (low_priority[i]->due_date_set && isDateSoon(today, low_priority[i]->duedate, 2)) {
-            urgent_count++;
-        }
-    }
+    printf("Overdue: %d\n", counts[ORDER_GROUP_OVERDUE]);
+    printf("High Priority: %d\n", counts[ORDER_GROUP_HIGH]);
+    printf("Medium Priority: %d\n", counts[ORDER_GROUP_MEDIUM]);
+    printf("Low Priority: %d\n", counts[ORDER_GROUP_LOW]);
     
+    // Urgent tasks (due within 2 days) were counted during the walk
     if (urgent_count > 0) {
         printf("Urgent Tasks (Due within 2 days): %d\n", urgent_count);
     }
@@ -457,7 +630,7 @@ void view(tasklist* list, date today) {
 
 /*
 edit() - Modifies existing task details
- - Time: O(n), Space: O(1)
+ - Time: O(1) average, Space: O(1)
  - Sample Case:
     Input:
       Task name: "Essay"
@@ -467,212 +640,222 @@ edit() - Modifies existing task details
       Task priority updated.
  */
 void edit(tasklist* list, const char* taskname) {
-    task* current = list->head;
-    while (current) {
-        if (strcmp(current->name, taskname) == 0) {
-            int choice;
-            char buffer[20]; 
-
-            printf("Editing task: %s\n", current->name);
-            printf("Choose what to edit:\n");
-            printf("1. Name\n");
-            printf("2. Description\n");
-            printf("3. Priority\n");
-            printf("4. Due Date\n");
-            printf("Enter your choice (1-4): ");
+    task* current = findTask(list, taskname);
+    if (!current) {
+        printf("Task '%s' not found.\n", taskname);
+        return;
+    }
 
-            
-            if (fgets(buffer, sizeof(buffer), stdin) == NULL || sscanf(buffer, "%d", &choice) != 1) {
-                printf("Invalid choice input. Aborting edit.\n");
-                return;
-            }
+    int choice;
+    char buffer[20]; 
 
-            switch (choice) {
-                case 1: {
-                    char new_name[100];
-                    bool is_duplicate; 
-                    bool format_valid_and_not_same; 
-
-                    do {
-                        printf("Enter new task name: ");
-                        if (fgets(new_name, sizeof(new_name), stdin) == NULL) {
-                            printf("Error reading input. Aborting name change.\n");
-                            return; 
-                        }
-                        new_name[strcspn(new_name, "\n")] = 0; 
+    printf("Editing task: %s\n", taskName(current));
+    printf("Choose what to edit:\n");
+    printf("1. Name\n");
+    printf("2. Description\n");
+    printf("3. Priority\n");
+    printf("4. Due Date\n");
+    printf("Enter your choice (1-4): ");
 
-                        // Input Validation : Start 
-                        bool is_valid_format = true;
-                        bool contains_only_whitespace = true;
+    
+    if (fgets(buffer, sizeof(buffer), stdin) == NULL || sscanf(buffer, "%d", &choice) != 1) {
+        printf("Invalid choice input. Aborting edit.\n");
+        return;
+    }
 
-                        // 1. Check if empty
-                        if (new_name[0] == '\0') {
-                            printf("Error: Task name cannot be empty. Please enter a valid name.\n");
-                            is_valid_format = false;
-                        } else {
-                            // 2. Check if only whitespace
-                            for (int i = 0; new_name[i] != '\0'; i++) {
-                                if (!isspace((unsigned char)new_name[i])) {
-                                    contains_only_whitespace = false;
-                                    break;
-                                }
-                            }
-                            if (contains_only_whitespace) {
-                                printf("Error: Task name cannot consist only of whitespace. Please enter a valid name.\n");
-                                is_valid_format = false;
-                            }
-                        }
-                        //Input Validation : End 
+    switch (choice) {
+        case 1: {
+            char* new_name = NULL;
+            bool is_duplicate; 
+            bool format_valid_and_not_same; 
 
-                        if (!is_valid_format) {
-                             is_duplicate = true; // Force loop repeat if format is bad
-                             format_valid_and_not_same = false;
-                             continue; 
-                        }
+            do {
+                printf("Enter new task name: ");
+                free(new_name);
+                new_name = readLine(stdin);
+                if (new_name == NULL) {
+                    printf("Error reading input. Aborting name change.\n");
+                    return; 
+                }
 
-                        // 3. Check if the new name is the same as the current one
-                        if (strcmp(new_name, current->name) == 0) {
-                            printf("The new name is the same as the current name. No change needed.\n");
-                             
-                            is_duplicate = false; 
-                            format_valid_and_not_same = false; 
-                            break; 
-                        }
+                // Input Validation : Start 
+                bool is_valid_format = true;
+                bool contains_only_whitespace = true;
 
-                        // 4. Check if it duplicates *another* existing task name
-                        is_duplicate = isTaskNameDuplicate(list, new_name);
-                        if (is_duplicate) {
-                            printf("Error: A task with this name already exists. Please choose a different name.\n");
-                            format_valid_and_not_same = false; 
-                        } else {
-                           
-                            format_valid_and_not_same = true; 
+                // 1. Check if empty
+                if (new_name[0] == '\0') {
+                    printf("Error: Task name cannot be empty. Please enter a valid name.\n");
+                    is_valid_format = false;
+                } else {
+                    // 2. Check if only whitespace
+                    for (int i = 0; new_name[i] != '\0'; i++) {
+                        if (!isspace((unsigned char)new_name[i])) {
+                            contains_only_whitespace = false;
+                            break;
                         }
+                    }
+                    if (contains_only_whitespace) {
+                        printf("Error: Task name cannot consist only of whitespace. Please enter a valid name.\n");
+                        is_valid_format = false;
+                    }
+                }
+                //Input Validation : End 
 
-                    } while (is_duplicate || !format_valid_and_not_same);
+                if (!is_valid_format) {
+                     is_duplicate = true; // Force loop repeat if format is bad
+                     format_valid_and_not_same = false;
+                     continue; 
+                }
 
-                    // Only copy if the loop finished with a valid, different, non-duplicate name
-                    if (format_valid_and_not_same) {
-                         strcpy(current->name, new_name);
-                         printf("Task name updated.\n"); 
-                    }
-                    break;
+                // 3. Check if the new name is the same as the current one
+                if (strcmp(new_name, taskName(current)) == 0) {
+                    printf("The new name is the same as the current name. No change needed.\n");
+                     
+                    is_duplicate = false; 
+                    format_valid_and_not_same = false; 
+                    break; 
                 }
-                case 2:
-                    printf("Enter new description: ");
-                    // Assuming description can be empty or whitespace, no validation added here
-                    // but you could add similar checks if needed.
-                    fgets(current->description, sizeof(current->description), stdin);
-                    current->description[strcspn(current->description, "\n")] = 0;
+
+                // 4. Check if it duplicates *another* existing task name
+                is_duplicate = isTaskNameDuplicate(list, new_name);
+                if (is_duplicate) {
+                    printf("Error: A task with this name already exists. Please choose a different name.\n");
+                    format_valid_and_not_same = false; 
+                } else {
+                   
+                    format_valid_and_not_same = true; 
+                }
+
+            } while (is_duplicate || !format_valid_and_not_same);
+
+            // Only copy if the loop finished with a valid, different, non-duplicate name
+            if (format_valid_and_not_same) {
+                 if (renameTask(list, current, new_name)) {
+                     printf("Task name updated.\n"); 
+                 } else {
+                     printf("Memory allocation failed. Task name not changed.\n");
+                 }
+            }
+            free(new_name);
+            break;
+        }
+        case 2:
+            printf("Enter new description: ");
+            // Assuming description can be empty or whitespace, no validation added here
+            // but you could add similar checks if needed.
+            {
+                char* description = readLine(stdin);
+                if (description && describeTask(current, description)) {
                     printf("Task description updated.\n");
-                    break;
-                case 3: {
-                    int priority_input;
-                    printf("Enter new priority (1-High, 2-Medium, 3-Low): ");
-                    if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
-                        if (sscanf(buffer, "%d", &priority_input) == 1) {
-                            // Validate priority range
-                            if (priority_input >= 1 && priority_input <= 3) {
-                                current->priority = priority_input;
-                                printf("Task priority updated.\n");
-                            } else {
-                                printf("Invalid priority value (%d). Priority not changed.\n", priority_input);
-                            }
+                } else {
+                    printf("Error reading description. Description not changed.\n");
+                }
+                free(description);
+            }
+            break;
+        case 3: {
+            int priority_input;
+            printf("Enter new priority (1-High, 2-Medium, 3-Low): ");
+            if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
+                if (sscanf(buffer, "%d", &priority_input) == 1) {
+                    // Validate priority range
+                    if (priority_input >= 1 && priority_input <= 3) {
+                        if (setTaskPriority(list, current, priority_input)) {
+                            printf("Task priority updated.\n");
                         } else {
-                            printf("Invalid priority input format. Priority not changed.\n");
+                            printf("Memory allocation failed. Priority not changed.\n");
                         }
                     } else {
-                        printf("Error reading priority input. Priority not changed.\n");
+                        printf("Invalid priority value (%d). Priority not changed.\n", priority_input);
                     }
-                    break;
+                } else {
+                    printf("Invalid priority input format. Priority not changed.\n");
                 }
-                case 4: {
-                    printf("Due Date Options:\n");
-                    printf("1. Set/Change due date\n");
-                    printf("2. Clear due date\n");
-                    printf("Enter choice (1-2): ");
+            } else {
+                printf("Error reading priority input. Priority not changed.\n");
+            }
+            break;
+        }
+        case 4: {
+            printf("Due Date Options:\n");
+            printf("1. Set/Change due date\n");
+            printf("2. Clear due date\n");
+            printf("Enter choice (1-2): ");
+            
+            int due_date_choice;
+            if (fgets(buffer, sizeof(buffer), stdin) != NULL && sscanf(buffer, "%d", &due_date_choice) == 1) {
+                if (due_date_choice == 1) {
+                    // Set or change due date
+                    int valid_date = 0;
                     
-                    int due_date_choice;
-                    if (fgets(buffer, sizeof(buffer), stdin) != NULL && sscanf(buffer, "%d", &due_date_choice) == 1) {
-                        if (due_date_choice == 1) {
-                            // Set or change due date
-                            int valid_date = 0;
-                            
-                            while (!valid_date) {
-                                printf("Enter new due date (DD MM YYYY): ");
-                                int day, month, year;
-                                
-                                if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
-                                    if (sscanf(buffer, "%d %d %d", &day, &month, &year) == 3) {
-                                        if (isValidDate(day, month, year)) {
-                                            current->duedate.day = day;
-                                            current->duedate.month = month;
-                                            current->duedate.year = year;
-                                            current->due_date_set = 1;
-                                            valid_date = 1;
-                                            printf("Task due date updated.\n");
-                                        } else {
-                                            printf("Invalid date. Please enter a valid date.\n");
-                                        }
+                    while (!valid_date) {
+                        printf("Enter new due date (DD MM YYYY): ");
+                        int day, month, year;
+                        
+                        if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
+                            if (sscanf(buffer, "%d %d %d", &day, &month, &year) == 3) {
+                                if (isValidDate(day, month, year)) {
+                                    date due = {day, month, year};
+                                    valid_date = 1;
+                                    if (setTaskDue(list, current, &due)) {
+                                        printf("Task due date updated.\n");
                                     } else {
-                                        printf("Invalid date format. Please use DD MM YYYY format.\n");
+                                        printf("Memory allocation failed. Due date not changed.\n");
                                     }
                                 } else {
-                                    printf("Error reading date input. Due date not changed.\n");
-                                    break;
+                                    printf("Invalid date. Please enter a valid date.\n");
                                 }
+                            } else {
+                                printf("Invalid date format. Please use DD MM YYYY format.\n");
                             }
-                        } else if (due_date_choice == 2) {
-                            // Clear due date
-                            current->due_date_set = 0;
-                            printf("Due date cleared.\n");
                         } else {
-                            printf("Invalid choice. Due date not changed.\n");
+                            printf("Error reading date input. Due date not changed.\n");
+                            break;
                         }
+                    }
+                } else if (due_date_choice == 2) {
+                    // Clear due date
+                    if (setTaskDue(list, current, NULL)) {
+                        printf("Due date cleared.\n");
                     } else {
-                        printf("Invalid input. Due date not changed.\n");
+                        printf("Memory allocation failed. Due date not changed.\n");
                     }
-                    break;
+                } else {
+                    printf("Invalid choice. Due date not changed.\n");
                 }
-                default:
-                    printf("Invalid choice. Task not updated.\n");
-                    return;
+            } else {
+                printf("Invalid input. Due date not changed.\n");
             }
-            return;
+            break;
         }
-        current = current->next;
+        default:
+            printf("Invalid choice. Task not updated.\n");
+            return;
     }
-    printf("Task '%s' not found.\n", taskname);
 }
 
 
 /*
-complete() - Moves task from active list to completed stack
- - Time: O(n), Space: O(1)
+complete() - Moves task from active list to the completion log, stamped with today
+ - Time: O(1) average, Space: O(1) amortized
  - Sample Case:
-    Input: Task name: "Submit Report"
+    Input: Task name: "Submit Report", today = 05/05/2025
     Before: 
       Active List: "Submit Report" -> "Task 2" -> NULL
-      Stack: [empty]
+      Log: [empty]
     After:
       Active List: "Task 2" -> NULL
-      Stack: "Submit Report" -> NULL
+      Log: ["Submit Report" on 05/05/2025]
     Output: "Task 'Submit Report' marked as completed!"
  */
-void complete(tasklist* list, completedstack* stack, const char* taskname) {
-    if (!list || !stack || !taskname) {
+void complete(tasklist* list, completionlog* done, const char* taskname, date today) {
+    if (!list || !done || !taskname) {
         printf("Error: Invalid parameters for complete function.\n");
         return;
     }
     
-    task* current = list->head;
-    task* prev = NULL;
-    
     // Find the task to complete
-    while (current && strcmp(current->name, taskname) != 0) {
-        prev = current;
-        current = current->next;
-    }
+    task* current = findTask(list, taskname);
     
     if (!current) {
         printf("Task not found: %s\n", taskname);
@@ -680,35 +863,14 @@ void complete(tasklist* list, completedstack* stack, const char* taskname) {
     }
     
     // Debug info
-    printf("Found task: %s (Priority: %d)\n", current->name, current->priority);
+    printf("Found task: %s (Priority: %d)\n", taskName(current), current->priority);
     
-    // Allocate stack node first to check for memory issues
-    stacknode* node = (stacknode*)malloc(sizeof(stacknode));
-    if (!node) {
-        printf("Memory allocation failed for stack node. Task remains in list.\n");
+    if (!completeTask(list, done, current, today)) {
+        printf("Memory allocation failed for completion log. Task remains in list.\n");
         return;
     }
     
-    // Mark the task as completed
-    current->status = COMPLETED;
-    current->completed = 1;
-    
-    // Remove from list first
-    if (prev) {
-        prev->next = current->next;
-    } else {
-        list->head = current->next;
-    }
-    
-    // Clear the next pointer to avoid circular references
-    current->next = NULL;
-    
-    // Push onto stack
-    node->task_data = current;
-    node->next = stack->top;
-    stack->top = node;
-    
-    printf("Task '%s' marked as completed and moved to stack!\n", current->name);
+    printf("Task '%s' marked as completed!\n", taskName(current));
 }
 
 /*
@@ -717,40 +879,28 @@ undoCompleted() - Restores last completed task to active list
  - Sample Case:
     Before:
       Active: ["Task A"] -> NULL
-      Stack: ["Completed Task"] -> NULL
+      Log: ["Completed Task"]
     After:
       Active: ["Completed Task"] -> ["Task A"] -> NULL
-      Stack: NULL
+      Log: [empty]
     Output: "Last completed task restored to the list."
  */
-void undoCompleted(tasklist* list, completedstack* stack) {
-    if (!stack->top) {
+void undoCompleted(tasklist* list, completionlog* done) {
+    if (done->count == 0) {
         printf("No completed tasks to undo.\n");
         return;
     }
+    if (!undoCompleteTask(list, done)) {
+        printf("Memory allocation failed.\n");
+        return;
+    }
 
-    // Pop stack node
-    stacknode* node = stack->top;
-    stack->top = node->next;
-
-    // Get the task POINTER back
-    task* restored = node->task_data;
-
-    // Update task status back to pending
-    restored->status = PENDING;
-    restored->completed = 0;
-
-    // Add task back to the main list (at the head)
-    restored->next = list->head;
-    list->head = restored;
-
-    free(node); // Free ONLY the stack node wrapper, not the task data
     printf("Last completed task restored to the list.\n");
 }
 
 /*
 deleteTask() - Permanently removes task from list
- - Time: O(n), Space: O(1)
+ - Time: O(1) average, Space: O(1)
  - Sample Case:
     Input: Task name: "Old Task"
     Before: ["Task 1"] -> ["Old Task"] -> ["Task 3"]
@@ -758,21 +908,86 @@ deleteTask() - Permanently removes task from list
     Output: "Task deleted."
  */
 void deleteTask(tasklist* list, const char* taskname) {
-    task* current = list->head, *prev = NULL;
-    while (current && strcmp(current->name, taskname) != 0) {
-        prev = current;
-        current = current->next;
-    }
+    task* current = findTask(list, taskname);
     if (!current) {
         printf("Task not found.\n");
         return;
     }
-    if (prev) prev->next = current->next;
-    else list->head = current->next;
-    free(current);
+    removeTask(list, current);
     printf("Task deleted.\n");
 }
 
+
+/*
+completeTask() - Moves a pending task to the completion log, stamped with today
+ - Time: O(log n) average, Space: O(1) amortized
+ - Returns 1 on success, 0 if the log could not grow (task stays in the list)
+ - Example: completeTask(&tasks, &doneLog, t, currentDate) -> t is the newest log entry
+ */
+int completeTask(tasklist* list, completionlog* done, task* t, date today) {
+    unsigned int day = (unsigned int)dateToDays(today);
+
+    // Log it first to check for memory issues
+    if (!completionLogAppend(done, t, day)) {
+        return 0;
+    }
+    journalComplete(t, day);
+
+    // Remove from list; its view order key must still be the one it was indexed with
+    unlinkTask(list, t);
+
+    // Mark the task as completed; seq now orders it within the log
+    t->status = COMPLETED;
+    t->completed = 1;
+    t->seq = (unsigned int)(done->count - 1);
+    return 1;
+}
+
+
+/*
+undoCompleteTask() - Takes the newest completion off the log and relinks its task at the head
+ - Time: O(log n) average, Space: O(1)
+ - Returns the restored task, or NULL when the log is empty or memory
+   allocation failed (the completion is then put back on the log)
+ */
+task* undoCompleteTask(tasklist* list, completionlog* done) {
+    // Take the most recent completion back off the log
+    task* restored = completionLogPop(done);
+    if (!restored) {
+        return NULL;
+    }
+
+    // Update task status back to pending
+    restored->status = PENDING;
+    restored->completed = 0;
+
+    // A reader thread may still be standing on the task from before it was
+    // completed; relinking it now would send that reader back to the head
+    epochSynchronize();
+
+    // Add task back to the main list (at the head)
+    if (!linkTask(list, restored)) {
+        restored->status = COMPLETED;
+        restored->completed = 1;
+        restored->seq = (unsigned int)done->count;
+        completionLogUnpop(done);
+        return NULL;
+    }
+    journalUndo();
+    return restored;
+}
+
+
+/*
+removeTask() - Unlinks a pending task and frees it
+ - Time: O(log n + tags on the task), Space: O(1)
+ */
+void removeTask(tasklist* list, task* t) {
+    journalDelete(t);
+    unlinkTask(list, t);
+    destroyTask(t);
+}
+
 /*
 sortTasks() - Sorts tasks by priority (insertion sort)
  - Time: O(n²), Space: O(1)
@@ -797,26 +1012,28 @@ void sortTasks(tasklist* list) {
         }
     }
     list->head = sorted;
+
+    // Re-link the back pointers for the new order
+    task* prev = NULL;
+    for (task* t = list->head; t; t = t->next) {
+        t->prev = prev;
+        prev = t;
+    }
     printf("Tasks sorted by priority.\n");
 }
 
 /*
 progress() - Shows completion statistics
  - Time: O(n), Space: O(1)
- - Example: progress(&tasks, &stack) -> "Progress: 5 completed out of 10 (50%)"
+ - Example: progress(&tasks, &doneLog) -> "Progress: 5 completed out of 10 (50%)"
  */
-void progress(tasklist* list, completedstack* stack) {
-    int total = 0, done = 0;
+void progress(tasklist* list, completionlog* completed) {
+    int total = 0, done = completed->count;
     task* cur = list->head;
     while (cur) {
         total++;
         cur = cur->next;
     }
-    stacknode* s = stack->top;
-    while (s) {
-        done++;
-        s = s->next;
-    }
     printf("Progress: %d tasks completed out of %d total (%.2f%%)\n",
            done, total + done,
            (total + done) ? (done * 100.0) / (total + done) : 0);
@@ -837,117 +1054,138 @@ void freeTasks(tasklist* list) {
     
     current = current->next;
     
-    free(temp);
+    destroyTask(temp);
     
     }
+
+    list->head = NULL;
+    freeNameIndex(&list->names);
+    freeTagIndex(&list->tags);
+    freeOrderIndex(&list->order);
+    freeDueTracker(&list->due);
     
     }
     
 
 /*
-freeStack() - Frees all memory in completed stack
+freeCompleted() - Frees every completed task and the completion log
  - Time: O(n), Space: O(1)
- - Example: freeStack(&stack) -> deallocates all stack nodes and tasks
+ - Example: freeCompleted(&doneLog) -> deallocates the log and its tasks
  */
-void freeStack(completedstack* stack) {
-    stacknode* current = stack->top;
-    while (current) {
-        stacknode* temp = current;
-        current = current->next;
-        
-        if (temp->task_data) {
-             free(temp->task_data); // Free the actual task struct memory
-        }
-        free(temp);            // Free the stack node 
+void freeCompleted(completionlog* done) {
+    for (int i = 0; i < done->count; i++) {
+        destroyTask(done->entries[i].task_data); // Free the actual task records
     }
-    stack->top = NULL; // Explicitly set top to NULL
+    freeCompletionLog(done);
 }
 
 /*
-initQueue() - Initializes empty queue
- - Time: O(1), Space: O(1)
- - Example: initQueue(&queue) -> front=NULL, rear=NULL
+resetTaskMemory() - Drops every task and completion at once
+ - Used on exit instead of freeing each node one at a time
+ - Time: O(number of slab chunks), Space: O(1)
+ - Example: resetTaskMemory(&tasks, &doneLog) -> empty list and log
  */
-void initQueue(taskqueue* q) {
-    q->front = q->rear = NULL;
+void resetTaskMemory(tasklist* list, completionlog* done) {
+    list->head = NULL;
+    freeNameIndex(&list->names);
+    freeTagIndex(&list->tags);
+    memset(&list->order, 0, sizeof(list->order));
+    freeDueTracker(&list->due);
+    freeCompletionLog(done);
+
+    slabRelease(&currentStore->task_slab);
+    slabRelease(&currentStore->order_slab);
+    coldStoreReset();
+    tagDictReset();
+    textIndexReset();
 }
 
 
 /*
-enqueue() - Adds task to queue rear
- - Time: O(1), Space: O(1)
- - Sample Case:
-    Input: Task to add
-    Before: Queue: [Task1] -> [Task2]
-    After: Queue: [Task1] -> [Task2] -> [NewTask]
+printMemoryStats() - Prints allocation counters of all task slabs
+ - Time: O(number of slab chunks), Space: O(1)
+ - Example: printMemoryStats() -> called from the hidden debug option
  */
-void enqueue(taskqueue* q, task* t) {
-    queuenode* newNode = (queuenode*)malloc(sizeof(queuenode));
-    if (!newNode) {
-        printf("Memory allocation failed for queue node.\n");
-        return;
-    }
-    
-    newNode->task_data = t;
-    newNode->next = NULL;
-    
-    if (q->rear == NULL) {
-        q->front = q->rear = newNode;
-        return;
-    }
-    
-    q->rear->next = newNode;
-    q->rear = newNode;
+void printMemoryStats(void) {
+    printSlabStats(&currentStore->task_slab);
+    printSlabStats(&currentStore->order_slab);
+    printColdStoreStats();
+    printTagDictStats();
 }
 
+
 /*
-dequeue() - Removes task from queue front
- - Time: O(1), Space: O(1)
- - Sample Case:
-    Before: Queue: [Task1] -> [Task2] -> [Task3]
-    After: Queue: [Task2] -> [Task3]
-    Output: Returns Task1
+collectListTags() - Lists the distinct tags used by the tasks in a list
+ - Read from the tag index: a tag is in use when its posting list is not empty
+ - Time: O(dictionary size), Space: O(dictionary size)
+ - Returns the number of tags; *out must be freed by the caller
  */
-task* dequeue(taskqueue* q) {
-    if (q->front == NULL)
-        return NULL;
-    
-    queuenode* temp = q->front;
-    task* t = temp->task_data;
-    
-    q->front = q->front->next;
-    
-    if (q->front == NULL)
-        q->rear = NULL;
-    
-    free(temp);
-    return t;
+static int collectListTags(tasklist* list, unsigned int** out) {
+    tagdictionary* dict = &currentStore->tag_dict;
+    *out = NULL;
+    if (dict->count == 0) {
+        return 0;
+    }
+
+    unsigned int* ids = (unsigned int*)malloc(dict->count * sizeof(unsigned int));
+    if (!ids) {
+        return 0;
+    }
+
+    int tag_count = 0;
+    for (unsigned int id = 0; id < dict->count; id++) {
+        if (tagIndexCount(&list->tags, id) > 0) {
+            ids[tag_count++] = id;
+        }
+    }
+
+    *out = ids;
+    return tag_count;
 }
 
+
 /*
-isQueueEmpty() - Checks if queue is empty
- - Time: O(1), Space: O(1)
- - Example: isQueueEmpty(&queue) -> returns 1 if empty, 0 if not
+attachTag() - Interns a tag name and adds it to a task unless already there
+ - Time: O(len) average, Space: O(len) for a new tag name
  */
-int isQueueEmpty(taskqueue* q) {
-    return q->front == NULL;
+static void attachTag(tasklist* list, task* t, const char* tag, const char* taskname) {
+    unsigned int id = tagIntern(tag);
+    if (id == TAG_NO_ID) {
+        printf("Memory allocation failed. No tag added.\n");
+        return;
+    }
+    if (taskHasTag(t, id)) {
+        printf("This task already has the tag '%s'.\n", tag);
+        return;
+    }
+    if (!listAddTag(list, t, id)) {
+        printf("Memory allocation failed. No tag added.\n");
+        return;
+    }
+    printf("Tag '%s' added to task '%s'.\n", tag, taskname);
 }
 
 
 /*
-freeQueue() - Deallocates queue memory
- - Time: O(n), Space: O(1)
- - Example: freeQueue(&queue) -> frees all queue nodes
+readNewTag() - Prompts for a tag name of any length
+ - Time: O(len), Space: O(len)
+ - Returns NULL (after printing why) for empty input; caller frees
  */
-void freeQueue(taskqueue* q) {
-    while (!isQueueEmpty(q)) {
-        dequeue(q);
+static char* readNewTag(void) {
+    printf("Enter new tag: ");
+    char* new_tag = readLine(stdin);
+    if (!new_tag || strlen(new_tag) == 0) {
+        printf("Tag name cannot be empty.\n");
+        free(new_tag);
+        return NULL;
     }
+    return new_tag;
 }
 
+
 /*
-add_tag_to_task() - Adds tag to task (max 5 tags)
- - Time: O(n), Space: O(1)
+add_tag_to_task() - Adds a tag to a task or replaces one of its tags
+ - Time: O(n) to list existing tags, O(1) average to find the task and add the tag, Space: O(tags)
  - Sample Case:
     Input:
       Task name: "Research Paper"
@@ -957,95 +1195,23 @@ add_tag_to_task() - Adds tag to task (max 5 tags)
       "Tag 'urgent' added to task 'Research Paper'."
  */
 void add_tag_to_task(tasklist* list, const char* taskname) {
-    task* current = list->head;
-    
     // Find the task
-    while (current && strcmp(current->name, taskname) != 0) {
-        current = current->next;
-    }
+    task* current = findTask(list, taskname);
     
     if (!current) {
         printf("Task '%s' not found.\n", taskname);
         return;
     }
-    
-    // Check if task already has maximum number of tags
-    if (current->tag_count >= MAX_TAGS) {
-        printf("This task already has the maximum number of tags (%d).\n", MAX_TAGS);
-        printf("Current tags: ");
-        for (int i = 0; i < current->tag_count; i++) {
-            printf("%s%s", current->tags[i], (i < current->tag_count - 1) ? ", " : "");
-        }
-        printf("\n");
-        
-        // Ask if user wants to replace a tag
-        printf("Would you like to replace a tag? (y/n): ");
-        char choice[5];
-        fgets(choice, sizeof(choice), stdin);
-        if (choice[0] != 'y' && choice[0] != 'Y') {
-            return;
-        }
-        
-        // Show tags with numbers
-        printf("Select a tag to replace (1-%d):\n", current->tag_count);
-        for (int i = 0; i < current->tag_count; i++) {
-            printf("%d. %s\n", i + 1, current->tags[i]);
-        }
-        
-        // Get user choice
-        int tag_index;
-        char buffer[10];
-        fgets(buffer, sizeof(buffer), stdin);
-        sscanf(buffer, "%d", &tag_index);
-        
-        if (tag_index < 1 || tag_index > current->tag_count) {
-            printf("Invalid selection. No tags were changed.\n");
-            return;
-        }
-        
-        // Get new tag
-        printf("Enter new tag: ");
-        char new_tag[MAX_TAG_LENGTH];
-        fgets(new_tag, sizeof(new_tag), stdin);
-        new_tag[strcspn(new_tag, "\n")] = 0;
-        
-        // Replace tag
-        strcpy(current->tags[tag_index - 1], new_tag);
-        printf("Tag replaced successfully.\n");
-        return;
-    }
+    taskcold* cold = taskCold(current);
     
     // Collect all existing tags from all tasks
-    char unique_tags[100][MAX_TAG_LENGTH];  
-    int tag_count = 0;
-    
-    task* all_tasks = list->head;
-    while (all_tasks) {
-        for (int i = 0; i < all_tasks->tag_count; i++) {
-           
-            int is_unique = 1;
-            for (int j = 0; j < tag_count; j++) {
-                if (strcmp(all_tasks->tags[i], unique_tags[j]) == 0) {
-                    is_unique = 0;
-                    break;
-                }
-            }
-            
-            // If it's a new tag, add it to our array
-            if (is_unique) {
-                strcpy(unique_tags[tag_count], all_tasks->tags[i]);
-                tag_count++;
-            }
-        }
-        all_tasks = all_tasks->next;
-    }
+    unsigned int* unique_tags;
+    int tag_count = collectListTags(list, &unique_tags);
     
     // Show current tags on the task
-    if (current->tag_count > 0) {
+    if (cold->tag_count > 0) {
         printf("\nCurrent tags on this task: ");
-        for (int i = 0; i < current->tag_count; i++) {
-            printf("%s%s", current->tags[i], (i < current->tag_count - 1) ? ", " : "");
-        }
+        writeTaskTags(stdout, current);
         printf("\n");
     }
     
@@ -1054,9 +1220,12 @@ void add_tag_to_task(tasklist* list, const char* taskname) {
     if (tag_count > 0) {
         printf("1. Choose from existing tags\n");
         printf("2. Create a new tag\n");
-        printf("Enter your choice (1-2): ");
+        if (cold->tag_count > 0) {
+            printf("3. Replace a tag on this task\n");
+        }
+        printf("Enter your choice (1-%d): ", cold->tag_count > 0 ? 3 : 2);
         
-        int choice;
+        int choice = 0;
         char buffer[10];
         fgets(buffer, sizeof(buffer), stdin);
         sscanf(buffer, "%d", &choice);
@@ -1065,58 +1234,54 @@ void add_tag_to_task(tasklist* list, const char* taskname) {
             // Show existing tags
             printf("\n=== Available Tags ===\n");
             for (int i = 0; i < tag_count; i++) {
-                printf("%d. %s\n", i + 1, unique_tags[i]);
+                printf("%d. %s\n", i + 1, tagName(unique_tags[i]));
             }
             
             printf("Select a tag (1-%d): ", tag_count);
-            int tag_selection;
+            int tag_selection = 0;
             fgets(buffer, sizeof(buffer), stdin);
             sscanf(buffer, "%d", &tag_selection);
             
             if (tag_selection < 1 || tag_selection > tag_count) {
                 printf("Invalid selection. No tag added.\n");
-                return;
-            }
-            
-            // Check if the selected tag already exists on this task
-            char* selected_tag = unique_tags[tag_selection - 1];
-            for (int i = 0; i < current->tag_count; i++) {
-                if (strcmp(current->tags[i], selected_tag) == 0) {
-                    printf("This task already has the tag '%s'.\n", selected_tag);
-                    return;
-                }
+            } else {
+                attachTag(list, current, tagName(unique_tags[tag_selection - 1]), taskname);
             }
-            
-            // Add the selected tag to the task
-            strcpy(current->tags[current->tag_count], selected_tag);
-            current->tag_count++;
-            printf("Tag '%s' added to task '%s'.\n", selected_tag, taskname);
         }
         else if (choice == 2) {
             // Create new tag
-            printf("Enter new tag (max %d chars): ", MAX_TAG_LENGTH - 1);
-            char new_tag[MAX_TAG_LENGTH];
-            fgets(new_tag, sizeof(new_tag), stdin);
-            new_tag[strcspn(new_tag, "\n")] = 0;
-            
-            // Validate tag name
-            if (strlen(new_tag) == 0) {
-                printf("Tag name cannot be empty.\n");
-                return;
+            char* new_tag = readNewTag();
+            if (new_tag) {
+                attachTag(list, current, new_tag, taskname);
+                free(new_tag);
+            }
+        }
+        else if (choice == 3 && cold->tag_count > 0) {
+            // Show tags with numbers
+            printf("Select a tag to replace (1-%d):\n", cold->tag_count);
+            for (int i = 0; i < cold->tag_count; i++) {
+                printf("%d. %s\n", i + 1, taskTagName(current, i));
             }
             
-            // Check if this tag already exists on this task
-            for (int i = 0; i < current->tag_count; i++) {
-                if (strcmp(current->tags[i], new_tag) == 0) {
+            int tag_index = 0;
+            fgets(buffer, sizeof(buffer), stdin);
+            sscanf(buffer, "%d", &tag_index);
+            
+            if (tag_index < 1 || tag_index > cold->tag_count) {
+                printf("Invalid selection. No tags were changed.\n");
+            } else {
+                char* new_tag = readNewTag();
+                unsigned int id = new_tag ? tagIntern(new_tag) : TAG_NO_ID;
+                if (id == TAG_NO_ID) {
+                    printf("No tags were changed.\n");
+                } else if (taskHasTag(current, id)) {
                     printf("This task already has the tag '%s'.\n", new_tag);
-                    return;
+                } else {
+                    listReplaceTag(list, current, tag_index - 1, id);
+                    printf("Tag replaced successfully.\n");
                 }
+                free(new_tag);
             }
-            
-            // Add tag to task
-            strcpy(current->tags[current->tag_count], new_tag);
-            current->tag_count++;
-            printf("Tag '%s' added to task '%s'.\n", new_tag, taskname);
         }
         else {
             printf("Invalid choice. No tag added.\n");
@@ -1125,144 +1290,177 @@ void add_tag_to_task(tasklist* list, const char* taskname) {
     else {
         // No existing tags, prompt for new tag
         printf("No existing tags found in the system.\n");
-        printf("Enter new tag (max %d chars): ", MAX_TAG_LENGTH - 1);
-        char new_tag[MAX_TAG_LENGTH];
-        fgets(new_tag, sizeof(new_tag), stdin);
-        new_tag[strcspn(new_tag, "\n")] = 0;
-        
-        // Validate tag name
-        if (strlen(new_tag) == 0) {
-            printf("Tag name cannot be empty.\n");
-            return;
+        char* new_tag = readNewTag();
+        if (new_tag) {
+            attachTag(list, current, new_tag, taskname);
+            free(new_tag);
         }
-        
-        // Add tag to task
-        strcpy(current->tags[current->tag_count], new_tag);
-        current->tag_count++;
-        printf("Tag '%s' added to task '%s'.\n", new_tag, taskname);
     }
+    free(unique_tags);
 }
 
 /*
-view_by_tag() - Shows all tasks with specific tag
- - Time: O(n), Space: O(1)
- - Example: view_by_tag(&tasks, "urgent") -> lists all tasks tagged "urgent"
+printTaggedTask() - Prints one task of a tag view
+ - Time: O(tags on the task), Space: O(1)
  */
-void view_by_tag(tasklist* list, const char* tag) {
-    task* current = list->head;
-    int found = 0;
+static void printTaggedTask(task* current) {
+    printf("Name: %s\n", taskName(current));
+    printf("Description: %s\n", taskDescription(current));
+    printf("Priority: %d\n", current->priority);
+    
+    // Show correct status based on updated information
+    if (current->completed) {
+        printf("Status: Completed\n");
+    } else if (current->status == OVERDUE) {
+        printf("Status: Overdue\n");
+    } else {
+        printf("Status: Pending\n");
+    }
     
-    // Get today's date and update task statuses
-    date today = getToday();
-    updateTaskStatuses(list->head, today);
+    if (current->due_date_set) {
+        printf("Due Date: %02d/%02d/%04d\n", 
+               taskDueDate(current).day, taskDueDate(current).month, taskDueDate(current).year);
+    } else {
+        printf("Due Date: Not Set\n");
+    }
     
-    printf("\n=== Tasks with Tag '%s' ===\n", tag);
+    // Print all tags
+    printf("Tags: ");
+    writeTaskTags(stdout, current);
+    printf("\n-------------------------\n");
+}
+
+/*
+view_by_tags() - Shows tasks carrying all (match_all) or any of several tags
+ - Matches come from the tag index, so only matching tasks are visited
+ - Time: O(matches) for one tag, see tagIndexQuery() for several; Space: O(matches)
+ - Example: view_by_tags(&tasks, ids, 2, 1, today) -> tasks tagged with both tags
+ */
+void view_by_tags(tasklist* list, const unsigned int* tag_ids, int n, int match_all, date today) {
+    // Statuses follow the session date, which a simulated day change moves
+    updateTaskStatuses(list, today);
     
-    while (current) {
-        // Check if task has the specified tag
-        for (int i = 0; i < current->tag_count; i++) {
-            if (strcmp(current->tags[i], tag) == 0) {
-                // Print task details
-                printf("Name: %s\n", current->name);
-                printf("Description: %s\n", current->description);
-                printf("Priority: %d\n", current->priority);
-                
-                // Show correct status based on updated information
-                if (current->completed) {
-                    printf("Status: Completed\n");
-                } else if (current->status == OVERDUE) {
-                    printf("Status: Overdue\n");
-                } else {
-                    printf("Status: Pending\n");
-                }
-                
-                if (current->due_date_set) {
-                    printf("Due Date: %02d/%02d/%04d\n", 
-                           current->duedate.day, current->duedate.month, current->duedate.year);
-                } else {
-                    printf("Due Date: Not Set\n");
-                }
-                
-                // Print all tags
-                printf("Tags: ");
-                for (int j = 0; j < current->tag_count; j++) {
-                    printf("%s%s", current->tags[j], (j < current->tag_count - 1) ? ", " : "");
-                }
-                printf("\n-------------------------\n");
-                
-                found = 1;
-                break;  // Found the tag, no need to check other tags for this task
-            }
+    if (n == 1) {
+        printf("\n=== Tasks with Tag '%s' ===\n", tagName(tag_ids[0]));
+    } else {
+        printf("\n=== Tasks with %s Tags ", match_all ? "All of the" : "Any of the");
+        for (int i = 0; i < n; i++) {
+            printf("'%s'%s", tagName(tag_ids[i]), (i < n - 1) ? ", " : "");
         }
-        
-        current = current->next;
+        printf(" ===\n");
     }
     
+    task** matches;
+    int found = tagIndexQuery(&list->tags, tag_ids, n, match_all, &matches);
+    for (int i = 0; i < found; i++) {
+        printTaggedTask(matches[i]);
+    }
+    free(matches);
+    
     if (!found) {
-        printf("No tasks found with tag '%s'.\n", tag);
+        if (n == 1) {
+            printf("No tasks found with tag '%s'.\n", tagName(tag_ids[0]));
+        } else {
+            printf("No tasks found with these tags.\n");
+        }
     }
 }
 
 /*
-sort_by_tag() - Lists all tags and shows tasks for selected tag
- - Time: O(n²), Space: O(n)
- - Example: sort_by_tag(&tasks) -> shows tag menu, then tasks for chosen tag
+view_by_tag() - Shows all tasks with specific tag
+ - Time: O(matches), Space: O(matches)
+ - Example: view_by_tag(&tasks, "urgent", today) -> lists all tasks tagged "urgent"
  */
-void sort_by_tag(tasklist* list) {
-    // First, get all unique tags from all tasks
-    char unique_tags[100][MAX_TAG_LENGTH];  // Assume max 100 unique tags
-    int tag_count = 0;
-    
-    task* current = list->head;
-    while (current) {
-        for (int i = 0; i < current->tag_count; i++) {
-            // Check if this tag is already in our unique_tags array
-            int is_unique = 1;
-            for (int j = 0; j < tag_count; j++) {
-                if (strcmp(current->tags[i], unique_tags[j]) == 0) {
-                    is_unique = 0;
-                    break;
-                }
-            }
-            
-            // If it's a new tag, add it to our array
-            if (is_unique) {
-                strcpy(unique_tags[tag_count], current->tags[i]);
-                tag_count++;
-            }
-        }
-        current = current->next;
+void view_by_tag(tasklist* list, const char* tag, date today) {
+    unsigned int tag_id = tagLookup(tag);
+    if (tag_id == TAG_NO_ID) {
+        printf("\n=== Tasks with Tag '%s' ===\n", tag);
+        printf("No tasks found with tag '%s'.\n", tag);
+        return;
     }
-    
+    view_by_tags(list, &tag_id, 1, 1, today);
+}
+
+/*
+sort_by_tag() - Lists all tags with their task counts and shows tasks for the selected tags
+ - Several numbers select several tags, combined with AND or OR
+ - Time: O(dictionary size + matches), Space: O(dictionary size)
+ - Sample Case:
+    Input: "1 2", then 1 (all)
+    Output: tasks tagged with both the first and the second tag
+ */
+void sort_by_tag(tasklist* list, date today) {
+    // First, get all tags in use, with counts straight from the tag index
+    unsigned int* unique_tags;
+    int tag_count = collectListTags(list, &unique_tags);
     
     if (tag_count == 0) {
         printf("No tags found in any tasks.\n");
+        free(unique_tags);
         return;
     }
     
     printf("\n=== Available Tags ===\n");
     for (int i = 0; i < tag_count; i++) {
-        printf("%d. %s\n", i + 1, unique_tags[i]);
+        int count = tagIndexCount(&list->tags, unique_tags[i]);
+        printf("%d. %s (%d task%s)\n", i + 1, tagName(unique_tags[i]), count, count == 1 ? "" : "s");
+    }
+    
+    printf("Select a tag to view (1-%d), or several separated by spaces: ", tag_count);
+    char* line = readLine(stdin);
+    
+    // Parse the selected numbers into tag ids
+    unsigned int* chosen = (unsigned int*)malloc(tag_count * sizeof(unsigned int));
+    int selected = 0;
+    int valid = line != NULL && chosen != NULL;
+    char* cursor = line;
+    while (valid && selected < tag_count) {
+        char* end;
+        long selection = strtol(cursor, &end, 10);
+        if (end == cursor) {
+            break;
+        }
+        if (selection < 1 || selection > tag_count) {
+            valid = 0;
+            break;
+        }
+        chosen[selected++] = unique_tags[selection - 1];
+        cursor = end;
     }
+    free(line);
+    free(unique_tags);
     
-    printf("Select a tag to view (1-%d): ", tag_count);
-    char buffer[10];
-    fgets(buffer, sizeof(buffer), stdin);
-    int selection;
-    sscanf(buffer, "%d", &selection);
-    
-    if (selection < 1 || selection > tag_count) {
+    if (!valid || selected == 0) {
         printf("Invalid selection.\n");
+        free(chosen);
         return;
     }
     
+    int match_all = 1;
+    if (selected > 1) {
+        printf("Show tasks with 1) all of these tags or 2) any of them? (1-2): ");
+        char buffer[10];
+        int mode = 0;
+        if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
+            sscanf(buffer, "%d", &mode);
+        }
+        if (mode != 1 && mode != 2) {
+            printf("Invalid selection.\n");
+            free(chosen);
+            return;
+        }
+        match_all = (mode == 1);
+    }
+    
   
-    view_by_tag(list, unique_tags[selection - 1]);
+    view_by_tags(list, chosen, selected, match_all, today);
+    free(chosen);
 }
 
 /*
 simplified_view() - Shows compact task list with status summary
- - Time: O(n²), Space: O(n)
+ - Rows come from the view order index, so nothing is sorted here
+ - Time: O(n), Space: O(log n)
  - Sample Case:
     Input: List with various tasks
     Output:
@@ -1285,7 +1483,7 @@ void simplified_view(tasklist* list, date today) {
     }
     
     //  update statuses based on current date
-    updateTaskStatuses(current, today);
+    updateTaskStatuses(list, today);
     
     // Count tasks in each category
     int overdue = 0, urgent = 0, pending = 0, today_count = 0;
@@ -1295,17 +1493,14 @@ void simplified_view(tasklist* list, date today) {
         if (!current->completed) {
             if (current->status == OVERDUE) {
                 overdue++;
-            } else if (current->due_date_set && isDateSoon(today, current->duedate, 2)) {
+            } else if (current->due_date_set && isDueSoon(current, today, 2)) {
                 urgent++;
             } else {
                 pending++;
             }
             
             // Count tasks due today
-            if (current->due_date_set && 
-                current->duedate.day == today.day &&
-                current->duedate.month == today.month &&
-                current->duedate.year == today.year) {
+            if (current->due_date_set && current->due == (unsigned int)dateToDays(today)) {
                 today_count++;
             }
         }
@@ -1316,64 +1511,22 @@ void simplified_view(tasklist* list, date today) {
     printf("Overdue: %d | Urgent: %d | Due Today: %d | Pending: %d\n\n", 
            overdue, urgent, today_count, pending);
     
-    // Create arrays for tasks by priority
-    task* priority_tasks[3][100]; 
-    int priority_counts[3] = {0};
-    
-    // Collect tasks by priority
-    current = list->head;
-    while (current) {
-        if (!current->completed) {
-            int priority_idx = current->priority - 1;
-            if (priority_idx >= 0 && priority_idx < 3) {
-                priority_tasks[priority_idx][priority_counts[priority_idx]++] = current;
-            }
-        }
-        current = current->next;
-    }
-    
-    // Sort tasks within each priority by due date
-    for (int p = 0; p < 3; p++) {
-        // Sort by due date (bubble sort)
-        for (int i = 0; i < priority_counts[p] - 1; i++) {
-            for (int j = 0; j < priority_counts[p] - i - 1; j++) {
-                // If first task has no due date or second has earlier due date
-                if (!priority_tasks[p][j]->due_date_set && priority_tasks[p][j+1]->due_date_set) {
-                    // Swap (tasks without due dates go to the end)
-                    task* temp = priority_tasks[p][j];
-                    priority_tasks[p][j] = priority_tasks[p][j+1];
-                    priority_tasks[p][j+1] = temp;
-                }
-                // Both have due date, compare them
-                else if (priority_tasks[p][j]->due_date_set && priority_tasks[p][j+1]->due_date_set) {
-                    if (compareDates(priority_tasks[p][j]->duedate, priority_tasks[p][j+1]->duedate) > 0) {
-                        // Swap
-                        task* temp = priority_tasks[p][j];
-                        priority_tasks[p][j] = priority_tasks[p][j+1];
-                        priority_tasks[p][j+1] = temp;
-                    }
-                }
-            }
-        }
-    }
-    
- 
     printf("%-5s %-25s %-10s %-15s %-10s\n", "#", "Name", "Priority", "Due Date", "Status");
     printf("--------------------------------------------------------------------\n");
     
 
     int count = 1;
     
-
+    // Overdue tasks first, in list order
     current = list->head;
     while (current) {
         if (!current->completed && current->status == OVERDUE) {
             char date_str[15] = "Not Set";
             if (current->due_date_set) {
                 sprintf(date_str, "%02d/%02d/%04d", 
-                        current->duedate.day, 
-                        current->duedate.month, 
-                        current->duedate.year);
+                        taskDueDate(current).day, 
+                        taskDueDate(current).month, 
+                        taskDueDate(current).year);
             }
             
             char priority_str[10];
@@ -1386,7 +1539,7 @@ void simplified_view(tasklist* list, date today) {
             
             
             char name_with_markers[30] = "";
-            strncpy(name_with_markers, current->name, 25);
+            strncpy(name_with_markers, taskName(current), 25);
             strcat(name_with_markers, "!");
             
             printf("%-5d %-25s %-10s %-15s %-10s\n", 
@@ -1395,41 +1548,39 @@ void simplified_view(tasklist* list, date today) {
         current = current->next;
     }
     
-   
-    for (int p = 0; p < 3; p++) {
-        for (int i = 0; i < priority_counts[p]; i++) {
-            task* t = priority_tasks[p][i];
-            
-            // Skip overdue tasks (already printed)
-            if (t->status == OVERDUE) continue;
-            
-            char date_str[15] = "Not Set";
-            if (t->due_date_set) {
-                sprintf(date_str, "%02d/%02d/%04d", 
-                        t->duedate.day, 
-                        t->duedate.month, 
-                        t->duedate.year);
-            }
-            
-            char priority_str[10];
-            switch(t->priority) {
-                case 1: strcpy(priority_str, "High"); break;
-                case 2: strcpy(priority_str, "Medium"); break;
-                case 3: strcpy(priority_str, "Low"); break;
-                default: strcpy(priority_str, "Unknown");
-            }
-            
-           
-            char name_with_markers[30] = "";
-            strncpy(name_with_markers, t->name, 25);
-            
-            if (t->due_date_set && isDateSoon(today, t->duedate, 2)) {
-                strcat(name_with_markers, "*");
-            }
-            
-            printf("%-5d %-25s %-10s %-15s %-10s\n", 
-                   count++, name_with_markers, priority_str, date_str, "Pending");
+    // Then high/medium/low priority, each by due date, straight from the view order index
+    orderiter it;
+    orderIterBegin(&it, &list->order);
+    for (task* t = orderIterNext(&it); t; t = orderIterNext(&it)) {
+        int group = orderGroup(t);
+        if (group == ORDER_GROUP_OVERDUE || group == ORDER_GROUP_OTHER) continue;
+        
+        char date_str[15] = "Not Set";
+        if (t->due_date_set) {
+            sprintf(date_str, "%02d/%02d/%04d", 
+                    taskDueDate(t).day, 
+                    taskDueDate(t).month, 
+                    taskDueDate(t).year);
+        }
+        
+        char priority_str[10];
+        switch(t->priority) {
+            case 1: strcpy(priority_str, "High"); break;
+            case 2: strcpy(priority_str, "Medium"); break;
+            case 3: strcpy(priority_str, "Low"); break;
+            default: strcpy(priority_str, "Unknown");
         }
+        
+       
+        char name_with_markers[30] = "";
+        strncpy(name_with_markers, taskName(t), 25);
+        
+        if (t->due_date_set && isDueSoon(t, today, 2)) {
+            strcat(name_with_markers, "*");
+        }
+        
+        printf("%-5d %-25s %-10s %-15s %-10s\n", 
+               count++, name_with_markers, priority_str, date_str, "Pending");
     }
     
     printf("\nLegend: ! = Overdue, * = Urgent (due within 2 days)\n");
@@ -1438,7 +1589,8 @@ void simplified_view(tasklist* list, date today) {
 
 /*
 view_weekly_summary() - Shows tasks due in next 7 days
- - Time: O(n²), Space: O(n)
+ - Tasks are bucketed by day in list order (counted first, so any number fit)
+ - Time: O(n), Space: O(tasks due this week)
  - Sample Case:
     Input: Current date: 02/05/2025
     Output:
@@ -1462,33 +1614,51 @@ void view_weekly_summary(tasklist* list, date today) {
     printf("%-5s %-25s %-10s %-15s %-10s\n", "#", "Name", "Priority", "Due Date", "Days Left");
     printf("---------------------------------------------------------------\n");
     
-    // Create arrays to store tasks for each day of the week
-    task* days_tasks[8][50];
+    // First pass: count the tasks due on each day
     int days_tasks_count[8] = {0}; 
+    for (task* t = current; t; t = t->next) {
+        if (!t->completed && t->due_date_set) {
+            int daysDiff = daysUntilDue(t, today);
+            if (daysDiff >= 0 && daysDiff <= 7) {
+                days_tasks_count[daysDiff]++;
+            }
+        }
+    }
+    int days_start[9] = {0};
+    for (int day = 0; day <= 7; day++) {
+        days_start[day + 1] = days_start[day] + days_tasks_count[day];
+    }
+    task** days_tasks = (task**)malloc((days_start[8] ? days_start[8] : 1) * sizeof(task*));
+    if (!days_tasks) {
+        printf("Memory allocation failed.\n");
+        return;
+    }
     
-    // First pass: collect tasks in arrays by day
+    // Second pass: place each task in its day's bucket
+    int days_fill[8];
+    memcpy(days_fill, days_start, sizeof(days_fill));
     while (current) {
         if (!current->completed && current->due_date_set) {
-            int daysDiff = getDaysBetween(today, current->duedate);
+            int daysDiff = daysUntilDue(current, today);
             if (daysDiff >= 0 && daysDiff <= 7) {
-                days_tasks[daysDiff][days_tasks_count[daysDiff]++] = current;
+                days_tasks[days_fill[daysDiff]++] = current;
             }
         }
         current = current->next;
     }
     
-    // Second pass: print details of each task, sorted by day
+    // Print details of each task, sorted by day
     int task_num = 1;
     
     for (int day = 0; day <= 7; day++) {
-        for (int i = 0; i < days_tasks_count[day]; i++) {
-            task* t = days_tasks[day][i];
+        for (int i = days_start[day]; i < days_start[day + 1]; i++) {
+            task* t = days_tasks[i];
             
             char date_str[15];
             sprintf(date_str, "%02d/%02d/%04d", 
-                    t->duedate.day, 
-                    t->duedate.month, 
-                    t->duedate.year);
+                    taskDueDate(t).day, 
+                    taskDueDate(t).month, 
+                    taskDueDate(t).year);
             
             char priority_str[10];
             switch(t->priority) {
@@ -1508,10 +1678,11 @@ void view_weekly_summary(tasklist* list, date today) {
             }
             
             printf("%-5d %-25s %-10s %-15s %-10s\n", 
-                   task_num++, t->name, priority_str, date_str, days_left);
+                   task_num++, taskName(t), priority_str, date_str, days_left);
             count++;
         }
     }
+    free(days_tasks);
     
     if (count == 0) {
         printf("No tasks due this week.\n");
@@ -1592,7 +1763,7 @@ void view_combined(tasklist* list, date today) {
             simplified_view(list, today);
             break;
         case 3:
-            sort_by_tag(list);  
+            sort_by_tag(list, today);  
             break;
         default:
             printf("Invalid option. Using standard view.\n");
@@ -1600,9 +1771,49 @@ void view_combined(tasklist* list, date today) {
     }
 }
 
+// Week of this month a pending task falls due in (0-4 from today), or -1
+static int monthlyWeek(task* t, date today) {
+    if (t->completed || !t->due_date_set) {
+        return -1;
+    }
+    // Check if the task is due this month
+    if (taskDueDate(t).month != today.month || taskDueDate(t).year != today.year) {
+        return -1;
+    }
+    int daysDiff = daysUntilDue(t, today);
+    return daysDiff >= 0 && daysDiff / 7 < 5 ? daysDiff / 7 : -1;
+}
+
+
+// A task of view_monthly_summary(): its week and its place in the list
+typedef struct {
+    task* t;
+    int week;
+    int position;
+} weektask;
+
+
+// Week first, then priority (1 is highest), due date and list order
+static int compareWeekTasks(const void* a, const void* b) {
+    const weektask* x = (const weektask*)a;
+    const weektask* y = (const weektask*)b;
+    if (x->week != y->week) {
+        return x->week - y->week;
+    }
+    if (x->t->priority != y->t->priority) {
+        return x->t->priority - y->t->priority;
+    }
+    if (x->t->due != y->t->due) {
+        return x->t->due < y->t->due ? -1 : 1;
+    }
+    return x->position - y->position;
+}
+
+
 /*
 view_monthly_summary() - Shows tasks due this month
- - Time: O(n²), Space: O(n)
+ - Tasks are sorted by week, then priority and due date, with no cap per week
+ - Time: O(n + m log m) for m tasks due this month, Space: O(m)
  - Example: view_monthly_summary(&tasks, today) -> lists tasks for current month
  */
 void view_monthly_summary(tasklist* list, date today) {
@@ -1634,85 +1845,69 @@ void view_monthly_summary(tasklist* list, date today) {
     
     // Count tasks by week
     int week_count[5] = {0}; // 5 weeks in a month 
-    task* week_tasks[5][50]; // Up to 50 tasks per week
-    int week_tasks_count[5] = {0};
+    int week_total = 0;
+    
+    // First pass: count tasks by week
+    for (task* t = current; t; t = t->next) {
+        int week = monthlyWeek(t, today);
+        if (week >= 0) {
+            week_count[week]++;
+            week_total++;
+        }
+    }
+    weektask* week_tasks = (weektask*)malloc((week_total ? week_total : 1) * sizeof(weektask));
+    if (!week_tasks) {
+        printf("Memory allocation failed.\n");
+        return;
+    }
     
-    // First pass: collect and count tasks by week
+    // Second pass: collect them, then sort by week, priority and due date
+    int collected = 0;
     while (current) {
-        if (!current->completed && current->due_date_set) {
-            // Check if the task is due this month
-            if (current->duedate.month == today.month && current->duedate.year == today.year) {
-                int daysDiff = getDaysBetween(today, current->duedate);
-                if (daysDiff >= 0) {
-                    int week = daysDiff / 7;
-                    if (week < 5) {
-                        week_tasks[week][week_tasks_count[week]++] = current;
-                        week_count[week]++;
-                    }
-                }
-            }
+        int week = monthlyWeek(current, today);
+        if (week >= 0) {
+            week_tasks[collected].t = current;
+            week_tasks[collected].week = week;
+            week_tasks[collected].position = collected;
+            collected++;
         }
         current = current->next;
     }
+    qsort(week_tasks, collected, sizeof(weektask), compareWeekTasks);
     
-    // Second pass: print task details sorted by week
     int task_num = 1;
-    
-    for (int week = 0; week < 5; week++) {
-        // Sort tasks within each week by priority, then by due date
-        for (int i = 0; i < week_tasks_count[week] - 1; i++) {
-            for (int j = 0; j < week_tasks_count[week] - i - 1; j++) {
-                // Primary sort by priority (1 is highest)
-                if (week_tasks[week][j]->priority > week_tasks[week][j+1]->priority) {
-                    // Swap
-                    task* temp = week_tasks[week][j];
-                    week_tasks[week][j] = week_tasks[week][j+1];
-                    week_tasks[week][j+1] = temp;
-                }
-                // Secondary sort by due date (if same priority)
-                else if (week_tasks[week][j]->priority == week_tasks[week][j+1]->priority &&
-                        compareDates(week_tasks[week][j]->duedate, week_tasks[week][j+1]->duedate) > 0) {
-                    // Swap
-                    task* temp = week_tasks[week][j];
-                    week_tasks[week][j] = week_tasks[week][j+1];
-                    week_tasks[week][j+1] = temp;
-                }
-            }
+    for (int i = 0; i < collected; i++) {
+        task* t = week_tasks[i].t;
+        
+        char date_str[15];
+        sprintf(date_str, "%02d/%02d/%04d", 
+                taskDueDate(t).day, 
+                taskDueDate(t).month, 
+                taskDueDate(t).year);
+        
+        char priority_str[10];
+        switch(t->priority) {
+            case 1: strcpy(priority_str, "High"); break;
+            case 2: strcpy(priority_str, "Medium"); break;
+            case 3: strcpy(priority_str, "Low"); break;
+            default: strcpy(priority_str, "Unknown");
         }
         
-     
-        for (int i = 0; i < week_tasks_count[week]; i++) {
-            task* t = week_tasks[week][i];
-            
-            char date_str[15];
-            sprintf(date_str, "%02d/%02d/%04d", 
-                    t->duedate.day, 
-                    t->duedate.month, 
-                    t->duedate.year);
-            
-            char priority_str[10];
-            switch(t->priority) {
-                case 1: strcpy(priority_str, "High"); break;
-                case 2: strcpy(priority_str, "Medium"); break;
-                case 3: strcpy(priority_str, "Low"); break;
-                default: strcpy(priority_str, "Unknown");
-            }
-            
-            int daysDiff = getDaysBetween(today, t->duedate);
-            char days_left[10];
-            if (daysDiff == 0) {
-                strcpy(days_left, "Today");
-            } else if (daysDiff == 1) {
-                strcpy(days_left, "Tomorrow");
-            } else {
-                sprintf(days_left, "%d days", daysDiff);
-            }
-            
-            printf("%-3d %-25s %-10s %-15s %-10s\n", 
-                   task_num++, t->name, priority_str, date_str, days_left);
-            count++;
+        int daysDiff = daysUntilDue(t, today);
+        char days_left[10];
+        if (daysDiff == 0) {
+            strcpy(days_left, "Today");
+        } else if (daysDiff == 1) {
+            strcpy(days_left, "Tomorrow");
+        } else {
+            sprintf(days_left, "%d days", daysDiff);
         }
+        
+        printf("%-3d %-25s %-10s %-15s %-10s\n", 
+               task_num++, taskName(t), priority_str, date_str, days_left);
+        count++;
     }
+    free(week_tasks);
     
     if (count == 0) {
         printf("No tasks due this month.\n");
@@ -2,80 +2,90 @@
 #define TASK_MANAGEMENT_H
 
 
+#include <stdio.h>
 #include "scheduler.h" 
-
-// Constants for tags
-#define MAX_TAGS 5
-#define MAX_TAG_LENGTH 20
-
-// Task structure
+#include "nameindex.h"
+#include "slab.h"
+#include "coldstore.h"
+#include "tagdict.h"
+#include "tagindex.h"
+#include "orderindex.h"
+#include "duetracker.h"
+#include "completionlog.h"
+#include "textindex.h"
+
+// Task structure (hot record): only the fields that list scans read.
+// Name, description and tag ids live in the cold store under task->id.
 typedef struct task {
-    char name[100];
-    char description[300];
-    int priority;
-    date duedate;
-    TaskStatus status;
-    int due_date_set;
-    int completed;
-    
-    // Tag fields
-    char tags[MAX_TAGS][MAX_TAG_LENGTH];
-    int tag_count;
-    
     struct task* next;
+    struct task* prev;
+    unsigned long long tag_mask;  // one bit per tag id, see tagBit()
+    unsigned int id;              // index into the cold store
+    unsigned int due;             // due date as a serial day, see dateToDays()
+    unsigned int seq;             // link order, newest highest (view order tie-break);
+                                  // position in the completion log once completed
+    unsigned int heap_slot[2];    // positions in the due tracker heaps, see duetracker.h
+    unsigned char priority;
+    unsigned char status;         // TaskStatus
+    unsigned char due_date_set;
+    unsigned char completed;
 } task;
 
-// List and stack structures
-typedef struct {
+// List structure
+typedef struct tasklist {
     task* head;
+    nameindex names;  // name -> task lookup for the pending list
+    tagindex tags;    // tag -> tasks posting lists for the pending list
+    orderindex order; // standard view order of the pending list
+    duetracker due;   // due-date heaps driving overdue status and priority raises
 } tasklist;
 
-typedef struct stacknode {
-    task* task_data;  // pointer to the task
-    struct stacknode* next;
-} stacknode;
-
+// A pending task and a copy of its hot record, taken by a reader thread
+// (see copyPendingTasks()); the copy's fields cannot change under a sort
 typedef struct {
-    stacknode* top;
-} completedstack;
-
-// Queue structures
-typedef struct queuenode {
-    task* task_data;
-    struct queuenode* next;
-} queuenode;
-
-typedef struct {
-    queuenode* front;
-    queuenode* rear;
-} taskqueue;
-
-// Queue function prototypes
-void initQueue(taskqueue* q);
-void enqueue(taskqueue* q, task* t);
-task* dequeue(taskqueue* q);
-int isQueueEmpty(taskqueue* q);
-void freeQueue(taskqueue* q);
+    task key;
+    task* t;
+} taskcopy;
 
 
-void sortTasksByDueDate(task* tasks[], int count);
+char* readLine(FILE* in);
 void add(tasklist* list);
 int isTaskNameDuplicate(tasklist* list, const char* name);
+task* findTask(tasklist* list, const char* name);
+int linkTask(tasklist* list, task* t);
+task* newTask(void);
+void destroyTask(task* t);
+void unlinkTask(tasklist* list, task* t);
+int copyPendingTasks(tasklist* list, int view_order, taskcopy** out);
+int listAddTag(tasklist* list, task* t, unsigned int tag_id);
+void listReplaceTag(tasklist* list, task* t, int index, unsigned int tag_id);
+int setTaskPriority(tasklist* list, task* t, int priority);
+void setTaskStatus(tasklist* list, task* t, int status);
+int setTaskDue(tasklist* list, task* t, const date* due);
+task* createTask(tasklist* list, const char* name, const char* description, int priority, const date* due);
+int renameTask(tasklist* list, task* t, const char* name);
+int describeTask(task* t, const char* description);
+int completeTask(tasklist* list, completionlog* done, task* t, date today);
+task* undoCompleteTask(tasklist* list, completionlog* done);
+void removeTask(tasklist* list, task* t);
 void view(tasklist* list, date today);
 void edit(tasklist* list, const char* name);
-void complete(tasklist* list, completedstack* stack, const char* name);
-void undoCompleted(tasklist* list, completedstack* stack);
+void complete(tasklist* list, completionlog* done, const char* name, date today);
+void undoCompleted(tasklist* list, completionlog* done);
 void deleteTask(tasklist* list, const char* name);
 void freeTasks(tasklist* list);
-void freeStack(completedstack* stack);
+void freeCompleted(completionlog* done);
+void resetTaskMemory(tasklist* list, completionlog* done);
+void printMemoryStats(void);
 
 
 void simplified_view(tasklist* list, date today);
 void view_weekly_summary(tasklist* list, date today);
 void view_monthly_summary(tasklist* list, date today);
 void add_tag_to_task(tasklist* list, const char* taskname);
-void view_by_tag(tasklist* list, const char* tag);
-void sort_by_tag(tasklist* list);
+void view_by_tag(tasklist* list, const char* tag, date today);
+void view_by_tags(tasklist* list, const unsigned int* tag_ids, int n, int match_all, date today);
+void sort_by_tag(tasklist* list, date today);
 void text_converter(const char* input_text, tasklist* list);
 
 
@@ -0,0 +1,1021 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "taskfile.h"
+#include "scheduler.h"
+#include "writebuffer.h"
+#include "epoch.h"
+#include "taskstore.h"
+
+
+/*
+taskFileFormatForName() - Picks the export format from a file name's extension
+ - Time: O(name length), Space: O(1)
+ - Example: "tasks.jsonl" -> TASKFILE_JSONL, "tasks_export.txt" -> TASKFILE_NONE
+ */
+int taskFileFormatForName(const char* filename) {
+    const char* dot = strrchr(filename, '.');
+    if (!dot) {
+        return TASKFILE_NONE;
+    }
+    if (strcmp(dot, ".csv") == 0 || strcmp(dot, ".CSV") == 0) {
+        return TASKFILE_CSV;
+    }
+    if (strcmp(dot, ".jsonl") == 0 || strcmp(dot, ".JSONL") == 0) {
+        return TASKFILE_JSONL;
+    }
+    return TASKFILE_NONE;
+}
+
+
+/*
+writeCsvField() - Writes one CSV field, quoted only when it has to be
+ - Fields holding ',', '"', '\r' or '\n' are quoted with '"' doubled
+ - Time: O(length), Space: O(1)
+ - Example: say "hi", then go -> "say ""hi"", then go"
+ */
+static void writeCsvField(writebuffer* out, const char* text, size_t length) {
+    size_t i = 0;
+    while (i < length && text[i] != ',' && text[i] != '"' && text[i] != '\r' && text[i] != '\n') {
+        i++;
+    }
+    if (i == length) {
+        writeBufferText(out, text, length);
+        return;
+    }
+    writeBufferChar(out, '"');
+    const char* end = text + length;
+    const char* quote;
+    while ((quote = (const char*)memchr(text, '"', end - text)) != NULL) {
+        writeBufferText(out, text, quote - text + 1);
+        writeBufferChar(out, '"');
+        text = quote + 1;
+    }
+    writeBufferText(out, text, end - text);
+    writeBufferChar(out, '"');
+}
+
+
+/*
+writeJsonString() - Writes text as a quoted JSON string
+ - Escapes '"', '\\' and control characters; other bytes (UTF-8
+   included) are copied in runs
+ - Time: O(length), Space: O(1)
+ */
+static void writeJsonString(writebuffer* out, const char* text, size_t length) {
+    static const char hex[] = "0123456789abcdef";
+    writeBufferChar(out, '"');
+    size_t run = 0;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        writeBufferText(out, text + run, i - run);
+        run = i + 1;
+        writeBufferChar(out, '\\');
+        switch (c) {
+            case '"': writeBufferChar(out, '"'); break;
+            case '\\': writeBufferChar(out, '\\'); break;
+            case '\n': writeBufferChar(out, 'n'); break;
+            case '\r': writeBufferChar(out, 'r'); break;
+            case '\t': writeBufferChar(out, 't'); break;
+            case '\b': writeBufferChar(out, 'b'); break;
+            case '\f': writeBufferChar(out, 'f'); break;
+            default:
+                writeBufferText(out, "u00", 3);
+                writeBufferChar(out, hex[c >> 4]);
+                writeBufferChar(out, hex[c & 15]);
+                break;
+        }
+    }
+    writeBufferText(out, text + run, length - run);
+    writeBufferChar(out, '"');
+}
+
+
+/*
+joinCsvTags() - Joins a task's tags with ';' into *buffer for one CSV field
+ - ';' and '\\' inside a tag are escaped with '\\'
+ - Time: O(total tag length), Space: O(total tag length) in *buffer
+ - Returns the joined length, or -1 if the buffer could not grow
+ - Example: tags "work", "a;b" -> "work;a\;b"
+ */
+static long joinCsvTags(const task* t, char** buffer, size_t* capacity) {
+    size_t used = 0;
+    int count = taskTagCount(t);
+    for (int i = 0; i < count; i++) {
+        const char* tag = taskTagName(t, i);
+        size_t length = strlen(tag);
+        if (used + 2 * length + 1 > *capacity) {
+            size_t new_capacity = *capacity ? *capacity : 64;
+            while (used + 2 * length + 1 > new_capacity) {
+                new_capacity *= 2;
+            }
+            char* grown = (char*)realloc(*buffer, new_capacity);
+            if (!grown) {
+                return -1;
+            }
+            *buffer = grown;
+            *capacity = new_capacity;
+        }
+        if (i > 0) {
+            (*buffer)[used++] = ';';
+        }
+        for (size_t j = 0; j < length; j++) {
+            if (tag[j] == ';' || tag[j] == '\\') {
+                (*buffer)[used++] = '\\';
+            }
+            (*buffer)[used++] = tag[j];
+        }
+    }
+    return (long)used;
+}
+
+
+/*
+writeTaskRecord() - Writes one task as a CSV row or a JSON line
+ - completed_on is the completion day for completed tasks, unused otherwise
+ - t may be a copy taken by a reader thread (see copyPendingTasks())
+ - Time: O(record length), Space: O(total tag length) in the tag buffer
+ - Returns 1 on success, 0 if the tag buffer could not grow
+ */
+static int writeTaskRecord(writebuffer* out, int format, const task* t, const char* status,
+                           unsigned int completed_on, char** tag_buffer, size_t* tag_capacity) {
+    taskcold* cold = taskCold(t);
+    arenastr name = coldText(cold, &cold->name);
+    arenastr description = coldText(cold, &cold->description);
+    int completed = t->status == COMPLETED;
+
+    if (format == TASKFILE_CSV) {
+        long tags_length = joinCsvTags(t, tag_buffer, tag_capacity);
+        if (tags_length < 0) {
+            return 0;
+        }
+        writeCsvField(out, arenaString(name), name.length);
+        writeBufferChar(out, ',');
+        writeCsvField(out, arenaString(description), description.length);
+        writeBufferChar(out, ',');
+        writeBufferInt(out, t->priority);
+        writeBufferChar(out, ',');
+        if (t->due_date_set) {
+            writeBufferDate(out, taskDueDate(t));
+        }
+        writeBufferChar(out, ',');
+        writeBufferString(out, status);
+        writeBufferText(out, completed ? ",1," : ",0,", 3);
+        if (completed) {
+            writeBufferDate(out, daysToDate((int)completed_on));
+        }
+        writeBufferChar(out, ',');
+        writeCsvField(out, *tag_buffer, (size_t)tags_length);
+        writeBufferChar(out, '\n');
+        return 1;
+    }
+
+    writeBufferString(out, "{\"name\":");
+    writeJsonString(out, arenaString(name), name.length);
+    writeBufferString(out, ",\"description\":");
+    writeJsonString(out, arenaString(description), description.length);
+    writeBufferString(out, ",\"priority\":");
+    writeBufferInt(out, t->priority);
+    writeBufferString(out, ",\"due\":");
+    if (t->due_date_set) {
+        writeBufferChar(out, '"');
+        writeBufferDate(out, taskDueDate(t));
+        writeBufferChar(out, '"');
+    } else {
+        writeBufferString(out, "null");
+    }
+    writeBufferString(out, ",\"status\":\"");
+    writeBufferString(out, status);
+    writeBufferString(out, completed ? "\",\"completed\":true,\"completed_on\":\""
+                                     : "\",\"completed\":false,\"completed_on\":null");
+    if (completed) {
+        writeBufferDate(out, daysToDate((int)completed_on));
+        writeBufferChar(out, '"');
+    }
+    writeBufferString(out, ",\"tags\":[");
+    int tag_count = taskTagCount(t);
+    for (int i = 0; i < tag_count; i++) {
+        const char* tag = taskTagName(t, i);
+        if (i > 0) {
+            writeBufferChar(out, ',');
+        }
+        writeJsonString(out, tag, strlen(tag));
+    }
+    writeBufferText(out, "]}\n", 3);
+    return 1;
+}
+
+
+/*
+exportTaskFile() - Exports every task with all of its fields as CSV or JSONL
+ - Pending tasks oldest first (the list tail back to its head), then the
+   completion log oldest first, so importTaskFile() rebuilds both in order
+ - While reader threads run (the server), this may be one of them: the
+   back pointers belong to the writer, so the pending tasks are copied
+   from the head and written in reverse
+ - Time: O(n + total text), Space: O(WRITEBUFFER_CAPACITY) (plus O(n) on a reader)
+ - Returns the number of records written, or -1 if the file could not be written
+ - Sample Case:
+    exportTaskFile(&tasks, &doneLog, "tasks.csv", TASKFILE_CSV)
+    tasks.csv:
+      name,description,priority,due,status,completed,completed_on,tags
+      Buy Groceries,"Milk, eggs",3,10/05/2025,pending,0,,home;errands
+      Study,Chapters 1-5,1,,completed,1,18/10/2026,
+ */
+int exportTaskFile(tasklist* list, completionlog* done, const char* filename, int format) {
+    writebuffer out;
+    if (!writeBufferOpen(&out, filename)) {
+        perror("Failed to open file for export");
+        return -1;
+    }
+
+    char* tag_buffer = NULL;
+    size_t tag_capacity = 0;
+    int pending = 0, overdue = 0, completed = 0, ok = 1;
+
+    if (format == TASKFILE_CSV) {
+        writeBufferText(&out, TASKFILE_CSV_HEADER "\n", sizeof(TASKFILE_CSV_HEADER));
+    }
+
+    taskcopy* copies = NULL;
+    int copy_count = 0;
+    if (epochShared()) {
+        copy_count = copyPendingTasks(list, 0, &copies);
+        ok = copy_count >= 0;
+    } else {
+        task* tail = list->head;
+        while (tail && tail->next) {
+            tail = tail->next;
+        }
+        for (task* t = tail; t && ok; t = t->prev) {
+            int is_overdue = t->status == OVERDUE;
+            ok = writeTaskRecord(&out, format, t, is_overdue ? "overdue" : "pending", 0,
+                                 &tag_buffer, &tag_capacity);
+            if (is_overdue) {
+                overdue++;
+            } else {
+                pending++;
+            }
+        }
+    }
+    for (int i = copy_count - 1; i >= 0 && ok; i--) {
+        int is_overdue = copies[i].key.status == OVERDUE;
+        ok = writeTaskRecord(&out, format, &copies[i].key, is_overdue ? "overdue" : "pending", 0,
+                             &tag_buffer, &tag_capacity);
+        if (is_overdue) {
+            overdue++;
+        } else {
+            pending++;
+        }
+    }
+    free(copies);
+
+    // The count is published after its entry, so load it before the entries
+    int completed_count = EPOCH_LOAD(done->count);
+    completion* entries = EPOCH_LOAD(done->entries);
+    for (int i = 0; i < completed_count && ok; i++) {
+        ok = writeTaskRecord(&out, format, entries[i].task_data, "completed", entries[i].day,
+                             &tag_buffer, &tag_capacity);
+        completed++;
+    }
+    free(tag_buffer);
+
+    if (!writeBufferClose(&out)) {
+        perror("Error writing export file");
+        return -1;
+    }
+    if (!ok) {
+        printf("Memory allocation failed during export. File is incomplete.\n");
+        return -1;
+    }
+    printf("Tasks exported to %s\n", filename);
+    printf("Total %d tasks exported (%d pending, %d overdue, %d completed)\n",
+           pending + overdue + completed, pending, overdue, completed);
+    return pending + overdue + completed;
+}
+
+
+/*
+reserveScratch() - Makes room for text_bytes of unescaped text and tag_count tags
+ - Time: O(text_bytes) when growing, Space: O(text_bytes + tag_count)
+ - Returns 1 on success, 0 if memory allocation failed
+ */
+static int reserveScratch(recordscratch* s, size_t text_bytes, int tag_count) {
+    if (text_bytes > s->text_capacity) {
+        size_t new_capacity = s->text_capacity ? s->text_capacity : 256;
+        while (new_capacity < text_bytes) {
+            new_capacity *= 2;
+        }
+        char* text = (char*)malloc(new_capacity);
+        if (!text) {
+            return 0;
+        }
+        free(s->text);
+        s->text = text;
+        s->text_capacity = new_capacity;
+    }
+    if (tag_count > s->tag_capacity) {
+        int new_capacity = s->tag_capacity ? s->tag_capacity : 8;
+        while (new_capacity < tag_count) {
+            new_capacity *= 2;
+        }
+        const char** tags = (const char**)realloc(s->tags, new_capacity * sizeof(const char*));
+        if (!tags) {
+            return 0;
+        }
+        s->tags = tags;
+        s->tag_capacity = new_capacity;
+    }
+    return 1;
+}
+
+
+/*
+parseRecordDate() - Parses a dd/mm/yyyy field
+ - Time: O(length), Space: O(1)
+ - Returns 1 on success, 0 if the text is not a date
+ */
+static int parseRecordDate(const char* text, date* out) {
+    int length = 0;
+    if (sscanf(text, "%d/%d/%d%n", &out->day, &out->month, &out->year, &length) != 3) {
+        return 0;
+    }
+    return text[length] == '\0';
+}
+
+
+/*
+parseRecordInt() - Parses an optionally negative decimal field with nothing after it
+ - Time: O(length), Space: O(1)
+ */
+static int parseRecordInt(const char* text, int* out) {
+    char* end;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < -1000000 || value > 1000000) {
+        return 0;
+    }
+    *out = (int)value;
+    return 1;
+}
+
+
+/*
+csvRecordEnd() - Finds where the CSV record starting at p ends
+ - A newline inside a quoted field belongs to the record; quotes are
+   counted line by line with memchr()
+ - Time: O(record length), Space: O(1)
+ - Returns the byte after the record's newline (or end)
+ */
+static const char* csvRecordEnd(const char* p, const char* end) {
+    int quoted = 0;
+    while (p < end) {
+        const char* newline = (const char*)memchr(p, '\n', end - p);
+        const char* stop = newline ? newline : end;
+        for (const char* c = p; c < stop; c++) {
+            c = (const char*)memchr(c, '"', stop - c);
+            if (!c) {
+                break;
+            }
+            quoted ^= 1;
+        }
+        if (!quoted || !newline) {
+            return newline ? newline + 1 : end;
+        }
+        p = newline + 1;
+    }
+    return end;
+}
+
+
+/*
+splitCsvTags() - Splits a ';'-joined tag field in place, undoing '\\' escapes
+ - Time: O(length), Space: O(1) besides the scratch tag array
+ - Returns the number of tags, or -1 if memory allocation failed
+ - Example: "work;a\;b" -> ["work", "a;b"]
+ */
+static int splitCsvTags(char* text, recordscratch* s) {
+    int count = 0;
+    char* write = text;
+    char* start = text;
+    for (char* read = text; ; read++) {
+        if (*read == '\\' && read[1] != '\0') {
+            *write++ = *++read;
+            continue;
+        }
+        if (*read != ';' && *read != '\0') {
+            *write++ = *read;
+            continue;
+        }
+        int last = *read == '\0';
+        *write = '\0';
+        if (write > start) {
+            if (!reserveScratch(s, 0, count + 1)) {
+                return -1;
+            }
+            s->tags[count++] = start;
+        }
+        if (last) {
+            break;
+        }
+        start = ++write;
+    }
+    return count;
+}
+
+
+/*
+parseCsvTask() - Parses one CSV record into rec
+ - Quoted fields are unescaped into the scratch buffer
+ - Time: O(record length), Space: O(record length) in the scratch buffer
+ - Returns 1 on success, 0 for a blank line, -1 if the record is malformed,
+   -2 if memory allocation failed
+ */
+static int parseCsvTask(const char* p, const char* end, recordscratch* s, taskrecord* rec) {
+    while (end > p && (end[-1] == '\n' || end[-1] == '\r')) {
+        end--;
+    }
+    if (p == end) {
+        return 0;
+    }
+    if (!reserveScratch(s, (size_t)(end - p) + 16, 0)) {
+        return -2;
+    }
+
+    enum { FIELD_COUNT = 8 };
+    char* fields[FIELD_COUNT];
+    size_t lengths[FIELD_COUNT];
+    char* out = s->text;
+    int count = 0;
+    for (;;) {
+        if (count == FIELD_COUNT) {
+            return -1;
+        }
+        char* field = out;
+        if (p < end && *p == '"') {
+            p++;
+            for (;;) {
+                const char* quote = (const char*)memchr(p, '"', end - p);
+                if (!quote) {
+                    return -1;
+                }
+                memcpy(out, p, quote - p);
+                out += quote - p;
+                p = quote + 1;
+                if (p < end && *p == '"') {
+                    *out++ = '"';
+                    p++;
+                    continue;
+                }
+                break;
+            }
+        } else {
+            const char* comma = (const char*)memchr(p, ',', end - p);
+            const char* stop = comma ? comma : end;
+            memcpy(out, p, stop - p);
+            out += stop - p;
+            p = stop;
+        }
+        fields[count] = field;
+        lengths[count] = (size_t)(out - field);
+        *out++ = '\0';
+        count++;
+        if (p == end) {
+            break;
+        }
+        if (*p != ',') {
+            return -1;
+        }
+        p++;
+    }
+    if (count != FIELD_COUNT) {
+        return -1;
+    }
+
+    memset(rec, 0, sizeof(*rec));
+    rec->name = fields[0];
+    rec->name_length = lengths[0];
+    rec->description = fields[1];
+    rec->description_length = lengths[1];
+    if (!parseRecordInt(fields[2], &rec->priority)) {
+        return -1;
+    }
+    if (lengths[3] > 0) {
+        if (!parseRecordDate(fields[3], &rec->due)) {
+            return -1;
+        }
+        rec->has_due = 1;
+    }
+    rec->completed = strcmp(fields[5], "1") == 0 || strcmp(fields[4], "completed") == 0;
+    if (lengths[6] > 0) {
+        if (!parseRecordDate(fields[6], &rec->completed_on)) {
+            return -1;
+        }
+        rec->has_completed_on = 1;
+    }
+    int tag_count = splitCsvTags(fields[7], s);
+    if (tag_count < 0) {
+        return -2;
+    }
+    rec->tags = s->tags;
+    rec->tag_count = tag_count;
+    return 1;
+}
+
+
+// Cursor over one JSON line; strings are unescaped to out
+typedef struct {
+    const char* p;
+    const char* end;
+    char* out;
+} jsonreader;
+
+
+static void skipJsonSpace(jsonreader* r) {
+    while (r->p < r->end && (*r->p == ' ' || *r->p == '\t' || *r->p == '\r' || *r->p == '\n')) {
+        r->p++;
+    }
+}
+
+
+static int readJsonHex4(jsonreader* r, unsigned int* out) {
+    if (r->end - r->p < 4) {
+        return 0;
+    }
+    unsigned int value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = r->p[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else return 0;
+    }
+    r->p += 4;
+    *out = value;
+    return 1;
+}
+
+
+/*
+readJsonString() - Reads a JSON string, unescaping it into the scratch buffer
+ - \uXXXX escapes (surrogate pairs included) become UTF-8
+ - Time: O(length), Space: O(length) in the scratch buffer
+ - Returns the NUL-terminated text, or NULL if it is not a valid string
+ */
+static const char* readJsonString(jsonreader* r, size_t* length) {
+    skipJsonSpace(r);
+    if (r->p == r->end || *r->p != '"') {
+        return NULL;
+    }
+    r->p++;
+    char* start = r->out;
+    while (r->p < r->end) {
+        const char* stop = r->p;
+        while (stop < r->end && *stop != '"' && *stop != '\\') {
+            stop++;
+        }
+        memcpy(r->out, r->p, stop - r->p);
+        r->out += stop - r->p;
+        r->p = stop;
+        if (r->p == r->end) {
+            return NULL;
+        }
+        if (*r->p == '"') {
+            r->p++;
+            *length = (size_t)(r->out - start);
+            *r->out++ = '\0';
+            return start;
+        }
+        if (++r->p == r->end) {
+            return NULL;
+        }
+        char c = *r->p++;
+        switch (c) {
+            case '"': case '\\': case '/': *r->out++ = c; break;
+            case 'n': *r->out++ = '\n'; break;
+            case 'r': *r->out++ = '\r'; break;
+            case 't': *r->out++ = '\t'; break;
+            case 'b': *r->out++ = '\b'; break;
+            case 'f': *r->out++ = '\f'; break;
+            case 'u': {
+                unsigned int code;
+                if (!readJsonHex4(r, &code)) {
+                    return NULL;
+                }
+                if (code >= 0xD800 && code < 0xDC00 && r->end - r->p >= 6 &&
+                    r->p[0] == '\\' && r->p[1] == 'u') {
+                    unsigned int low;
+                    r->p += 2;
+                    if (!readJsonHex4(r, &low) || low < 0xDC00 || low > 0xDFFF) {
+                        return NULL;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                // Escaped text never grows: 6 (or 12) bytes become at most 3 (or 4)
+                if (code < 0x80) {
+                    *r->out++ = (char)code;
+                } else if (code < 0x800) {
+                    *r->out++ = (char)(0xC0 | (code >> 6));
+                    *r->out++ = (char)(0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    *r->out++ = (char)(0xE0 | (code >> 12));
+                    *r->out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+                    *r->out++ = (char)(0x80 | (code & 0x3F));
+                } else {
+                    *r->out++ = (char)(0xF0 | (code >> 18));
+                    *r->out++ = (char)(0x80 | ((code >> 12) & 0x3F));
+                    *r->out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+                    *r->out++ = (char)(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return NULL;
+        }
+    }
+    return NULL;
+}
+
+
+// Consumes c after optional spaces
+static int readJsonChar(jsonreader* r, char c) {
+    skipJsonSpace(r);
+    if (r->p < r->end && *r->p == c) {
+        r->p++;
+        return 1;
+    }
+    return 0;
+}
+
+
+// Consumes a bare word such as true, false or null
+static int readJsonWord(jsonreader* r, const char* word) {
+    skipJsonSpace(r);
+    size_t length = strlen(word);
+    if ((size_t)(r->end - r->p) >= length && memcmp(r->p, word, length) == 0) {
+        r->p += length;
+        return 1;
+    }
+    return 0;
+}
+
+
+/*
+readJsonInt() - Reads an optionally negative integer without looking past the line
+ - Time: O(digits), Space: O(1)
+ */
+static int readJsonInt(jsonreader* r, int* out) {
+    skipJsonSpace(r);
+    int negative = r->p < r->end && *r->p == '-';
+    const char* digits = r->p + negative;
+    long value = 0;
+    const char* q = digits;
+    while (q < r->end && *q >= '0' && *q <= '9' && value <= 1000000) {
+        value = value * 10 + (*q++ - '0');
+    }
+    if (q == digits || value > 1000000) {
+        return 0;
+    }
+    r->p = q;
+    *out = (int)(negative ? -value : value);
+    return 1;
+}
+
+
+/*
+skipJsonValue() - Skips one value of a key this reader does not know
+ - Time: O(value length), Space: O(value length) in the scratch buffer
+ - Returns 1 on success, 0 if the value is malformed
+ */
+static int skipJsonValue(jsonreader* r) {
+    skipJsonSpace(r);
+    if (r->p == r->end) {
+        return 0;
+    }
+    char c = *r->p;
+    if (c == '"') {
+        size_t length;
+        return readJsonString(r, &length) != NULL;
+    }
+    if (c == '{' || c == '[') {
+        char close = c == '{' ? '}' : ']';
+        r->p++;
+        if (readJsonChar(r, close)) {
+            return 1;
+        }
+        do {
+            if (c == '{') {
+                size_t length;
+                if (!readJsonString(r, &length) || !readJsonChar(r, ':')) {
+                    return 0;
+                }
+            }
+            if (!skipJsonValue(r)) {
+                return 0;
+            }
+        } while (readJsonChar(r, ','));
+        return readJsonChar(r, close);
+    }
+    const char* start = r->p;
+    while (r->p < r->end && *r->p != ',' && *r->p != '}' && *r->p != ']' &&
+           *r->p != ' ' && *r->p != '\t' && *r->p != '\r' && *r->p != '\n') {
+        r->p++;
+    }
+    return r->p > start;
+}
+
+
+/*
+readJsonDate() - Reads a "dd/mm/yyyy" string or null
+ - Time: O(1), Space: O(1) in the scratch buffer
+ - Returns 1 for a date, 0 for null, -1 if the value is malformed
+ */
+static int readJsonDate(jsonreader* r, date* out) {
+    if (readJsonWord(r, "null")) {
+        return 0;
+    }
+    size_t length;
+    const char* text = readJsonString(r, &length);
+    if (!text || !parseRecordDate(text, out)) {
+        return -1;
+    }
+    return 1;
+}
+
+
+/*
+parseJsonTask() - Parses one JSON line into rec
+ - Keys may come in any order; unknown keys are skipped
+ - Time: O(line length), Space: O(line length) in the scratch buffer
+ - Returns 1 on success, 0 for a blank line, -1 if the line is malformed,
+   -2 if memory allocation failed
+ */
+static int parseJsonTask(const char* p, const char* end, recordscratch* s, taskrecord* rec) {
+    jsonreader r = {p, end, NULL};
+    skipJsonSpace(&r);
+    if (r.p == r.end) {
+        return 0;
+    }
+    // Unescaped strings plus their NULs never outgrow the line
+    if (!reserveScratch(s, (size_t)(end - p) + 16, 0)) {
+        return -2;
+    }
+    r.out = s->text;
+
+    memset(rec, 0, sizeof(*rec));
+    int has_name = 0, has_status = 0, status_completed = 0;
+    if (!readJsonChar(&r, '{')) {
+        return -1;
+    }
+    if (!readJsonChar(&r, '}')) {
+        do {
+            size_t key_length;
+            const char* key = readJsonString(&r, &key_length);
+            if (!key || !readJsonChar(&r, ':')) {
+                return -1;
+            }
+            if (strcmp(key, "name") == 0) {
+                if (!(rec->name = readJsonString(&r, &rec->name_length))) return -1;
+                has_name = 1;
+            } else if (strcmp(key, "description") == 0) {
+                if (!(rec->description = readJsonString(&r, &rec->description_length))) return -1;
+            } else if (strcmp(key, "priority") == 0) {
+                if (!readJsonInt(&r, &rec->priority)) return -1;
+            } else if (strcmp(key, "due") == 0) {
+                if ((rec->has_due = readJsonDate(&r, &rec->due)) < 0) return -1;
+            } else if (strcmp(key, "status") == 0) {
+                size_t length;
+                const char* status = readJsonString(&r, &length);
+                if (!status) return -1;
+                has_status = 1;
+                status_completed = strcmp(status, "completed") == 0;
+            } else if (strcmp(key, "completed") == 0) {
+                if (readJsonWord(&r, "true")) rec->completed = 1;
+                else if (!readJsonWord(&r, "false")) return -1;
+            } else if (strcmp(key, "completed_on") == 0) {
+                if ((rec->has_completed_on = readJsonDate(&r, &rec->completed_on)) < 0) return -1;
+            } else if (strcmp(key, "tags") == 0) {
+                if (readJsonWord(&r, "null")) continue;
+                if (!readJsonChar(&r, '[')) return -1;
+                if (readJsonChar(&r, ']')) continue;
+                do {
+                    size_t length;
+                    const char* tag = readJsonString(&r, &length);
+                    if (!tag) return -1;
+                    if (length == 0) continue;
+                    if (!reserveScratch(s, 0, rec->tag_count + 1)) return -2;
+                    s->tags[rec->tag_count++] = tag;
+                } while (readJsonChar(&r, ','));
+                if (!readJsonChar(&r, ']')) return -1;
+            } else if (!skipJsonValue(&r)) {
+                return -1;
+            }
+        } while (readJsonChar(&r, ','));
+        if (!readJsonChar(&r, '}')) {
+            return -1;
+        }
+    }
+    skipJsonSpace(&r);
+    if (r.p != r.end || !has_name) {
+        return -1;
+    }
+    if (!rec->description) {
+        rec->description = "";
+    }
+    if (has_status && status_completed) {
+        rec->completed = 1;
+    }
+    rec->tags = s->tags;
+    return 1;
+}
+
+
+/*
+taskFileFormat() - Recognises a task file from its first line
+ - CSV files start with TASKFILE_CSV_HEADER. JSONL files start with a
+   line that parses as a task record, so a text file whose first task
+   name starts with '{' is still read as text
+ - Time: O(first line), Space: O(first line)
+ - Example: taskFileFormat("{\"name\":...", n) -> TASKFILE_JSONL
+ */
+int taskFileFormat(const char* data, size_t size) {
+    size_t header_length = sizeof(TASKFILE_CSV_HEADER) - 1;
+    if (size >= header_length && memcmp(data, TASKFILE_CSV_HEADER, header_length) == 0 &&
+        (size == header_length || data[header_length] == '\n' || data[header_length] == '\r')) {
+        return TASKFILE_CSV;
+    }
+    size_t i = 0;
+    while (i < size && (data[i] == ' ' || data[i] == '\t')) {
+        i++;
+    }
+    if (i == size || data[i] != '{') {
+        return TASKFILE_NONE;
+    }
+    const char* newline = (const char*)memchr(data, '\n', size);
+    recordscratch scratch = {NULL, 0, NULL, 0};
+    taskrecord rec;
+    int parsed = parseJsonTask(data, newline ? newline + 1 : data + size, &scratch, &rec);
+    free(scratch.text);
+    free(scratch.tags);
+    return parsed == 1 ? TASKFILE_JSONL : TASKFILE_NONE;
+}
+
+
+/*
+restoreTaskRecord() - Turns one record back into a task
+ - Pending tasks are linked into the list (duplicate names are counted in
+   dups and skipped); completed ones are appended to the completion log
+ - A shard of a list skips the tasks another shard holds
+ - Invalid priorities and due dates get the same warnings as the old import
+ - Time: O(record length) average, Space: O(record length) in the arena
+ - Returns 1 if a task was added, 0 if it was skipped, -1 if memory ran out
+ */
+static int restoreTaskRecord(tasklist* list, completionlog* done, const taskrecord* rec,
+                             importdups* dups) {
+    int name_length = (int)rec->name_length;
+    if (name_length == 0) {
+        if (currentStore->shard == 0) {  // every shard of a list reads the file
+            printf("Warning: Skipping a record without a task name.\n");
+        }
+        return 0;
+    }
+    if (!taskStoreOwns(currentStore, rec->name, rec->name_length)) {
+        return 0;
+    }
+    if (!rec->completed) {
+        task* existing = nameIndexFindLength(&list->names, rec->name, rec->name_length);
+        if (existing) {
+            if (existing->seq >= dups->first_seq) {
+                dups->repeated++;
+            } else {
+                dups->existing++;
+            }
+            return 0;
+        }
+    }
+
+    task* t = newTask();
+    if (!t) {
+        return -1;
+    }
+    if (!setTaskNameLength(t, rec->name, rec->name_length) ||
+        !setTaskDescriptionLength(t, rec->description, rec->description_length)) {
+        destroyTask(t);
+        return -1;
+    }
+
+    if (rec->priority < 1 || rec->priority > 3) {
+        printf("Warning: Invalid priority %d for task '%.*s'. Setting to Medium (2).\n",
+               rec->priority, name_length, rec->name);
+        t->priority = 2;
+    } else {
+        t->priority = rec->priority;
+    }
+
+    if (rec->has_due) {
+        if (isValidDate(rec->due.day, rec->due.month, rec->due.year)) {
+            setDueDate(t, rec->due.day, rec->due.month, rec->due.year);
+        } else {
+            printf("Warning: Invalid date (%d/%d/%d) for task '%.*s'. Setting no due date.\n",
+                   rec->due.day, rec->due.month, rec->due.year, name_length, rec->name);
+        }
+    }
+
+    for (int i = 0; i < rec->tag_count; i++) {
+        unsigned int id = tagIntern(rec->tags[i]);
+        if (id == TAG_NO_ID) {
+            destroyTask(t);
+            return -1;
+        }
+        if (!taskHasTag(t, id) && !taskAddTag(t, id)) {
+            destroyTask(t);
+            return -1;
+        }
+    }
+
+    if (!rec->completed) {
+        t->completed = 0;
+        t->status = PENDING;
+        if (!linkTask(list, t)) {
+            destroyTask(t);
+            return -1;
+        }
+        return 1;
+    }
+
+    // A completion day that is missing or invalid falls back to today
+    date day = getToday();
+    if (rec->has_completed_on &&
+        isValidDate(rec->completed_on.day, rec->completed_on.month, rec->completed_on.year)) {
+        day = rec->completed_on;
+    }
+    if (!completionLogAppend(done, t, (unsigned int)dateToDays(day))) {
+        destroyTask(t);
+        return -1;
+    }
+    t->status = COMPLETED;
+    t->completed = 1;
+    t->seq = (unsigned int)(done->count - 1);
+    textIndexTask(t);
+    return 1;
+}
+
+
+/*
+importTaskFile() - Imports a CSV or JSONL task file written by exportTaskFile()
+ - Records are parsed one at a time from the mapped (or buffered) file, so
+   memory use beyond the tasks is one record
+ - Time: O(file size) average, Space: O(longest record)
+ - Returns the number of tasks imported
+ */
+int importTaskFile(tasklist* list, completionlog* done, const char* data, size_t size, int format,
+                   importdups* dups) {
+    const char* p = data;
+    const char* end = data + size;
+    recordscratch scratch = {NULL, 0, NULL, 0};
+    long record_number = 0;
+    int imported_count = 0;
+
+    if (format == TASKFILE_CSV) {
+        const char* newline = (const char*)memchr(p, '\n', end - p);
+        p = newline ? newline + 1 : end;
+    }
+
+    while (p < end) {
+        const char* record_end;
+        if (format == TASKFILE_CSV) {
+            record_end = csvRecordEnd(p, end);
+        } else {
+            const char* newline = (const char*)memchr(p, '\n', end - p);
+            record_end = newline ? newline + 1 : end;
+        }
+        record_number++;
+
+        taskrecord rec;
+        int parsed = format == TASKFILE_CSV ? parseCsvTask(p, record_end, &scratch, &rec)
+                                            : parseJsonTask(p, record_end, &scratch, &rec);
+        p = record_end;
+        if (parsed == 0) {
+            continue;
+        }
+        if (parsed == -1) {
+            if (currentStore->shard == 0) {
+                printf("Warning: Could not parse record %ld. Skipping.\n", record_number);
+            }
+            continue;
+        }
+        int added = parsed == -2 ? -1 : restoreTaskRecord(list, done, &rec, dups);
+        if (added < 0) {
+            printf("Memory allocation failed during import. Aborting rest.\n");
+            break;
+        }
+        imported_count += added;
+    }
+
+    free(scratch.text);
+    free(scratch.tags);
+    return imported_count;
+}
@@ -0,0 +1,52 @@
+#ifndef TASKFILE_H
+#define TASKFILE_H
+
+#include <stddef.h>
+#include "task_management.h"
+#include "fileio.h"
+
+// Machine-readable task files that import can read back without loss.
+// Every task is one record holding all of its fields: name, description,
+// priority, due date, status, completed flag, completion day and tags.
+// Pending tasks are written oldest first and completed tasks in log
+// order, so importing a file into an empty list rebuilds the same list
+// order and the same completion log.
+#define TASKFILE_NONE 0             // not a task file (the old import format)
+#define TASKFILE_CSV 1
+#define TASKFILE_JSONL 2
+
+// First line of a CSV task file, which is also how import recognises one
+#define TASKFILE_CSV_HEADER "name,description,priority,due,status,completed,completed_on,tags"
+
+// One record as read from a file; text points into the reader's scratch
+// buffer and is NUL-terminated
+typedef struct {
+    const char* name;
+    size_t name_length;
+    const char* description;
+    size_t description_length;
+    int priority;
+    int has_due;
+    date due;
+    int completed;
+    int has_completed_on;
+    date completed_on;
+    const char** tags;
+    int tag_count;
+} taskrecord;
+
+// Reusable buffers for parsing records
+typedef struct {
+    char* text;                     // unescaped fields, each NUL-terminated
+    size_t text_capacity;
+    const char** tags;
+    int tag_capacity;
+} recordscratch;
+
+int taskFileFormat(const char* data, size_t size);
+int taskFileFormatForName(const char* filename);
+int exportTaskFile(tasklist* list, completionlog* done, const char* filename, int format);
+int importTaskFile(tasklist* list, completionlog* done, const char* data, size_t size, int format,
+                   importdups* dups);
+
+#endif
@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "taskqueue.h"
+
+
+static double queueSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+taskQueueInit() - Sets up an empty ring of capacity slots (a power of two)
+ - Time: O(capacity), Space: O(capacity)
+ - Returns 1 on success, 0 if memory or the wake-up eventfd ran out
+ - Example: taskQueueInit(&commands, TASKQUEUE_CAPACITY)
+ */
+int taskQueueInit(taskqueue* q, unsigned long capacity) {
+    memset(q, 0, sizeof(*q));
+    q->slots = (queueslot*)malloc(capacity * sizeof(queueslot));
+    q->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!q->slots || q->wake_fd < 0) {
+        free(q->slots);
+        if (q->wake_fd >= 0) {
+            close(q->wake_fd);
+        }
+        q->slots = NULL;
+        return 0;
+    }
+    for (unsigned long i = 0; i < capacity; i++) {
+        q->slots[i].sequence = i;
+    }
+    q->mask = capacity - 1;
+    return 1;
+}
+
+
+/*
+taskQueuePush() - Adds an item for the owner thread (any thread)
+ - Claims the next slot with a compare-and-swap on the tail, fills it and
+   hands it over by bumping its sequence. On a full ring the producer
+   yields until the owner has drained a slot
+ - Wakes the owner if it is waiting in taskQueueWait()
+ - Time: O(1) without contention, Space: O(1)
+ */
+void taskQueuePush(taskqueue* q, void* item) {
+    unsigned long position = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+    queueslot* slot;
+    int waited = 0;
+    while (1) {
+        slot = &q->slots[position & q->mask];
+        unsigned long sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        long turn = (long)(sequence - position);
+        if (turn == 0) {
+            if (__atomic_compare_exchange_n(&q->tail, &position, position + 1, 1, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (turn < 0) {
+            // Full: the owner has not freed this slot from the last lap yet
+            if (!waited) {
+                __atomic_add_fetch(&q->full_waits, 1, __ATOMIC_RELAXED);
+                waited = 1;
+            }
+            sched_yield();
+            position = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+        } else {
+            position = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+        }
+    }
+    slot->item = item;
+    slot->pushed = queueSeconds();
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&q->pushed, 1, __ATOMIC_RELAXED);
+
+    // The owner sets sleeping before it looks at the ring a last time, so
+    // either it sees this item or this sees it sleeping
+    if (__atomic_load_n(&q->sleeping, __ATOMIC_SEQ_CST) && __atomic_exchange_n(&q->sleeping, 0, __ATOMIC_SEQ_CST)) {
+        unsigned long long one = 1;
+        if (write(q->wake_fd, &one, sizeof(one)) < 0) {
+            // The eventfd is already signalled; the owner wakes either way
+        }
+    }
+}
+
+
+// Bucket of a batch size: 1, 2-3, 4-7, ..., 64 and over
+static int batchBucket(int size) {
+    int bucket = 0;
+    while (size > 1 && bucket < TASKQUEUE_BATCH_BUCKETS - 1) {
+        size >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+
+/*
+taskQueueDrain() - Takes up to max items in push order (owner thread only)
+ - Stops at the first slot whose producer has claimed it but not filled it yet
+ - Records the batch size, the depth seen and how long each item waited
+ - Time: O(items taken), Space: O(1)
+ - Returns the number of items put in items (0 if the ring is empty)
+ */
+int taskQueueDrain(taskqueue* q, void** items, int max) {
+    long depth = taskQueueDepth(q);
+    if (depth > q->peak_depth) {
+        q->peak_depth = depth;
+    }
+    double now = queueSeconds();
+    int count = 0;
+    while (count < max) {
+        queueslot* slot = &q->slots[q->head & q->mask];
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != q->head + 1) {
+            break;
+        }
+        items[count++] = slot->item;
+        double waited = now - slot->pushed;
+        if (waited > 0) {
+            q->wait_seconds += waited;
+            if (waited > q->longest_wait) {
+                q->longest_wait = waited;
+            }
+        }
+        __atomic_store_n(&slot->sequence, q->head + q->mask + 1, __ATOMIC_RELEASE);
+        q->head++;
+    }
+    if (count > 0) {
+        q->drained += count;
+        q->batches++;
+        q->batch_counts[batchBucket(count)]++;
+        if (count > q->largest_batch) {
+            q->largest_batch = count;
+        }
+    }
+    return count;
+}
+
+
+/*
+taskQueueWait() - Sleeps until an item is pushed or timeout_ms pass (owner thread only)
+ - Also returns early on a signal
+ - Time: O(1), Space: O(1)
+ */
+void taskQueueWait(taskqueue* q, int timeout_ms) {
+    __atomic_store_n(&q->sleeping, 1, __ATOMIC_SEQ_CST);
+    queueslot* slot = &q->slots[q->head & q->mask];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_SEQ_CST) == q->head + 1) {
+        __atomic_store_n(&q->sleeping, 0, __ATOMIC_SEQ_CST);
+        return;
+    }
+    struct pollfd wake = {q->wake_fd, POLLIN, 0};
+    poll(&wake, 1, timeout_ms);
+    __atomic_store_n(&q->sleeping, 0, __ATOMIC_SEQ_CST);
+    unsigned long long count;
+    if (read(q->wake_fd, &count, sizeof(count)) < 0) {
+        // Nothing was written: woken by the timeout or a signal
+    }
+}
+
+
+/*
+taskQueueWake() - Wakes the owner from taskQueueWait() without pushing anything
+ - For another thread that wants the owner to look at its stop flag now
+ - Time: O(1), Space: O(1)
+ */
+void taskQueueWake(taskqueue* q) {
+    unsigned long long one = 1;
+    if (write(q->wake_fd, &one, sizeof(one)) < 0) {
+        // The counter is already non-zero: the owner wakes anyway
+    }
+}
+
+
+/*
+taskQueueDepth() - Items pushed and not yet drained (claimed slots included)
+ - Time: O(1), Space: O(1)
+ */
+long taskQueueDepth(taskqueue* q) {
+    return (long)(__atomic_load_n(&q->tail, __ATOMIC_RELAXED) - __atomic_load_n(&q->head, __ATOMIC_RELAXED));
+}
+
+
+/*
+taskQueueFree() - Frees the ring (items still in it are not touched)
+ - Time: O(1), Space: O(1)
+ */
+void taskQueueFree(taskqueue* q) {
+    free(q->slots);
+    q->slots = NULL;
+    if (q->wake_fd >= 0) {
+        close(q->wake_fd);
+        q->wake_fd = -1;
+    }
+}
+
+
+/*
+printTaskQueueStats() - Prints how deep the ring got, batch sizes and waiting times
+ - Time: O(1), Space: O(1)
+ - Sample Case:
+    Output:
+      Queue: 40000 commands in 9120 batches (4.4 average, 64 largest), 64 deep at most, 0 full waits
+      Batches: 1: 3050 | 2-3: 2210 | 4-7: 1930 | 8-15: 1200 | 16-31: 560 | 32-63: 150 | 64+: 20
+      Queue wait: 21.5 us average, 2310.2 us longest
+ */
+void printTaskQueueStats(taskqueue* q, FILE* out) {
+    fprintf(out, "Queue: %ld commands in %ld batches (%.1f average, %ld largest), %ld deep at most, "
+            "%ld full waits\n",
+            q->drained, q->batches, q->batches ? (double)q->drained / q->batches : 0.0, q->largest_batch,
+            q->peak_depth, q->full_waits);
+    fprintf(out, "Batches:");
+    for (int b = 0; b < TASKQUEUE_BATCH_BUCKETS; b++) {
+        long low = 1L << b;
+        if (b == TASKQUEUE_BATCH_BUCKETS - 1) {
+            fprintf(out, " | %ld+: %ld", low, q->batch_counts[b]);
+        } else if (low == 1) {
+            fprintf(out, " 1: %ld", q->batch_counts[b]);
+        } else {
+            fprintf(out, " | %ld-%ld: %ld", low, 2 * low - 1, q->batch_counts[b]);
+        }
+    }
+    fprintf(out, "\nQueue wait: %.1f us average, %.1f us longest\n",
+            q->drained ? q->wait_seconds / q->drained * 1e6 : 0.0, q->longest_wait * 1e6);
+}
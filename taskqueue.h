@@ -0,0 +1,52 @@
+#ifndef TASKQUEUE_H
+#define TASKQUEUE_H
+
+#include <stdio.h>
+
+// Bounded multi-producer, single-consumer ring of commands for the thread
+// that owns the task list. Any thread may push; one owner thread drains
+// the ring in batches and applies them. Producers claim a slot with one
+// compare-and-swap on the tail, and each slot carries a sequence number
+// that says whose turn it is, so no lock is taken on either side. A full
+// ring makes producers wait (backpressure) instead of growing it.
+#define TASKQUEUE_CAPACITY 4096         // slots; a power of two
+#define TASKQUEUE_BATCH 64              // most commands drained at once
+#define TASKQUEUE_BATCH_BUCKETS 7       // batch sizes 1, 2-3, 4-7, ..., 64
+
+// One slot: the item, when it was pushed, and whose turn the slot is
+typedef struct {
+    unsigned long sequence;             // position + 1 once filled, position + capacity once free again
+    void* item;
+    double pushed;                      // seconds, for the wait time
+} queueslot;
+
+typedef struct {
+    queueslot* slots;
+    unsigned long mask;                 // capacity - 1
+    unsigned long tail __attribute__((aligned(64)));  // next position producers claim
+    unsigned long head __attribute__((aligned(64)));  // next position the owner takes (owner only)
+    int sleeping __attribute__((aligned(64)));        // owner waits on wake_fd (see taskQueueWait())
+    int wake_fd;                        // eventfd producers write to wake the owner
+
+    // Counters for printTaskQueueStats(); producers only touch the first two
+    long pushed;
+    long full_waits;                    // pushes that found the ring full and waited
+    long drained;
+    long batches;
+    long largest_batch;
+    long batch_counts[TASKQUEUE_BATCH_BUCKETS];
+    long peak_depth;
+    double wait_seconds;                // push to drain, summed
+    double longest_wait;
+} taskqueue;
+
+int taskQueueInit(taskqueue* q, unsigned long capacity);
+void taskQueuePush(taskqueue* q, void* item);
+int taskQueueDrain(taskqueue* q, void** items, int max);
+void taskQueueWait(taskqueue* q, int timeout_ms);
+void taskQueueWake(taskqueue* q);
+long taskQueueDepth(taskqueue* q);
+void taskQueueFree(taskqueue* q);
+void printTaskQueueStats(taskqueue* q, FILE* out);
+
+#endif
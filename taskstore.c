@@ -0,0 +1,290 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "taskstore.h"
+#include "scheduler.h"
+
+__thread taskstore* currentStore = NULL;
+
+
+// Copy of a path, or NULL for NULL; sets *failed if memory ran out
+static char* copyPath(const char* path, int* failed) {
+    if (!path) {
+        return NULL;
+    }
+    char* copy = strdup(path);
+    if (!copy) {
+        *failed = 1;
+    }
+    return copy;
+}
+
+
+/*
+taskStoreCreate() - Makes an empty store that saves to snapshot_path and journals to journal_path
+ - Either path may be NULL (not saved, not journaled); both are copied
+ - Nothing is read yet (see taskStoreLoad()); today starts at the current date
+ - Time: O(1), Space: O(1)
+ - Returns the store, or NULL if memory ran out
+ - Example: taskStoreCreate(snapshotPath(), journalPath()) -> the default list
+ */
+taskstore* taskStoreCreate(const char* snapshot_path, const char* journal_path) {
+    taskstore* s = (taskstore*)calloc(1, sizeof(taskstore));
+    if (!s) {
+        return NULL;
+    }
+    slab task_slab = SLAB_INIT("task", task, 1024);
+    slab order_slab = SLAB_INIT("ordernode", ordernode, 1024);
+    epochlimbo limbo = EPOCH_LIMBO_INIT;
+    s->task_slab = task_slab;
+    s->order_slab = order_slab;
+    s->limbo = limbo;
+    s->journal.fd = -1;
+    s->today = getToday();
+    s->shard_count = 1;
+
+    int failed = 0;
+    s->snapshot_path = copyPath(snapshot_path, &failed);
+    s->journal_path = copyPath(journal_path, &failed);
+    if (failed) {
+        free(s->snapshot_path);
+        free(s->journal_path);
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+
+/*
+taskStoreUse() - Makes s the store the calling thread works on
+ - Time: O(1), Space: O(1)
+ */
+void taskStoreUse(taskstore* s) {
+    currentStore = s;
+}
+
+
+/*
+taskStoreLoad() - Starts restoring the store's snapshot, then its journal, in the background
+ - Without a snapshot the journal is replayed here instead
+ - Binds s; call taskStoreReady() before anything else touches it
+ - Time: O(tags) before returning (O(journal) without a snapshot), Space: O(1)
+ */
+void taskStoreLoad(taskstore* s) {
+    taskStoreUse(s);
+    if (!snapshotLoadStart(&s->list, &s->done, s->snapshot_path, s->journal_path, s->today)) {
+        journalOpen(&s->list, &s->done, s->journal_path, 0, 0);
+        updateTaskStatuses(&s->list, s->today);  // due tracker starts at today
+    }
+}
+
+
+/*
+taskStoreReady() - Waits for the store's load and reports it
+ - Binds s
+ - Time: O(1) once the loader is done, Space: O(1)
+ */
+void taskStoreReady(taskstore* s) {
+    taskStoreUse(s);
+    snapshotLoadFinish();
+    journalReport();
+}
+
+
+/*
+taskStoreClose() - Saves the snapshot, closes the journal and frees the store
+ - A running background checkpoint is waited for first; the snapshot then
+   holds every journaled change, so the journal restarts empty
+ - Memory retired for reader threads is waited for, so readers must not
+   be on the store's tasks any more
+ - Time: O(n + total text), Space: O(n)
+ */
+void taskStoreClose(taskstore* s) {
+    taskStoreUse(s);
+    snapshotLoadFinish();
+    checkpointWait();
+    if (s->snapshot_path) {
+        journalmark mark = journalMark();
+        if (snapshotSave(&s->list, &s->done, s->snapshot_path, mark.generation, mark.offset) >= 0) {
+            journalCompact(mark);
+        }
+    }
+    journalClose();
+    epochSynchronize();
+    epochReclaim();
+    resetTaskMemory(&s->list, &s->done);
+    slabRelease(&s->limbo.records);
+    if (s->load.data) {
+        munmap((void*)s->load.data, s->load.size);
+    }
+    free(s->snapshot_path);
+    free(s->journal_path);
+    free(s->name);
+    free(s);
+    currentStore = NULL;
+}
+
+
+/*
+taskStoreShardCount() - Number of shards the default list is split into
+ - TODO_SHARDS overrides the default of 1 (not sharded)
+ - Time: O(1), Space: O(1)
+ - Example: TODO_SHARDS=4 ./todo_progress --serve -> 4
+ */
+int taskStoreShardCount(void) {
+    const char* setting = getenv("TODO_SHARDS");
+    long shards = setting ? strtol(setting, NULL, 10) : 1;
+    if (shards < 1) {
+        shards = 1;
+    }
+    return shards > STORE_MAX_SHARDS ? STORE_MAX_SHARDS : (int)shards;
+}
+
+
+/*
+taskStoreShardOf() - Shard that holds the task with this name
+ - The name hash is mixed again before it is reduced, so the tasks of
+   one shard still spread over every slot of its name index
+ - Time: O(length), Space: O(1)
+ - Returns a shard in [0, shard_count)
+ */
+int taskStoreShardOf(const char* name, size_t length, int shard_count) {
+    if (shard_count <= 1) {
+        return 0;
+    }
+    unsigned int mixed = hashTaskNameLength(name, length) * 0x9e3779b9u;
+    return (int)(((unsigned long long)mixed * (unsigned int)shard_count) >> 32);
+}
+
+
+/*
+taskStoreOwns() - Whether a task with this name belongs in store s
+ - Always true unless s is one shard of a list
+ - Time: O(length), Space: O(1)
+ */
+int taskStoreOwns(const taskstore* s, const char* name, size_t length) {
+    return s->shard_count <= 1 || taskStoreShardOf(name, length, s->shard_count) == s->shard;
+}
+
+
+/*
+taskStoreValidName() - Whether name may name a list
+ - 1 to STORE_MAX_NAME - 1 letters, digits, '-' and '_', so it is also a
+   safe file name
+ - Time: O(length), Space: O(1)
+ - Example: taskStoreValidName("team-7") -> 1, taskStoreValidName("../x") -> 0
+ */
+int taskStoreValidName(const char* name) {
+    size_t length = 0;
+    for (; name[length]; length++) {
+        unsigned char c = (unsigned char)name[length];
+        if (length + 1 >= STORE_MAX_NAME || !(isalnum(c) || c == '-' || c == '_')) {
+            return 0;
+        }
+    }
+    return length > 0;
+}
+
+
+/*
+taskStoreListDir() - Directory the files of named lists are kept in
+ - TODO_LIST_DIR overrides STORE_LIST_DIR
+ - Time: O(1), Space: O(1)
+ */
+const char* taskStoreListDir(void) {
+    const char* dir = getenv("TODO_LIST_DIR");
+    return dir && dir[0] ? dir : STORE_LIST_DIR;
+}
+
+
+/*
+taskStoreListPath() - File of a named list: <list dir>/<name>.<suffix>
+ - Time: O(length), Space: O(length)
+ - Returns a path to free(), or NULL if memory ran out
+ - Example: taskStoreListPath("team-7", "snap") -> "lists/team-7.snap"
+ */
+char* taskStoreListPath(const char* name, const char* suffix) {
+    const char* dir = taskStoreListDir();
+    size_t size = strlen(dir) + strlen(name) + strlen(suffix) + 3;
+    char* path = (char*)malloc(size);
+    if (path) {
+        snprintf(path, size, "%s/%s.%s", dir, name, suffix);
+    }
+    return path;
+}
+
+
+/*
+taskStoreShardPath() - File of one shard: path itself unless the list is sharded, else path with .<shard> before its extension
+ - Keeping the extension last keeps the format exports pick from it
+ - Time: O(length), Space: O(length)
+ - Returns a path to free(), NULL for a NULL path or if memory ran out
+ - Example: taskStoreShardPath("todo.snap", 2, 4) -> "todo.2.snap"
+ */
+char* taskStoreShardPath(const char* path, int shard, int shard_count) {
+    if (!path) {
+        return NULL;
+    }
+    if (shard_count <= 1) {
+        return strdup(path);
+    }
+    const char* base = strrchr(path, '/');
+    const char* extension = strrchr(base ? base + 1 : path, '.');
+    size_t stem = extension && extension != (base ? base + 1 : path) ? (size_t)(extension - path) : strlen(path);
+    size_t size = strlen(path) + 16;
+    char* shard_path = (char*)malloc(size);
+    if (shard_path) {
+        snprintf(shard_path, size, "%.*s.%d%s", (int)stem, path, shard, path + stem);
+    }
+    return shard_path;
+}
+
+
+// Checks the files of one kind at path against shard_count (see taskStoreShardsMatch())
+static int shardFilesMatch(const char* path, int shard_count, int (*shard_of)(const char*, int*, int*)) {
+    int ok = 1;
+    // k = -1 is path itself, the file of an unsharded list
+    for (int k = -1; k < STORE_MAX_SHARDS && ok; k++) {
+        char* file = k < 0 ? strdup(path) : taskStoreShardPath(path, k, STORE_MAX_SHARDS);
+        if (!file) {
+            fprintf(stderr, "Out of memory\n");
+            return 0;
+        }
+        int used = shard_count <= 1 ? k < 0 : k >= 0 && k < shard_count;
+        int shard, count;
+        if (used) {
+            if (shard_of(file, &shard, &count) && (shard != (k < 0 ? 0 : k) || count != shard_count)) {
+                fprintf(stderr, "%s holds shard %d of %d, but TODO_SHARDS is %d\n", file, shard, count,
+                        shard_count);
+                ok = 0;
+            }
+        } else if (access(file, F_OK) == 0) {
+            fprintf(stderr, "%s was written with another TODO_SHARDS; its tasks would not be loaded\n", file);
+            ok = 0;
+        }
+        free(file);
+    }
+    return ok;
+}
+
+
+/*
+taskStoreShardsMatch() - Whether the default list's files were written with shard_count shards
+ - Each shard's snapshot and journal must name that shard of shard_count
+   in their headers (files of another version are left to the loader),
+   and no file of another shard count may be left over: its tasks would
+   not load, or would load into a shard their names do not hash to, and
+   a name could then be added twice
+ - What does not match is printed to stderr
+ - Time: O(STORE_MAX_SHARDS), Space: O(path length)
+ - Returns 1 if the list may be opened with shard_count shards
+ - Example: TODO_SHARDS=2 after TODO_SHARDS=4 -> 0 ("todo.0.snap holds shard 0 of 4, ...")
+ */
+int taskStoreShardsMatch(const char* snapshot_path, const char* journal_path, int shard_count) {
+    return (!snapshot_path || shardFilesMatch(snapshot_path, shard_count, snapshotShardOf)) &&
+           (!journal_path || shardFilesMatch(journal_path, shard_count, journalShardOf));
+}
@@ -0,0 +1,62 @@
+#ifndef TASKSTORE_H
+#define TASKSTORE_H
+
+#include "task_management.h"
+#include "journal.h"
+#include "checkpoint.h"
+#include "snapshot.h"
+#include "epoch.h"
+
+// Everything one task list owns: the list and its indexes, the completion
+// log, its date, the allocators and stores its tasks' records, text and
+// tags live in, the memory it has retired for readers, and its snapshot
+// and journal. A process may hold any number of stores. The functions of
+// the other modules keep their signatures and work on the store the
+// calling thread has bound with taskStoreUse(); a thread binds a store
+// before it touches it and may switch between stores at any time.
+//
+// A huge list may be split by name hash into shards, one store each
+// (taskStoreShardOf()), so that different threads change different shards.
+#define STORE_MAX_SHARDS 64             // TODO_SHARDS
+#define STORE_LIST_DIR "lists"          // TODO_LIST_DIR: files of named lists
+#define STORE_MAX_NAME 64               // letters, digits, '-' and '_'
+
+typedef struct taskstore {
+    tasklist list;
+    completionlog done;
+    date today;
+    slab task_slab;                     // every task of the store
+    slab order_slab;                    // view order index nodes
+    coldstore cold;
+    stringarena arena;
+    tagdictionary tag_dict;
+    textindex text;
+    epochlimbo limbo;                   // memory retired by this store's writer
+    journal journal;
+    checkpointer checkpoint;
+    snapshotload load;
+    char* snapshot_path;                // NULL: not saved
+    char* journal_path;                 // NULL: not journaled
+    char* name;                         // list name in the server, NULL for the default list
+    int shard;                          // which shard of its list this store holds
+    int shard_count;                    // 1 unless the list is sharded
+} taskstore;
+
+// The store the calling thread works on
+extern __thread taskstore* currentStore;
+
+taskstore* taskStoreCreate(const char* snapshot_path, const char* journal_path);
+void taskStoreUse(taskstore* s);
+void taskStoreLoad(taskstore* s);
+void taskStoreReady(taskstore* s);
+void taskStoreClose(taskstore* s);
+int taskStoreShardCount(void);
+int taskStoreShardOf(const char* name, size_t length, int shard_count);
+int taskStoreOwns(const taskstore* s, const char* name, size_t length);
+int taskStoreValidName(const char* name);
+const char* taskStoreListDir(void);
+char* taskStoreListPath(const char* name, const char* suffix);
+char* taskStoreShardPath(const char* path, int shard, int shard_count);
+int taskStoreShardsMatch(const char* snapshot_path, const char* journal_path, int shard_count);
+
+#endif
@@ -0,0 +1,495 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "textindex.h"
+#include "task_management.h"
+#include "taskstore.h"
+#include "epoch.h"
+
+#define TEXT_INITIAL_GRAMS 1024
+#define TEXT_POSTING_INITIAL_CAPACITY 4
+#define TEXT_COMPACT_MIN_STALE 4096
+#define TEXT_NO_DOC 0xffffffffu        // id and gen of padding postings (match nothing)
+
+
+static unsigned int gramKey(const char* s) {
+    return ((unsigned int)(unsigned char)s[0] << 16) |
+           ((unsigned int)(unsigned char)s[1] << 8) |
+           (unsigned int)(unsigned char)s[2];
+}
+
+
+static unsigned int gramHash(unsigned int key) {
+    return key * 2654435761u;
+}
+
+
+/*
+collectGrams() - Appends every trigram of a string to the gram buffer
+ - Time: O(length), Space: O(length)
+ - Returns the new number of keys in the buffer, or -1 if memory allocation failed
+ */
+static int collectGrams(const char* s, int count) {
+    textindex* index = &currentStore->text;
+    size_t length = strlen(s);
+    if (length < TEXT_GRAM_LENGTH) {
+        return count;
+    }
+    int needed = count + (int)(length - TEXT_GRAM_LENGTH + 1);
+    if (needed > index->gram_buffer_capacity) {
+        int new_capacity = index->gram_buffer_capacity ? index->gram_buffer_capacity : 256;
+        while (new_capacity < needed) {
+            new_capacity *= 2;
+        }
+        unsigned int* grown = (unsigned int*)realloc(index->gram_buffer, new_capacity * sizeof(unsigned int));
+        if (!grown) {
+            return -1;
+        }
+        index->gram_buffer = grown;
+        index->gram_buffer_capacity = new_capacity;
+    }
+    for (size_t i = 0; i + TEXT_GRAM_LENGTH <= length; i++) {
+        index->gram_buffer[count++] = gramKey(s + i);
+    }
+    return count;
+}
+
+
+/*
+findGram() - Slot of a trigram in a table, or NULL if it was never indexed
+ - Safe on a reader thread: keys are only ever set on empty slots
+ - Time: O(1) average, Space: O(1)
+ */
+static textgram* findGram(textgramtable* table, unsigned int key) {
+    if (!table) {
+        return NULL;
+    }
+    unsigned int mask = table->capacity - 1;
+    for (unsigned int i = gramHash(key) & mask; ; i = (i + 1) & mask) {
+        textgram* g = &table->slots[i];
+        unsigned int slot_key = __atomic_load_n(&g->key, __ATOMIC_ACQUIRE);
+        if (slot_key == key) {
+            return g;
+        }
+        if (slot_key == 0) {
+            return NULL;
+        }
+    }
+}
+
+
+static void releaseBlock(void* object) {
+    free(object);
+}
+
+
+/*
+growGrams() - Doubles the trigram table and re-inserts every posting list
+ - The new table is built aside and published whole; the old one is
+   retired, so a reader still probing it finds the lists as they were
+ - Time: O(trigrams), Space: O(trigrams)
+ - Returns 1 on success, 0 if memory allocation failed
+ */
+static int growGrams(void) {
+    textindex* index = &currentStore->text;
+    textgramtable* old = index->grams;
+    int new_capacity = old ? old->capacity * 2 : TEXT_INITIAL_GRAMS;
+    textgramtable* grams = (textgramtable*)calloc(1, sizeof(textgramtable) + new_capacity * sizeof(textgram));
+    if (!grams) {
+        return 0;
+    }
+    grams->capacity = new_capacity;
+    unsigned int mask = new_capacity - 1;
+    for (int i = 0; old && i < old->capacity; i++) {
+        textgram* g = &old->slots[i];
+        if (g->key == 0) {
+            continue;
+        }
+        unsigned int j = gramHash(g->key) & mask;
+        while (grams->slots[j].key != 0) {
+            j = (j + 1) & mask;
+        }
+        grams->slots[j] = *g;
+    }
+    EPOCH_PUBLISH(index->grams, grams);
+    if (old) {
+        epochRetire(old, releaseBlock);
+    }
+    return 1;
+}
+
+
+/*
+internGram() - Slot of a trigram, created empty if needed
+ - Time: O(1) amortized, Space: O(1) amortized
+ - Returns NULL if memory allocation failed
+ */
+static textgram* internGram(unsigned int key) {
+    textindex* index = &currentStore->text;
+    textgram* g = findGram(index->grams, key);
+    if (g) {
+        return g;
+    }
+    int capacity = index->grams ? index->grams->capacity : 0;
+    if ((index->gram_count + 1) * 2 > capacity && !growGrams()) {
+        return NULL;
+    }
+    unsigned int mask = index->grams->capacity - 1;
+    unsigned int i = gramHash(key) & mask;
+    while (index->grams->slots[i].key != 0) {
+        i = (i + 1) & mask;
+    }
+    // The slot is empty (no postings) before readers can find its key
+    __atomic_store_n(&index->grams->slots[i].key, key, __ATOMIC_RELEASE);
+    index->gram_count++;
+    return &index->grams->slots[i];
+}
+
+
+/*
+postingTask() - The task a posting stands for, or NULL if the posting is stale
+ - docs and doc_capacity are loaded once per query on reader threads
+ - Time: O(1), Space: O(1)
+ */
+static task* postingTask(const textdoc* docs, unsigned int doc_capacity, textposting p) {
+    if (p.id >= doc_capacity) {
+        return NULL;
+    }
+    task* t = __atomic_load_n(&docs[p.id].task_data, __ATOMIC_ACQUIRE);
+    return t && __atomic_load_n(&docs[p.id].gen, __ATOMIC_RELAXED) == p.gen ? t : NULL;
+}
+
+
+/*
+compactPostings() - Drops every stale posting from every list
+ - With reader threads registered a list is copied instead of changed in
+   place, and the old copy retired. The copy keeps the old length, padded
+   with postings that match nothing, for readers that loaded the old count
+ - Time: O(total postings), Space: O(1), O(longest list) with readers
+ */
+static void compactPostings(void) {
+    textindex* index = &currentStore->text;
+    int shared = epochShared();
+    for (int i = 0; index->grams && i < index->grams->capacity; i++) {
+        textgram* g = &index->grams->slots[i];
+        if (!shared) {
+            int kept = 0;
+            for (int j = 0; j < g->count; j++) {
+                if (postingTask(index->docs, index->doc_capacity, g->items[j])) {
+                    g->items[kept++] = g->items[j];
+                }
+            }
+            g->count = kept;
+            continue;
+        }
+        if (g->count == 0) {
+            continue;
+        }
+        textposting* items = (textposting*)malloc(g->capacity * sizeof(textposting));
+        if (!items) {
+            continue;   // stays uncompacted; its stale postings are only skipped
+        }
+        int kept = 0;
+        for (int j = 0; j < g->count; j++) {
+            if (postingTask(index->docs, index->doc_capacity, g->items[j])) {
+                items[kept++] = g->items[j];
+            }
+        }
+        for (int j = kept; j < g->count; j++) {
+            items[j].id = TEXT_NO_DOC;
+            items[j].gen = TEXT_NO_DOC;
+        }
+        textposting* old = g->items;
+        EPOCH_PUBLISH(g->items, items);
+        EPOCH_PUBLISH(g->count, kept);  // readers load count before items
+        epochRetire(old, releaseBlock);
+    }
+    index->stale = 0;
+    index->compactions++;
+}
+
+
+/*
+retireDoc() - Marks the current postings of an id as stale
+ - Time: O(1), Space: O(1)
+ */
+static void retireDoc(textdoc* doc) {
+    textindex* index = &currentStore->text;
+    if (doc->task_data && doc->gen == TEXT_GEN_DEFERRED) {
+        __atomic_sub_fetch(&index->deferred, 1, __ATOMIC_RELAXED);
+    }
+    index->live -= doc->postings;
+    index->stale += doc->postings;
+    doc->postings = 0;
+    __atomic_store_n(&doc->task_data, NULL, __ATOMIC_RELEASE);
+    if (index->stale > index->live && index->stale > TEXT_COMPACT_MIN_STALE) {
+        compactPostings();
+    }
+}
+
+
+/*
+reserveDocs() - Grows the doc table so it covers cold id
+ - Time: O(ids) when growing, Space: O(ids)
+ - Returns 1 on success, 0 if memory allocation failed
+ */
+static int reserveDocs(unsigned int id) {
+    textindex* index = &currentStore->text;
+    if (id < index->doc_capacity) {
+        return 1;
+    }
+    unsigned int new_capacity = index->doc_capacity ? index->doc_capacity : 1024;
+    while (new_capacity <= id) {
+        new_capacity *= 2;
+    }
+    textdoc* docs = (textdoc*)epochResize(index->docs, index->doc_capacity * sizeof(textdoc),
+                                          new_capacity * sizeof(textdoc));
+    if (!docs) {
+        return 0;
+    }
+    memset(docs + index->doc_capacity, 0, (new_capacity - index->doc_capacity) * sizeof(textdoc));
+    EPOCH_PUBLISH(index->docs, docs);
+    EPOCH_PUBLISH(index->doc_capacity, new_capacity);  // readers load the capacity first
+    return 1;
+}
+
+
+/*
+textIndexTask() - Indexes (or re-indexes) the name, description and tags of a task
+ - Any earlier postings of the task become stale
+ - Time: O(k) for k trigrams in the task's text, Space: O(k)
+ - Returns 1 on success, 0 if memory allocation failed; the task is then not
+   indexed and every later query falls back to a scan
+ - Example: textIndexTask(t) after its name or tags change
+ */
+int textIndexTask(task* t) {
+    textindex* index = &currentStore->text;
+    if (!reserveDocs(t->id)) {
+        __atomic_store_n(&index->incomplete, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    textdoc* doc = &index->docs[t->id];
+    retireDoc(doc);
+
+    // Trigrams of each field separately, so none spans two fields
+    int count = collectGrams(taskName(t), 0);
+    if (count >= 0) count = collectGrams(taskDescription(t), count);
+    for (int i = 0; i < taskTagCount(t) && count >= 0; i++) {
+        count = collectGrams(taskTagName(t, i), count);
+    }
+    if (count < 0) {
+        __atomic_store_n(&index->incomplete, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    unsigned int gen = ++index->next_gen;
+    int posted = 0, i;
+    for (i = 0; i < count; i++) {
+        textgram* g = internGram(index->gram_buffer[i]);
+        if (!g) {
+            break;
+        }
+        if (g->last_gen == gen) {
+            continue;   // trigram repeated within this task
+        }
+        if (g->count == g->capacity) {
+            int new_capacity = g->capacity ? g->capacity * 2 : TEXT_POSTING_INITIAL_CAPACITY;
+            textposting* items = (textposting*)epochResize(g->items, g->count * sizeof(textposting),
+                                                           new_capacity * sizeof(textposting));
+            if (!items) {
+                break;
+            }
+            EPOCH_PUBLISH(g->items, items);
+            g->capacity = new_capacity;
+        }
+        g->items[g->count].id = t->id;
+        g->items[g->count].gen = gen;
+        EPOCH_PUBLISH(g->count, g->count + 1);  // the posting is in place first
+        g->last_gen = gen;
+        posted++;
+    }
+
+    __atomic_store_n(&doc->gen, gen, __ATOMIC_RELAXED);
+    EPOCH_PUBLISH(doc->task_data, t);
+    doc->postings = posted;
+    index->live += posted;
+    if (i < count) {
+        // Incomplete postings would hide matches, so leave the task unindexed
+        retireDoc(doc);
+        __atomic_store_n(&index->incomplete, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    return 1;
+}
+
+
+/*
+textIndexDefer() - Records a task for indexing by textIndexFlush()
+ - Bulk loads (a snapshot restore) use this so the trigram postings are
+   only built once something is searched, or the server's owner gets to
+   them; the task counts as indexed for textIndexHas(), and editing or
+   dropping it before then simply indexes or forgets it as usual
+ - Queries scan instead of using the index while tasks are deferred
+ - Time: O(1) amortized, Space: O(1) amortized
+ - Returns 1 on success, 0 if memory allocation failed (queries then scan)
+ */
+int textIndexDefer(task* t) {
+    textindex* index = &currentStore->text;
+    if (!reserveDocs(t->id)) {
+        __atomic_store_n(&index->incomplete, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    textdoc* doc = &index->docs[t->id];
+    retireDoc(doc);
+    doc->gen = TEXT_GEN_DEFERRED;
+    doc->task_data = t;
+    __atomic_add_fetch(&index->deferred, 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+
+/*
+textIndexFlush() - Indexes every deferred task, in cold id order (the store's writer only)
+ - The first query does this itself when no reader thread is registered;
+   the server's owners run it between batches, so queries on reader
+   threads never have to change the index
+ - Time: O(ids + their trigrams) with deferred tasks, else O(1); Space: O(their trigrams)
+ */
+void textIndexFlush(void) {
+    textindex* index = &currentStore->text;
+    for (unsigned int id = 0; id < index->doc_capacity && index->deferred > 0; id++) {
+        textdoc* doc = &index->docs[id];
+        if (doc->task_data && doc->gen == TEXT_GEN_DEFERRED) {
+            textIndexTask(doc->task_data);
+        }
+    }
+}
+
+
+/*
+textIndexDrop() - Removes a task from the index (its postings become stale)
+ - Time: O(1) amortized, Space: O(1)
+ */
+void textIndexDrop(task* t) {
+    textindex* index = &currentStore->text;
+    if (t->id < index->doc_capacity && index->docs[t->id].task_data == t) {
+        retireDoc(&index->docs[t->id]);
+    }
+}
+
+
+/*
+textIndexHas() - Whether a task is currently indexed (the store's writer only)
+ - Time: O(1), Space: O(1)
+ */
+int textIndexHas(const task* t) {
+    textindex* index = &currentStore->text;
+    return t->id < index->doc_capacity && index->docs[t->id].task_data == t;
+}
+
+
+/*
+textIndexQuery() - Candidate tasks that may contain a substring
+ - Walks only the shortest posting list among the query's trigrams;
+   every task containing the query is in it, but candidates must still
+   be checked with an exact match
+ - Changes nothing but counters while reader threads are registered, so
+   readers run it inside a read section; a candidate may then appear twice
+   if its task was re-indexed meanwhile
+ - Results are in indexing order; *out must be freed by the caller
+ - Time: O(q + shortest list) for a query of length q, Space: O(candidates)
+ - Returns the number of candidates, or -1 if the query is shorter than
+   TEXT_GRAM_LENGTH, tasks are deferred or the index is incomplete (the
+   caller has to scan)
+ - Sample Case:
+    Input: "port", indexed names "Passport Renewal", "Report", "Sport day"
+    Output: 3 candidates ("por" and "ort" both have all three)
+ */
+int textIndexQuery(const char* query, task*** out) {
+    textindex* index = &currentStore->text;
+    size_t length = strlen(query);
+    *out = NULL;
+    __atomic_add_fetch(&index->queries, 1, __ATOMIC_RELAXED);
+    if (length >= TEXT_GRAM_LENGTH && !epochShared()) {
+        textIndexFlush();
+    }
+    if (length < TEXT_GRAM_LENGTH || __atomic_load_n(&index->incomplete, __ATOMIC_RELAXED) ||
+        __atomic_load_n(&index->deferred, __ATOMIC_RELAXED) > 0) {
+        __atomic_add_fetch(&index->short_queries, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    textgramtable* grams = EPOCH_LOAD(index->grams);
+    textgram* shortest = NULL;
+    int shortest_count = 0;
+    for (size_t i = 0; i + TEXT_GRAM_LENGTH <= length; i++) {
+        textgram* g = findGram(grams, gramKey(query + i));
+        int count = g ? EPOCH_LOAD(g->count) : 0;
+        if (count == 0) {
+            return 0;   // a trigram no task has: nothing can match
+        }
+        if (!shortest || count < shortest_count) {
+            shortest = g;
+            shortest_count = count;
+        }
+    }
+
+    // The count is published after its postings, so load it before them
+    textposting* items = EPOCH_LOAD(shortest->items);
+    unsigned int doc_capacity = EPOCH_LOAD(index->doc_capacity);
+    textdoc* docs = EPOCH_LOAD(index->docs);
+    task** found = (task**)malloc(shortest_count * sizeof(task*));
+    if (!found) {
+        return -1;
+    }
+    int matches = 0;
+    for (int i = 0; i < shortest_count; i++) {
+        task* t = postingTask(docs, doc_capacity, items[i]);
+        if (t) {
+            found[matches++] = t;
+        }
+    }
+    __atomic_add_fetch(&index->candidates, matches, __ATOMIC_RELAXED);
+    *out = found;
+    return matches;
+}
+
+
+/*
+textIndexReset() - Frees every posting list and forgets every task
+ - Time: O(trigrams), Space: O(1)
+ */
+void textIndexReset(void) {
+    textindex* index = &currentStore->text;
+    for (int i = 0; index->grams && i < index->grams->capacity; i++) {
+        free(index->grams->slots[i].items);
+    }
+    free(index->grams);
+    free(index->docs);
+    free(index->gram_buffer);
+    memset(index, 0, sizeof(*index));
+}
+
+
+/*
+printTextIndexStats() - Prints trigram table size and query counters
+ - Time: O(1), Space: O(1)
+ - Sample Case:
+    Output:
+      --- Text Index ---
+      Trigrams: 812 (table 2048 slots) | Postings: 1450 live, 96 stale | Compactions: 0
+      Queries: 3 (short, scanned: 1) | Candidates checked: 7
+ */
+void printTextIndexStats(void) {
+    textindex* index = &currentStore->text;
+    printf("--- Text Index ---\n");
+    printf("Trigrams: %d (table %d slots) | Postings: %ld live, %ld stale | Compactions: %ld\n",
+           index->gram_count, index->grams ? index->grams->capacity : 0, index->live, index->stale,
+           index->compactions);
+    printf("Queries: %ld (short, scanned: %ld) | Candidates checked: %ld\n",
+           index->queries, index->short_queries, index->candidates);
+    if (index->deferred > 0) {
+        printf("Deferred until the next query: %ld tasks\n", index->deferred);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef TEXTINDEX_H
+#define TEXTINDEX_H
+
+#include "scheduler.h"
+
+// Shortest query the index can answer; shorter ones need a scan
+#define TEXT_GRAM_LENGTH 3
+
+// One posting: a task (by cold id) and the indexing pass that wrote it
+typedef struct {
+    unsigned int id;
+    unsigned int gen;
+} textposting;
+
+// Posting list of one trigram (key 0 marks an empty slot)
+typedef struct {
+    unsigned int key;
+    int count;
+    int capacity;
+    unsigned int last_gen;      // gen of the newest posting (skips repeats within a task)
+    textposting* items;
+} textgram;
+
+// gen of a task that is known but not indexed yet (see textIndexDefer())
+#define TEXT_GEN_DEFERRED 0
+
+// Indexing state of one cold id
+typedef struct {
+    task* task_data;            // NULL when the id is not indexed
+    unsigned int gen;           // pass whose postings are current
+    int postings;               // postings written by that pass
+} textdoc;
+
+// Open-addressed table of trigrams; replaced whole when it grows
+typedef struct {
+    int capacity;               // always a power of two
+    textgram slots[];
+} textgramtable;
+
+// Trigram index over the name, description and tag names of every
+// pending and completed task. Postings are never removed one by one:
+// re-indexing or dropping a task makes its old postings stale (their gen
+// no longer matches), and the lists are compacted once stale postings
+// outnumber live ones. Query results are candidates only and must be
+// checked with an exact match.
+//
+// Only the store's writer changes the index, but reader threads may
+// query it inside a read section: the table, the posting lists and the
+// doc table are replaced rather than changed in place while readers are
+// registered, and the old copies are retired (see epochRetire()).
+typedef struct {
+    textgramtable* grams;
+    int gram_count;
+    textdoc* docs;              // indexed by cold id
+    unsigned int doc_capacity;
+    unsigned int next_gen;
+    long live;
+    long stale;
+    long deferred;              // tasks waiting for textIndexFlush() (queries scan until then)
+    int incomplete;             // a task failed to index: queries fall back to a scan
+    unsigned int* gram_buffer;  // trigram keys of the task being indexed (writer only)
+    int gram_buffer_capacity;
+
+    // counters for the debug report
+    long queries;
+    long short_queries;
+    long candidates;
+    long compactions;
+} textindex;
+
+int textIndexTask(task* t);
+int textIndexDefer(task* t);
+void textIndexFlush(void);
+void textIndexDrop(task* t);
+int textIndexHas(const task* t);
+int textIndexQuery(const char* query, task*** out);
+void textIndexReset(void);
+void printTextIndexStats(void);
+
+#endif
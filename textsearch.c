@@ -0,0 +1,315 @@
+#include <string.h>
+#include "textsearch.h"
+
+#ifdef TEXTSEARCH_X86
+#include <immintrin.h>
+#endif
+
+static substringfn exactKernel = NULL;
+static substringfn foldKernel = NULL;
+static const char* kernelName = "scalar";
+
+
+static int isAsciiLetter(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+
+// Lower-cases ASCII letters, leaves every other byte alone
+static unsigned char foldByte(unsigned char c) {
+    return isAsciiLetter(c) ? (unsigned char)(c | 0x20) : c;
+}
+
+
+static int equalNoCase(const char* a, const char* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (foldByte((unsigned char)a[i]) != foldByte((unsigned char)b[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*
+findSubstringScalar() - Portable kernel: memchr for the first byte, then the last byte, then memcmp
+ - Time: O(text_len · needle_len) worst case, Space: O(1)
+ - Example: findSubstringScalar("Write report", 12, "port", 4) -> "port"
+ */
+const char* findSubstringScalar(const char* text, size_t text_len, const char* needle, size_t needle_len) {
+    if (needle_len == 0) {
+        return text;
+    }
+    if (needle_len > text_len) {
+        return NULL;
+    }
+    const char* end = text + (text_len - needle_len) + 1;   // one past the last start
+    const char* p = text;
+    while (p < end) {
+        p = (const char*)memchr(p, needle[0], end - p);
+        if (!p) {
+            return NULL;
+        }
+        if (p[needle_len - 1] == needle[needle_len - 1] &&
+            memcmp(p + 1, needle + 1, needle_len > 1 ? needle_len - 2 : 0) == 0) {
+            return p;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+
+/*
+findSubstringNoCaseScalar() - Portable ASCII case-insensitive kernel
+ - Time: O(text_len · needle_len) worst case, Space: O(1)
+ - Example: findSubstringNoCaseScalar("Write Report", 12, "report", 6) -> "Report"
+ */
+const char* findSubstringNoCaseScalar(const char* text, size_t text_len, const char* needle, size_t needle_len) {
+    if (needle_len == 0) {
+        return text;
+    }
+    if (needle_len > text_len) {
+        return NULL;
+    }
+    unsigned char first = foldByte((unsigned char)needle[0]);
+    for (size_t i = 0; i + needle_len <= text_len; i++) {
+        if (foldByte((unsigned char)text[i]) == first && equalNoCase(text + i + 1, needle + 1, needle_len - 1)) {
+            return text + i;
+        }
+    }
+    return NULL;
+}
+
+
+#ifdef TEXTSEARCH_X86
+
+/*
+findSubstringSSE2() - First/last byte filter over 16 start positions per step
+ - The last block is moved back to end exactly at the last start position
+   (its already-checked positions are masked off), so loads stay inside
+   the text and no scalar tail is needed unless there are < 16 positions
+ - Time: O(text_len / 16 + candidates · needle_len), Space: O(1)
+ */
+const char* findSubstringSSE2(const char* text, size_t text_len, const char* needle, size_t needle_len) {
+    if (needle_len < 2 || needle_len > text_len || text_len - needle_len + 1 < 16) {
+        return findSubstringScalar(text, text_len, needle, needle_len);
+    }
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    size_t starts = text_len - needle_len + 1;
+    for (size_t i = 0; i < starts; i += 16) {
+        unsigned int skip = 0;
+        if (i + 16 > starts) {
+            skip = (unsigned int)(i - (starts - 16));
+            i = starts - 16;
+        }
+        __m128i block_first = _mm_loadu_si128((const __m128i*)(text + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i*)(text + i + needle_len - 1));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last)));
+        mask &= ~0u << skip;
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            if (memcmp(text + i + bit + 1, needle + 1, needle_len - 2) == 0) {
+                return text + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return NULL;
+}
+
+
+/*
+findSubstringAVX2() - First/last byte filter over 32 start positions per step
+ - Same overlapping last block as findSubstringSSE2(); upper register halves
+   are cleared before returning so later SSE code pays no transition penalty
+ - Only called when cpuHasAVX2() is true
+ - Time: O(text_len / 32 + candidates · needle_len), Space: O(1)
+ */
+__attribute__((target("avx2")))
+const char* findSubstringAVX2(const char* text, size_t text_len, const char* needle, size_t needle_len) {
+    if (needle_len < 2 || needle_len > text_len || text_len - needle_len + 1 < 32) {
+        return findSubstringSSE2(text, text_len, needle, needle_len);
+    }
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+    size_t starts = text_len - needle_len + 1;
+    const char* found = NULL;
+    for (size_t i = 0; i < starts && !found; i += 32) {
+        unsigned int skip = 0;
+        if (i + 32 > starts) {
+            skip = (unsigned int)(i - (starts - 32));
+            i = starts - 32;
+        }
+        __m256i block_first = _mm256_loadu_si256((const __m256i*)(text + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i*)(text + i + needle_len - 1));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last)));
+        mask &= ~0u << skip;
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            if (memcmp(text + i + bit + 1, needle + 1, needle_len - 2) == 0) {
+                found = text + i + bit;
+                break;
+            }
+            mask &= mask - 1;
+        }
+    }
+    _mm256_zeroupper();
+    return found;
+}
+
+
+/*
+findSubstringNoCaseSSE2() - Case-insensitive first/last byte filter, 16 positions per step
+ - Letters are compared with bit 0x20 forced on, so 'R' and 'r' both pass;
+   the filter may let a few non-matches through, never drops a match
+ - Time: O(text_len / 16 + candidates · needle_len), Space: O(1)
+ */
+const char* findSubstringNoCaseSSE2(const char* text, size_t text_len, const char* needle, size_t needle_len) {
+    if (needle_len < 2 || needle_len > text_len || text_len - needle_len + 1 < 16) {
+        return findSubstringNoCaseScalar(text, text_len, needle, needle_len);
+    }
+    unsigned char f = (unsigned char)needle[0], l = (unsigned char)needle[needle_len - 1];
+    const __m128i first = _mm_set1_epi8((char)foldByte(f));
+    const __m128i last = _mm_set1_epi8((char)foldByte(l));
+    const __m128i first_case = _mm_set1_epi8(isAsciiLetter(f) ? 0x20 : 0);
+    const __m128i last_case = _mm_set1_epi8(isAsciiLetter(l) ? 0x20 : 0);
+    size_t starts = text_len - needle_len + 1;
+    for (size_t i = 0; i < starts; i += 16) {
+        unsigned int skip = 0;
+        if (i + 16 > starts) {
+            skip = (unsigned int)(i - (starts - 16));
+            i = starts - 16;
+        }
+        __m128i block_first = _mm_or_si128(_mm_loadu_si128((const __m128i*)(text + i)), first_case);
+        __m128i block_last = _mm_or_si128(_mm_loadu_si128((const __m128i*)(text + i + needle_len - 1)), last_case);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last)));
+        mask &= ~0u << skip;
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            if (equalNoCase(text + i + bit + 1, needle + 1, needle_len - 2)) {
+                return text + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return NULL;
+}
+
+
+/*
+findSubstringNoCaseAVX2() - Case-insensitive first/last byte filter, 32 positions per step
+ - Time: O(text_len / 32 + candidates · needle_len), Space: O(1)
+ */
+__attribute__((target("avx2")))
+const char* findSubstringNoCaseAVX2(const char* text, size_t text_len, const char* needle, size_t needle_len) {
+    if (needle_len < 2 || needle_len > text_len || text_len - needle_len + 1 < 32) {
+        return findSubstringNoCaseSSE2(text, text_len, needle, needle_len);
+    }
+    unsigned char f = (unsigned char)needle[0], l = (unsigned char)needle[needle_len - 1];
+    const __m256i first = _mm256_set1_epi8((char)foldByte(f));
+    const __m256i last = _mm256_set1_epi8((char)foldByte(l));
+    const __m256i first_case = _mm256_set1_epi8(isAsciiLetter(f) ? 0x20 : 0);
+    const __m256i last_case = _mm256_set1_epi8(isAsciiLetter(l) ? 0x20 : 0);
+    size_t starts = text_len - needle_len + 1;
+    const char* found = NULL;
+    for (size_t i = 0; i < starts && !found; i += 32) {
+        unsigned int skip = 0;
+        if (i + 32 > starts) {
+            skip = (unsigned int)(i - (starts - 32));
+            i = starts - 32;
+        }
+        __m256i block_first = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(text + i)), first_case);
+        __m256i block_last = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(text + i + needle_len - 1)), last_case);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last)));
+        mask &= ~0u << skip;
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            if (equalNoCase(text + i + bit + 1, needle + 1, needle_len - 2)) {
+                found = text + i + bit;
+                break;
+            }
+            mask &= mask - 1;
+        }
+    }
+    _mm256_zeroupper();
+    return found;
+}
+
+
+/*
+cpuHasAVX2() - Whether the running CPU supports AVX2
+ - Time: O(1), Space: O(1)
+ */
+int cpuHasAVX2(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+
+/*
+chooseKernels() - Picks the widest kernels the CPU supports (first call only)
+ - Time: O(1), Space: O(1)
+ */
+static void chooseKernels(void) {
+#ifdef TEXTSEARCH_X86
+    if (cpuHasAVX2()) {
+        exactKernel = findSubstringAVX2;
+        foldKernel = findSubstringNoCaseAVX2;
+        kernelName = "AVX2";
+    } else {
+        exactKernel = findSubstringSSE2;
+        foldKernel = findSubstringNoCaseSSE2;
+        kernelName = "SSE2";
+    }
+#else
+    exactKernel = findSubstringScalar;
+    foldKernel = findSubstringNoCaseScalar;
+#endif
+}
+
+
+/*
+findSubstring() - strstr() for text of known length, using the best kernel
+ - Returns the first match, or NULL
+ - Time: O(text_len / width + candidates · needle_len), Space: O(1)
+ - Example: findSubstring(name, name_len, "rep", 3) -> pointer into name or NULL
+ */
+const char* findSubstring(const char* text, size_t text_len, const char* needle, size_t needle_len) {
+    if (!exactKernel) {
+        chooseKernels();
+    }
+    return exactKernel(text, text_len, needle, needle_len);
+}
+
+
+/*
+findSubstringNoCase() - ASCII case-insensitive findSubstring()
+ - Time: O(text_len / width + candidates · needle_len), Space: O(1)
+ - Example: findSubstringNoCase("Write Report", 12, "REPORT", 6) -> "Report"
+ */
+const char* findSubstringNoCase(const char* text, size_t text_len, const char* needle, size_t needle_len) {
+    if (!foldKernel) {
+        chooseKernels();
+    }
+    return foldKernel(text, text_len, needle, needle_len);
+}
+
+
+/*
+substringKernelName() - Name of the kernel findSubstring() uses ("AVX2", "SSE2" or "scalar")
+ - Time: O(1), Space: O(1)
+ */
+const char* substringKernelName(void) {
+    if (!exactKernel) {
+        chooseKernels();
+    }
+    return kernelName;
+}
@@ -0,0 +1,31 @@
+#ifndef TEXTSEARCH_H
+#define TEXTSEARCH_H
+
+#include <stddef.h>
+
+// Substring search over text whose length is already known (task text in
+// the string arena). Possible match positions are found 16 or 32 bytes at
+// a time by comparing the needle's first and last byte, and only those are
+// checked in full. The kernel is picked once at run time from the CPU.
+
+typedef const char* (*substringfn)(const char* text, size_t text_len,
+                                   const char* needle, size_t needle_len);
+
+const char* findSubstring(const char* text, size_t text_len, const char* needle, size_t needle_len);
+const char* findSubstringNoCase(const char* text, size_t text_len, const char* needle, size_t needle_len);
+const char* substringKernelName(void);
+
+// Individual kernels, for the benchmark
+const char* findSubstringScalar(const char* text, size_t text_len, const char* needle, size_t needle_len);
+const char* findSubstringNoCaseScalar(const char* text, size_t text_len, const char* needle, size_t needle_len);
+
+#if defined(__x86_64__)
+#define TEXTSEARCH_X86 1
+const char* findSubstringSSE2(const char* text, size_t text_len, const char* needle, size_t needle_len);
+const char* findSubstringAVX2(const char* text, size_t text_len, const char* needle, size_t needle_len);
+const char* findSubstringNoCaseSSE2(const char* text, size_t text_len, const char* needle, size_t needle_len);
+const char* findSubstringNoCaseAVX2(const char* text, size_t text_len, const char* needle, size_t needle_len);
+int cpuHasAVX2(void);
+#endif
+
+#endif
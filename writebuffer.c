@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "writebuffer.h"
+
+
+/*
+writeAll() - Writes a whole range to a file descriptor, retrying short writes
+ - Time: O(length), Space: O(1)
+ - Returns 1 on success, 0 if write() failed
+ */
+static int writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        data += n;
+        length -= n;
+    }
+    return 1;
+}
+
+
+/*
+writeBufferOpen() - Creates (or truncates) a file and allocates its buffer
+ - Time: O(1), Space: O(WRITEBUFFER_CAPACITY)
+ - Returns 1 on success, 0 if the file could not be opened or the buffer
+   allocated (errno is left set for perror())
+ - Example: writeBufferOpen(&out, "tasks_export.txt")
+ */
+int writeBufferOpen(writebuffer* wb, const char* filename) {
+    memset(wb, 0, sizeof(*wb));
+    wb->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (wb->fd < 0) {
+        return 0;
+    }
+    wb->data = (char*)malloc(WRITEBUFFER_CAPACITY);
+    if (!wb->data) {
+        close(wb->fd);
+        errno = ENOMEM;
+        return 0;
+    }
+    wb->capacity = WRITEBUFFER_CAPACITY;
+    return 1;
+}
+
+
+/*
+writeBufferFlush() - Writes out everything buffered so far
+ - Time: O(buffered bytes), Space: O(1)
+ */
+void writeBufferFlush(writebuffer* wb) {
+    if (wb->used > 0 && !wb->failed) {
+        if (writeAll(wb->fd, wb->data, wb->used)) {
+            wb->written += wb->used;
+        } else {
+            wb->failed = 1;
+        }
+    }
+    wb->used = 0;
+}
+
+
+/*
+writeBufferSync() - Flushes and waits until the data is on disk (fsync)
+ - Time: O(buffered bytes) plus the disk flush, Space: O(1)
+ - Returns 1 if everything written so far is durable, 0 otherwise (errno set)
+ */
+int writeBufferSync(writebuffer* wb) {
+    writeBufferFlush(wb);
+    if (wb->failed) {
+        return 0;
+    }
+    if (fsync(wb->fd) != 0) {
+        wb->failed = 1;
+        return 0;
+    }
+    return 1;
+}
+
+
+/*
+writeBufferClose() - Flushes, closes the file and frees the buffer
+ - Time: O(buffered bytes), Space: O(1)
+ - Returns 1 if every byte reached the file, 0 otherwise (errno set)
+ */
+int writeBufferClose(writebuffer* wb) {
+    writeBufferFlush(wb);
+    int saved_errno = errno;
+    int ok = !wb->failed;
+    if (close(wb->fd) != 0 && ok) {
+        ok = 0;
+        saved_errno = errno;
+    }
+    free(wb->data);
+    wb->data = NULL;
+    errno = saved_errno;
+    return ok;
+}
+
+
+/*
+writeBufferText() - Appends length bytes of text
+ - Text larger than the buffer is written directly after a flush
+ - Time: O(length) amortized, Space: O(1)
+ */
+void writeBufferText(writebuffer* wb, const char* text, size_t length) {
+    if (wb->used + length > wb->capacity) {
+        writeBufferFlush(wb);
+        if (length > wb->capacity) {
+            if (!wb->failed) {
+                if (writeAll(wb->fd, text, length)) {
+                    wb->written += length;
+                } else {
+                    wb->failed = 1;
+                }
+            }
+            return;
+        }
+    }
+    memcpy(wb->data + wb->used, text, length);
+    wb->used += length;
+}
+
+
+void writeBufferString(writebuffer* wb, const char* text) {
+    writeBufferText(wb, text, strlen(text));
+}
+
+
+void writeBufferChar(writebuffer* wb, char c) {
+    if (wb->used == wb->capacity) {
+        writeBufferFlush(wb);
+    }
+    wb->data[wb->used++] = c;
+}
+
+
+/*
+writeBufferSpaces() - Appends count spaces (nothing if count <= 0)
+ - Time: O(count), Space: O(1)
+ */
+void writeBufferSpaces(writebuffer* wb, int count) {
+    static const char spaces[] = "                                ";
+    while (count > 0) {
+        int n = count < (int)sizeof(spaces) - 1 ? count : (int)sizeof(spaces) - 1;
+        writeBufferText(wb, spaces, n);
+        count -= n;
+    }
+}
+
+
+/*
+writeBufferPadded() - Appends text left-aligned in a field of width characters (printf "%-*s")
+ - Longer text is written in full, like printf
+ - Time: O(max(length, width)), Space: O(1)
+ */
+void writeBufferPadded(writebuffer* wb, const char* text, size_t length, int width) {
+    writeBufferText(wb, text, length);
+    if ((size_t)width > length) {
+        writeBufferSpaces(wb, width - (int)length);
+    }
+}
+
+
+/*
+formatDigits() - Writes the decimal digits of value right-aligned ending at end
+ - Time: O(digits), Space: O(1)
+ - Returns a pointer to the first character (a '-' for negative values)
+ */
+static char* formatDigits(char* end, long value) {
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+    char* p = end;
+    do {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) {
+        *--p = '-';
+    }
+    return p;
+}
+
+
+/*
+writeBufferInt() - Appends a decimal integer (printf "%ld")
+ - Time: O(digits), Space: O(1)
+ - Returns the number of characters written
+ */
+int writeBufferInt(writebuffer* wb, long value) {
+    char digits[24];
+    char* start = formatDigits(digits + sizeof(digits), value);
+    int length = (int)(digits + sizeof(digits) - start);
+    writeBufferText(wb, start, length);
+    return length;
+}
+
+
+/*
+writeBufferIntPadded() - Appends an integer left-aligned in width characters (printf "%-*ld")
+ - Time: O(max(digits, width)), Space: O(1)
+ */
+void writeBufferIntPadded(writebuffer* wb, long value, int width) {
+    writeBufferSpaces(wb, width - writeBufferInt(wb, value));
+}
+
+
+/*
+writeBufferZeroPadded() - Appends a non-negative integer with at least digits digits (printf "%0*ld")
+ - Time: O(digits), Space: O(1)
+ - Returns the number of characters written
+ - Example: writeBufferZeroPadded(wb, 5, 2) -> "05"
+ */
+int writeBufferZeroPadded(writebuffer* wb, long value, int digits) {
+    char buffer[24];
+    char* start = formatDigits(buffer + sizeof(buffer), value);
+    int length = (int)(buffer + sizeof(buffer) - start);
+    int zeros = value >= 0 && digits > length ? digits - length : 0;
+    for (int i = 0; i < zeros; i++) {
+        writeBufferChar(wb, '0');
+    }
+    writeBufferText(wb, start, length);
+    return zeros + length;
+}
+
+
+/*
+writeBufferDate() - Appends a date as dd/mm/yyyy
+ - Time: O(1), Space: O(1)
+ - Returns the number of characters written (10 for four-digit years)
+ - Example: {5, 3, 2026} -> "05/03/2026"
+ */
+int writeBufferDate(writebuffer* wb, date d) {
+    int length = writeBufferZeroPadded(wb, d.day, 2);
+    writeBufferChar(wb, '/');
+    length += writeBufferZeroPadded(wb, d.month, 2);
+    writeBufferChar(wb, '/');
+    length += writeBufferZeroPadded(wb, d.year, 4);
+    return length + 2;
+}
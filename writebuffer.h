@@ -0,0 +1,37 @@
+#ifndef WRITEBUFFER_H
+#define WRITEBUFFER_H
+
+#include <stddef.h>
+#include "scheduler.h"
+
+// Bytes collected before each write() to the file
+#define WRITEBUFFER_CAPACITY (1 << 20)
+
+// Output file behind one large buffer. Text and numbers are formatted
+// straight into the buffer and reach the file in WRITEBUFFER_CAPACITY
+// sized write() calls. After a failed write() further output is dropped
+// and writeBufferClose() reports the failure.
+typedef struct {
+    int fd;
+    char* data;
+    size_t used;
+    size_t capacity;
+    int failed;
+    long long written;          // bytes handed to write() so far
+} writebuffer;
+
+int writeBufferOpen(writebuffer* wb, const char* filename);
+int writeBufferClose(writebuffer* wb);
+void writeBufferFlush(writebuffer* wb);
+int writeBufferSync(writebuffer* wb);
+void writeBufferText(writebuffer* wb, const char* text, size_t length);
+void writeBufferString(writebuffer* wb, const char* text);
+void writeBufferChar(writebuffer* wb, char c);
+void writeBufferSpaces(writebuffer* wb, int count);
+void writeBufferPadded(writebuffer* wb, const char* text, size_t length, int width);
+int writeBufferInt(writebuffer* wb, long value);
+void writeBufferIntPadded(writebuffer* wb, long value, int width);
+int writeBufferZeroPadded(writebuffer* wb, long value, int digits);
+int writeBufferDate(writebuffer* wb, date d);
+
+#endif